@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_AV1_RTP_DEPACKETIZER_H
+#define RTC_AV1_RTP_DEPACKETIZER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "mediahandler.hpp"
+#include "message.hpp"
+#include "rtp.hpp"
+#include "rtpjitterbuffer.hpp"
+
+#include <chrono>
+
+namespace rtc {
+
+/// RTP depacketization for AV1
+/// Temporal units are output in low overhead bitstream format, starting with a temporal delimiter
+/// The first temporal unit of a coded video sequence has FrameInfo::sequenceStart set
+/// See https://aomediacodec.github.io/av1-rtp-spec/
+class RTC_CPP_EXPORT AV1RtpDepacketizer : public MediaHandler {
+public:
+	inline static const uint32_t ClockRate = 90 * 1000;
+
+	/// @param latency maximum time to wait for missing packets of a temporal unit
+	AV1RtpDepacketizer(std::chrono::milliseconds latency = RtpJitterBuffer::DefaultLatency);
+	virtual ~AV1RtpDepacketizer() = default;
+
+	void incoming(message_vector &messages, const message_callback &send) override;
+
+private:
+	message_ptr buildFrame(const message_vector &packets);
+	void popFrames(message_vector &frames);
+
+	RtpJitterBuffer mJitterBuffer;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_AV1_RTP_DEPACKETIZER_H */
@@ -39,15 +39,16 @@ public:
 	                 size_t maxFragmentSize = DefaultMaxFragmentSize);
 
 private:
-	static std::vector<binary> extractTemporalUnitObus(const binary &data);
+	static std::vector<PayloadView::Part> extractTemporalUnitObus(const binary &data);
 
-	std::vector<binary> fragment(binary data) override;
-	std::vector<binary> fragmentObu(const binary &data);
+	bool fragmentViews(const binary &data, std::vector<PayloadView> &views) override;
+	void fragmentObu(PayloadView::Part obu, std::vector<PayloadView> &views);
 
 	const Packetization mPacketization;
 	const size_t mMaxFragmentSize;
 
 	std::unique_ptr<binary> mSequenceHeader;
+	std::vector<std::unique_ptr<binary>> mSentSequenceHeaders; // referenced until packetized
 };
 
 // For backward compatibility, do not use
@@ -79,6 +79,9 @@ struct RTC_CPP_EXPORT Configuration {
 	bool disableAutoGathering = false;
 	bool forceMediaTransport = false;
 	bool disableFingerprintVerification = false;
+	bool enableDtls13 = false;           // Requires OpenSSL with DTLS 1.3, throws otherwise
+	bool enableDtlsConnectionId = false; // Requires Mbed TLS with RFC 9146, throws otherwise
+	bool enableSctpFastOpen = false;     // Send DataChannel data before SCTP is connected
 
 	// Port range
 	uint16_t portRangeBegin = 1024;
@@ -90,6 +93,14 @@ struct RTC_CPP_EXPORT Configuration {
 	// Local maximum message size for Data Channels
 	optional<size_t> maxMessageSize; // 数据通道的最大消息大小。
 
+	// SRTP settings for incoming streams
+	// Once the max is reached, packets from new SSRCs are dropped until a stream times out.
+	// A timed out stream loses its rollover counter and replay window, so if it resumes, its old
+	// packets could be replayed and it fails after a sequence number wrap-around.
+	optional<size_t> srtpReplayWindowSize;                 // in packets, from 64 to 32768
+	optional<size_t> srtpMaxInboundStreams;                // unbounded by default
+	optional<std::chrono::milliseconds> srtpStreamTimeout; // idle streams are kept by default
+
 	// Certificates and private keys 证书和私钥文件相关配置。
 	optional<string> certificatePemFile;
 	optional<string> keyPemFile;
@@ -104,12 +115,31 @@ struct WebSocketConfiguration {
 	std::vector<string> protocols;
 	optional<std::chrono::milliseconds> connectionTimeout; // zero to disable
 	optional<std::chrono::milliseconds> pingInterval;      // zero to disable
+	optional<std::chrono::milliseconds> hibernationTimeout; // release buffers when idle, if set
 	optional<int> maxOutstandingPings;
 	optional<string> caCertificatePemFile;
 	optional<string> certificatePemFile;
 	optional<string> keyPemFile;
 	optional<string> keyPemPass;
 	optional<size_t> maxMessageSize;
+	bool enableUtf8Validation = false; // if true, close on invalid UTF-8 in text messages
+	bool enableKernelTls = false;      // if true, offload TLS encryption (Linux and OpenSSL 3 only)
+
+	// Send backpressure: past the high watermark in bytes, the overflow policy applies
+	enum class OverflowPolicy {
+		Block,      // wait until under the low watermark (queue if called from a callback)
+		DropOldest, // queue the message and drop the oldest queued ones
+		DropNewest, // drop the message
+		Close       // close the connection
+	};
+	optional<size_t> sendHighWatermark; // unlimited if unset
+	optional<size_t> sendLowWatermark;  // buffered amount low threshold, half the high one if unset
+	OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+
+	// permessage-deflate compression (RFC 7692)
+	bool enableDeflate = false;
+	bool disableDeflateContextTakeover = false; // if true, compress each message independently
+	optional<size_t> deflateMemoryLimit;        // per connection, in bytes
 };
 
 struct WebSocketServerConfiguration {
@@ -121,6 +151,18 @@ struct WebSocketServerConfiguration {
 	optional<string> bindAddress;
 	optional<std::chrono::milliseconds> connectionTimeout;
 	optional<size_t> maxMessageSize;
+	bool enableUtf8Validation = false;
+	bool enableDeflate = false;
+	bool disableDeflateContextTakeover = false;
+	optional<size_t> deflateMemoryLimit;
+	bool enableKernelTls = false;
+	optional<size_t> sendHighWatermark;
+	optional<size_t> sendLowWatermark;
+	WebSocketConfiguration::OverflowPolicy overflowPolicy =
+	    WebSocketConfiguration::OverflowPolicy::Block;
+	optional<std::chrono::milliseconds> hibernationTimeout;
+	optional<int> listenBacklog;
+	unsigned int acceptThreads = 1; // on Linux, each thread has its own SO_REUSEPORT socket
 };
 
 #endif
@@ -121,7 +121,7 @@ public:
 			Direction direction = Direction::Unknown;
 		};
 
-		std::vector<int> extIds();
+		std::vector<int> extIds() const;
 		ExtMap *extMap(int id);
 		const ExtMap *extMap(int id) const;
 		void addExtMap(ExtMap map);
@@ -162,9 +162,11 @@ public:
 		void setSctpPort(uint16_t port);
 		void hintSctpPort(uint16_t port);
 		void setMaxMessageSize(size_t size);
+		void setSctpFastOpenStreams(uint16_t count);
 
 		optional<uint16_t> sctpPort() const;
 		optional<size_t> maxMessageSize() const;
+		optional<uint16_t> sctpFastOpenStreams() const;
 
 		virtual void parseSdpLine(string_view line) override;
 
@@ -173,6 +175,7 @@ public:
 
 		optional<uint16_t> mSctpPort;
 		optional<size_t> mMaxMessageSize;
+		optional<uint16_t> mSctpFastOpenStreams;
 	};
 
 	// Media (non-data)
@@ -193,6 +196,8 @@ public:
 		bool hasSSRC(uint32_t ssrc) const;
 		void clearSSRCs();
 		std::vector<uint32_t> getSSRCs() const;
+		void addRtxSSRC(uint32_t ssrc, uint32_t rtxSsrc); // adds an FID group
+		std::map<uint32_t, uint32_t> getRtxSSRCs() const; // RTX SSRC to media SSRC
 		optional<std::string> getCNameForSsrc(uint32_t ssrc) const;
 
 		int bitrate() const;
@@ -229,6 +234,7 @@ public:
 		void removeFormat(const string &format);
 
 		void addRtxCodec(int payloadType, int origPayloadType, unsigned int clockRate);
+		std::map<int, int> rtxPayloadTypes() const; // RTX payload type to original payload type
 
 		virtual void parseSdpLine(string_view line) override;
 
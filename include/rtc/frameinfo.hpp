@@ -30,6 +30,10 @@ struct RTC_CPP_EXPORT FrameInfo { //
 	uint8_t payloadType = 0; // RTP 负载类型（标识媒体格式，如 VP8/VP9/AV1 等）。
 	// timestampSeconds：高精度时间戳
 	optional<std::chrono::duration<double>> timestampSeconds;
+	// 帧是否开始一个新的编码视频序列（如 AV1 聚合头的 N 位），此时帧不依赖之前的帧
+	bool sequenceStart = false;
+	// 帧的采集时间（系统时钟），用于 abs-capture-time 头扩展，未设置时不写入该扩展
+	optional<std::chrono::system_clock::time_point> captureTime;
 };
 
 } // namespace rtc
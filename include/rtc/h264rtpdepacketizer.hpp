@@ -17,7 +17,9 @@
 #include "message.hpp"
 #include "nalunit.hpp"
 #include "rtp.hpp"
+#include "rtpjitterbuffer.hpp"
 
+#include <chrono>
 #include <iterator>
 
 namespace rtc {
@@ -29,18 +31,22 @@ public:
 
 	inline static const uint32_t ClockRate = 90 * 1000;
 
-	H264RtpDepacketizer(Separator separator = Separator::LongStartSequence);
+	/// @param separator NAL unit separator of output frames
+	/// @param latency maximum time to wait for missing packets of a frame
+	H264RtpDepacketizer(Separator separator = Separator::LongStartSequence,
+	                    std::chrono::milliseconds latency = RtpJitterBuffer::DefaultLatency);
 	virtual ~H264RtpDepacketizer() = default;
 
 	void incoming(message_vector &messages, const message_callback &send) override;
 
 private:
-	std::vector<message_ptr> mRtpBuffer;
 	const NalUnit::Separator mSeparator;
 
 	void addSeparator(binary &accessUnit);
 	message_vector buildFrames(message_vector::iterator firstPkt, message_vector::iterator lastPkt,
 	                           uint8_t payloadType, uint32_t timestamp);
+
+	RtpJitterBuffer mJitterBuffer;
 };
 
 } // namespace rtc
@@ -31,8 +31,9 @@ public:
 	/// @param separator NAL unit separator
 	/// @param rtpConfig RTP configuration
 	/// @param maxFragmentSize maximum size of one NALU fragment
+	/// @param aggregate aggregate consecutive small NAL units into STAP-A packets
 	H264RtpPacketizer(Separator separator, shared_ptr<RtpPacketizationConfig> rtpConfig,
-	                  size_t maxFragmentSize = DefaultMaxFragmentSize);
+	                  size_t maxFragmentSize = DefaultMaxFragmentSize, bool aggregate = false);
 
 	// For backward compatibility, do not use
 	[[deprecated]] H264RtpPacketizer(
@@ -40,11 +41,12 @@ public:
 	    size_t maxFragmentSize = DefaultMaxFragmentSize);
 
 private:
-	std::vector<binary> fragment(binary data) override;
-	std::vector<NalUnit> splitFrame(const binary &frame);
+	bool fragmentViews(const binary &data, std::vector<PayloadView> &views) override;
+	std::vector<PayloadView::Part> splitFrame(const binary &frame);
 
 	const Separator mSeparator;
 	const size_t mMaxFragmentSize;
+	const bool mAggregate;
 };
 
 // For backward compatibility, do not use
@@ -18,7 +18,9 @@
 #include "mediahandler.hpp"
 #include "message.hpp"
 #include "rtp.hpp"
+#include "rtpjitterbuffer.hpp"
 
+#include <chrono>
 #include <iterator>
 
 namespace rtc {
@@ -30,18 +32,22 @@ public:
 
 	inline static const uint32_t ClockRate = 90 * 1000;
 
-	H265RtpDepacketizer(Separator separator = Separator::LongStartSequence);
+	/// @param separator NAL unit separator of output frames
+	/// @param latency maximum time to wait for missing packets of a frame
+	H265RtpDepacketizer(Separator separator = Separator::LongStartSequence,
+	                    std::chrono::milliseconds latency = RtpJitterBuffer::DefaultLatency);
 	virtual ~H265RtpDepacketizer() = default;
 
 	void incoming(message_vector &messages, const message_callback &send) override;
 
 private:
-	std::vector<message_ptr> mRtpBuffer;
 	const NalUnit::Separator separator;
 
 	void addSeparator(binary& accessUnit);
 	message_vector buildFrames(message_vector::iterator firstPkt, message_vector::iterator lastPkt,
 	                           uint8_t payloadType, uint32_t timestamp);
+
+	RtpJitterBuffer mJitterBuffer;
 };
 
 } // namespace rtc
@@ -30,19 +30,21 @@ public:
 	// @param separator NAL unit separator
 	// @param rtpConfig  RTP configuration
 	// @param maxFragmentSize maximum size of one NALU fragment
+	// @param aggregate aggregate consecutive small NAL units into AP packets
 	H265RtpPacketizer(Separator separator, shared_ptr<RtpPacketizationConfig> rtpConfig,
-	                  size_t maxFragmentSize = DefaultMaxFragmentSize);
+	                  size_t maxFragmentSize = DefaultMaxFragmentSize, bool aggregate = false);
 
 	// For backward compatibility, do not use
 	[[deprecated]] H265RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig,
 	                  size_t maxFragmentSize = DefaultMaxFragmentSize);
 
 private:
-	std::vector<binary> fragment(binary data) override;
-	std::vector<H265NalUnit> splitFrame(const binary &frame);
+	bool fragmentViews(const binary &data, std::vector<PayloadView> &views) override;
+	std::vector<PayloadView::Part> splitFrame(const binary &frame);
 
 	const NalUnit::Separator mSeparator;
 	const size_t mMaxFragmentSize;
+	const bool mAggregate;
 };
 
 // For backward compatibility, do not use
@@ -37,6 +37,16 @@ public:
 
 	virtual bool requestKeyframe(const message_callback &send);
 	virtual bool requestBitrate(unsigned int bitrate, const message_callback &send);
+	virtual bool requestRetransmission(uint32_t ssrc, const std::vector<uint16_t> &seqNumbers,
+	                                   const message_callback &send);
+
+	/// Run the incoming chain again without new messages, so the handler can output messages it
+	/// holds, like frames awaited until a deadline
+	/// @note Does nothing unless the poll callback is set, like by the track on its handler chain
+	void pollIncoming();
+
+	/// Set the callback running the incoming chain, for this handler and the next ones
+	void setPollCallback(std::function<void()> callback);
 
 	void addToChain(shared_ptr<MediaHandler> handler);
 	void setNext(shared_ptr<MediaHandler> handler);
@@ -50,7 +60,10 @@ public:
 	void outgoingChain(message_vector &messages, const message_callback &send);
 
 private:
+	void propagatePollCallback(shared_ptr<std::function<void()>> callback);
+
 	shared_ptr<MediaHandler> mNext;
+	shared_ptr<std::function<void()>> mPollCallback;
 };
 
 } // namespace rtc
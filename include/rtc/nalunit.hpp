@@ -80,6 +80,11 @@ struct RTC_CPP_EXPORT NalUnit : binary {
 	static NalUnitStartSequenceMatch StartSequenceMatchSucc(NalUnitStartSequenceMatch match,
 	                                                 std::byte _byte, Separator separator);
 
+	// Vectorized equivalent of matching from the beginning of data with StartSequenceMatchSucc:
+	// return the offset of the first start sequence, or size if there is none, and set length
+	static size_t FindStartSequence(const std::byte *data, size_t size, Separator separator,
+	                                size_t &length);
+
 	enum class Type { H264, H265 };
 
 	NalUnit(const NalUnit &unit) = default;
@@ -30,17 +30,26 @@
 
 // Media
 #include "av1rtppacketizer.hpp"
+#include "av1rtpdepacketizer.hpp"
 #include "h264rtppacketizer.hpp"
 #include "h264rtpdepacketizer.hpp"
 #include "h265rtppacketizer.hpp"
 #include "h265rtpdepacketizer.hpp"
+#include "vp8rtppacketizer.hpp"
+#include "vp8rtpdepacketizer.hpp"
+#include "vp9rtppacketizer.hpp"
+#include "vp9rtpdepacketizer.hpp"
+#include "rtpjitterbuffer.hpp"
+#include "rtpextensionmap.hpp"
 #include "mediahandler.hpp"
 #include "plihandler.hpp"
 #include "rembhandler.hpp"
 #include "pacinghandler.hpp"
 #include "rtcpnackresponder.hpp"
+#include "rtcpnackrequester.hpp"
 #include "rtcpreceivingsession.hpp"
 #include "rtcpsrreporter.hpp"
+#include "rtxunwrapper.hpp"
 #include "rtppacketizer.hpp"
 #include "rtpdepacketizer.hpp"
 
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_RTCP_NACK_REQUESTER_H
+#define RTC_RTCP_NACK_REQUESTER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "mediahandler.hpp"
+#include "rtp.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace rtc {
+
+/// Detects missing incoming RTP packets and requests their retransmission with NACKs
+/// Missing packets are requested after a reorder delay, then again every round-trip time until
+/// they are received or the deadline expires. Requests are checked when messages are received.
+/// Incoming messages go through the chain from the end, so it must be chained after the
+/// depacketizer, and before the RTCP receiving session so it handles retransmission requests.
+class RTC_CPP_EXPORT RtcpNackRequester final : public MediaHandler {
+public:
+	using clock = std::chrono::steady_clock;
+
+	inline static const std::chrono::milliseconds DefaultRtt = std::chrono::milliseconds(100);
+	inline static const std::chrono::milliseconds DefaultReorderDelay =
+	    std::chrono::milliseconds(10);
+	inline static const std::chrono::milliseconds DefaultDeadline =
+	    std::chrono::milliseconds(1000);
+
+	/// @param deadline time after which a missing packet is not requested anymore
+	RtcpNackRequester(std::chrono::milliseconds deadline = DefaultDeadline);
+
+	void incoming(message_vector &messages, const message_callback &send) override;
+	void incoming(message_vector &messages, const message_callback &send, clock::time_point now);
+
+	/// Missing packets are already tracked, so requests from depacketizers are absorbed
+	bool requestRetransmission(SSRC ssrc, const std::vector<uint16_t> &seqNumbers,
+	                           const message_callback &send) override;
+
+	/// Set the round-trip time, which spaces the requests for a missing packet
+	void setRtt(std::chrono::milliseconds rtt);
+
+	/// Set the delay before the first request, so reordered packets are not requested
+	void setReorderDelay(std::chrono::milliseconds delay);
+
+	size_t requestedPackets() const; // missing packets requested at least once
+	size_t recoveredPackets() const; // requested packets received afterwards
+	size_t abandonedPackets() const; // missing packets given up after the deadline
+	size_t sentNacks() const;
+
+private:
+	static const size_t WindowSize = 1024; // tracked sequence numbers per stream
+
+	struct Stream {
+		uint16_t highestSeqNumber = 0;
+		std::array<uint64_t, WindowSize / 64> missing = {}; // bitmap by sequence number
+		std::array<clock::time_point, WindowSize> detected;
+		std::array<clock::time_point, WindowSize> requested;
+		size_t missingCount = 0;
+	};
+
+	void receive(Stream &stream, uint16_t seqNumber, clock::time_point now);
+	void setMissing(Stream &stream, uint16_t seqNumber, clock::time_point now);
+	bool isMissing(const Stream &stream, uint16_t seqNumber) const;
+	bool clearMissing(Stream &stream, uint16_t seqNumber); // returns true if requested before
+	std::vector<uint16_t> collect(Stream &stream, clock::time_point now);
+	message_vector makeNacks(SSRC ssrc, const std::vector<uint16_t> &seqNumbers) const;
+
+	const std::chrono::milliseconds mDeadline;
+
+	mutable std::mutex mMutex;
+	std::map<SSRC, Stream> mStreams;
+	std::chrono::milliseconds mRtt = DefaultRtt;
+	std::chrono::milliseconds mReorderDelay = DefaultReorderDelay;
+
+	size_t mRequestedPackets = 0;
+	size_t mRecoveredPackets = 0;
+	size_t mAbandonedPackets = 0;
+	size_t mSentNacks = 0;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_RTCP_NACK_REQUESTER_H */
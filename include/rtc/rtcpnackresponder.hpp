@@ -12,61 +12,108 @@
 #if RTC_ENABLE_MEDIA
 
 #include "mediahandler.hpp"
+#include "rtp.hpp"
 
-#include <queue>
-#include <unordered_map>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace rtc {
 
 class RTC_CPP_EXPORT RtcpNackResponder final : public MediaHandler {
 public:
 	static const size_t DefaultMaxSize = 512;
+	static const size_t DefaultMaxBytes = 1024 * 1024;
 
-	RtcpNackResponder(size_t maxSize = DefaultMaxSize);
+	/// @param maxSize maximum number of stored packets, up to 32768
+	/// @param maxBytes maximum total size of stored packets
+	RtcpNackResponder(size_t maxSize = DefaultMaxSize, size_t maxBytes = DefaultMaxBytes);
 
 	void incoming(message_vector &messages, const message_callback &send) override;
 	void outgoing(message_vector &messages, const message_callback &send) override;
 
-private:
-	// Packet storage
-	class RTC_CPP_EXPORT Storage {
+	/// Sends retransmissions with RTX (RFC 4588) instead of resending the original packets
+	/// @param rtxSsrc RTX SSRC
+	/// @param payloadTypes RTX payload type for each original payload type
+	void enableRtx(SSRC rtxSsrc, std::map<uint8_t, uint8_t> payloadTypes);
+	/// Same with the RTX payload types negotiated in the media description
+	void enableRtx(SSRC rtxSsrc, const Description::Media &media);
 
-		/// Packet storage element
-		struct RTC_CPP_EXPORT Element {
-			Element(message_ptr packet, uint16_t sequenceNumber, shared_ptr<Element> next = nullptr);
-			const message_ptr packet;
-			const uint16_t sequenceNumber;
-			/// Pointer to newer element
-			shared_ptr<Element> next = nullptr;
-		};
+	/// Limits retransmissions to a bitrate in bits per second, 0 for no limit
+	void setMaxBitrate(unsigned int bitrate);
 
-	private:
-		/// Oldest packet in storage
-		shared_ptr<Element> oldest = nullptr;
-		/// Newest packet in storage
-		shared_ptr<Element> newest = nullptr;
-		/// Inner storage
-		std::unordered_map<uint16_t, shared_ptr<Element>> storage{};
-		std::mutex mutex;
+	/// History depth, to be compared with the round-trip time of the link
+	size_t storedPackets() const;
+	size_t storedBytes() const;
+	std::chrono::milliseconds storedDuration() const; // between oldest and newest packets
 
-		/// Maximum storage size
-		const size_t maxSize;
+	size_t retransmittedPackets() const;
+	size_t droppedRetransmissions() const; // over the bitrate limit
 
-		/// Returns current size
-		size_t size();
+private:
+	using clock = std::chrono::steady_clock;
 
+	message_ptr makeRtx(const message_ptr &packet) const;
+	bool consumeBudget(size_t size, clock::time_point now);
+
+	// Packet storage, a ring indexed by sequence number
+	// Reads are lock-free so NACKs do not wait for outgoing packets to be stored
+	class RTC_CPP_EXPORT Storage {
 	public:
-		Storage(size_t _maxSize);
+		using clock = std::chrono::steady_clock;
+
+		Storage(size_t maxSize, size_t maxBytes);
 
 		/// Returns packet with given sequence number
-		message_ptr get(uint16_t sequenceNumber);
+		message_ptr get(uint16_t sequenceNumber) const;
 
 		/// Stores packet
 		/// @param packet Packet
-		void store(message_ptr packet);
+		/// @param now Time of storage
+		void store(message_ptr packet, clock::time_point now = clock::now());
+
+		size_t size() const;
+		size_t bytes() const;
+		clock::duration duration() const;
+
+	private:
+		struct Slot {
+			message_ptr packet; // accessed atomically
+			clock::time_point time;
+		};
+
+		Slot &slot(uint16_t sequenceNumber);
+		const Slot &slot(uint16_t sequenceNumber) const;
+		void put(Slot &slot, message_ptr packet);
+		void evictOldest();
+
+		/// Maximum storage size and total size
+		const size_t mMaxSize;
+		const size_t mMaxBytes;
+
+		/// Slots, where the capacity is a power of 2 so sequence numbers wrap around consistently
+		std::vector<Slot> mSlots;
+		const uint16_t mMask;
+
+		mutable std::mutex mMutex; // for writers
+		uint16_t mOldest = 0;      // sequence number of the oldest packet
+		size_t mCount = 0;         // number of sequence numbers from the oldest to the newest
+		size_t mSize = 0;
+		size_t mBytes = 0;
 	};
 
 	const shared_ptr<Storage> mStorage;
+
+	mutable std::mutex mMutex; // for RTX and rate limiting
+	optional<SSRC> mRtxSsrc;
+	std::map<uint8_t, uint8_t> mRtxPayloadTypes;
+	uint16_t mRtxSequenceNumber;
+	unsigned int mMaxBitrate = 0;
+	double mBudget = 0; // in bytes
+	clock::time_point mBudgetTime;
+	size_t mRetransmittedPackets = 0;
+	size_t mDroppedRetransmissions = 0;
 };
 
 } // namespace rtc
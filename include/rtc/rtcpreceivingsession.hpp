@@ -30,6 +30,8 @@ public:
 	void incoming(message_vector &messages, const message_callback &send) override;
 	bool requestKeyframe(const message_callback &send) override;
 	bool requestBitrate(unsigned int bitrate, const message_callback &send) override;
+	bool requestRetransmission(SSRC ssrc, const std::vector<uint16_t> &seqNumbers,
+	                           const message_callback &send) override;
 
 	// For backward compatibility
 	[[deprecated("Use Track::requestKeyframe()")]] inline bool requestKeyframe() { return false; };
@@ -39,6 +41,7 @@ protected:
 	void pushREMB(const message_callback &send, unsigned int bitrate);
 	void pushRR(const message_callback &send,unsigned int lastSrDelay);
 	void pushPLI(const message_callback &send);
+	void pushNACK(const message_callback &send, SSRC ssrc, const std::vector<uint16_t> &seqNumbers);
 
 	SSRC mSsrc = 0;
 	uint32_t mGreatestSeqNo = 0;
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_RTP_EXTENSION_MAP_H
+#define RTC_RTP_EXTENSION_MAP_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "description.hpp"
+#include "rtp.hpp"
+
+#include <array>
+
+namespace rtc {
+
+/// Registry of RTP header extensions by negotiated ID
+/// See https://www.rfc-editor.org/rfc/rfc8285.html
+class RTC_CPP_EXPORT RtpExtensionMap {
+public:
+	enum class Extension : uint8_t {
+		VideoOrientation,
+		Mid,
+		Rid,
+		PlayoutDelay,
+		AbsSendTime,
+		TransportSequenceNumber,
+		AbsCaptureTime,
+	};
+
+	inline static const size_t ExtensionCount = 7;
+
+	/// Max ID with a one-byte header, two-byte headers allow up to 255
+	inline static const uint8_t MaxOneByteId = 14;
+
+	/// Max element size with a one-byte header, two-byte headers allow up to 255
+	inline static const size_t MaxOneByteSize = 16;
+
+	static const char *Uri(Extension extension);
+	static optional<Extension> FromUri(string_view uri);
+
+	/// Find an extension element in an RTP packet with a one-byte or a two-byte header
+	/// @param rtp RTP packet
+	/// @param size Size of the RTP packet
+	/// @param id ID of the extension
+	/// @param length Set to the size of the element
+	/// @return the element data, or nullptr if not present
+	static const byte *Find(const RtpHeader *rtp, size_t size, uint8_t id, size_t &length);
+
+	RtpExtensionMap() = default;
+
+	/// Construct from the extensions negotiated in a media description
+	RtpExtensionMap(const Description::Media &desc);
+
+	void set(Extension extension, uint8_t id); // 0 unregisters the extension
+	uint8_t id(Extension extension) const;     // 0 if the extension is not registered
+	optional<Extension> find(uint8_t id) const;
+
+	bool operator==(const RtpExtensionMap &other) const;
+	bool operator!=(const RtpExtensionMap &other) const;
+
+private:
+	std::array<uint8_t, ExtensionCount> mIds = {};
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_RTP_EXTENSION_MAP_H */
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_RTP_JITTER_BUFFER_H
+#define RTC_RTP_JITTER_BUFFER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "mediahandler.hpp"
+#include "message.hpp"
+#include "rtp.hpp"
+
+#include <chrono>
+#include <deque>
+#include <map>
+
+namespace rtc {
+
+/// Jitter buffer reordering the RTP packets of a stream by sequence number and outputting them
+/// frame by frame, as used by frame depacketizers
+/// A frame is complete when its packets are contiguous up to the one with the marker bit. An
+/// incomplete frame is awaited for the latency, then it is dropped and the loss is signaled.
+/// The latency is checked when popping, so depacketizers pop on every incoming() call and
+/// schedule a poll of the incoming chain for the next deadline, which releases the last frame of
+/// a stream which stops.
+class RTC_CPP_EXPORT RtpJitterBuffer {
+public:
+	using clock = std::chrono::steady_clock;
+
+	inline static const std::chrono::milliseconds DefaultLatency = std::chrono::milliseconds(100);
+	inline static const size_t DefaultMaxPackets = 1024;
+
+	/// Delay before requesting a missing packet, so reordered packets are not requested
+	inline static const std::chrono::milliseconds ReorderDelay = std::chrono::milliseconds(10);
+
+	/// Delay without packets from the current SSRC before packets from another one are accepted
+	inline static const std::chrono::milliseconds SsrcSwitchDelay =
+	    std::chrono::milliseconds(500);
+
+	/// @param latency maximum time to wait for missing packets of a frame
+	/// @param maxPackets maximum number of buffered packets, older frames are dropped past it
+	RtpJitterBuffer(std::chrono::milliseconds latency = DefaultLatency,
+	                size_t maxPackets = DefaultMaxPackets);
+
+	/// Insert an RTP packet, late and duplicate packets are ignored
+	/// A packet further than the max packet count from the expected sequence numbers, like after
+	/// the sender restarted, resets the buffer if the next one confirms the jump.
+	void insert(message_ptr packet, clock::time_point now = clock::now());
+
+	/// Pop the packets of the next frame, ordered by sequence number
+	/// @return false if no frame is ready
+	bool pop(message_vector &packets, clock::time_point now = clock::now());
+
+	/// Signal losses to the handler chain: packets still missing after the reorder delay are
+	/// requested for retransmission and a keyframe is requested if frames were dropped
+	void signalLosses(MediaHandler &handler, const message_callback &send,
+	                  clock::time_point now = clock::now());
+
+	/// Schedule a poll of the incoming chain of the handler at the next deadline for popping or
+	/// signaling losses, unless one is already scheduled before it
+	void schedulePoll(MediaHandler &handler, clock::time_point now = clock::now());
+
+	/// Skip to an inserted packet starting a frame which does not depend on previous ones, like
+	/// the first packet of a new coded video sequence: older packets are dropped without waiting
+	/// for missing ones, and no keyframe is requested for them
+	void skipTo(const message_ptr &packet);
+
+	/// Reset the buffer, like when the stream changes
+	void reset();
+
+	size_t droppedFrames() const; // frames with packets dropped from the buffer
+	size_t lostPackets() const;
+	size_t latePackets() const;
+
+private:
+	struct Entry {
+		message_ptr packet;
+		clock::time_point arrival;
+	};
+
+	using Map = std::map<uint64_t, Entry>; // by extended sequence number
+
+	optional<clock::time_point> nextDeadline() const;
+	bool isFrameStart(Map::const_iterator it) const;
+	Map::const_iterator findFrameEnd(Map::const_iterator it) const;
+	void drop(Map::const_iterator it);
+	void dropHead();
+
+	const std::chrono::milliseconds mLatency;
+	const size_t mMaxPackets;
+
+	Map mPackets;
+	optional<SSRC> mSsrc;
+	clock::time_point mLastArrival;        // of the last packet from the SSRC
+	message_ptr mResyncPacket;             // far from the expected sequence numbers
+	optional<clock::time_point> mNextPoll; // scheduled poll
+	uint64_t mHighestSeqNumber = 0;
+	uint64_t mNextSeqNumber = 0;           // next sequence number to output
+	bool mStarted = false;                 // a packet was output or dropped
+	bool mFrameStart = true;               // the next packet starts a frame
+	optional<uint32_t> mPreviousTimestamp; // timestamp of the packet before the next one
+	optional<uint32_t> mDroppedTimestamp;  // timestamp of the last dropped frame
+
+	struct Missing {
+		uint64_t seqNumber;
+		clock::time_point detected;
+	};
+
+	std::deque<Missing> mMissing;
+	bool mKeyframeNeeded = false;
+	optional<clock::time_point> mLastKeyframeRequest;
+
+	size_t mDroppedFrames = 0;
+	size_t mLostPackets = 0;
+	size_t mLatePackets = 0;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_RTP_JITTER_BUFFER_H */
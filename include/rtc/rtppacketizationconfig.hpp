@@ -12,6 +12,7 @@
 #if RTC_ENABLE_MEDIA
 
 #include "rtp.hpp"
+#include "rtpextensionmap.hpp"
 
 namespace rtc {
 
@@ -69,6 +70,22 @@ public:
 	uint16_t playoutDelayMin = 0;
 	uint16_t playoutDelayMax = 0;
 
+	// Absolute send time Extension Header, written with the send time of each packet
+	// https://webrtc.googlesource.com/src/+/main/docs/native-code/rtp-hdrext/abs-send-time/README.md
+	uint8_t absSendTimeId = 0;
+
+	// Transport-wide sequence number Extension Header, the value is written by the transport when
+	// the packet is sent, so the ID must be the negotiated one
+	// https://datatracker.ietf.org/doc/html/draft-holmer-rmcat-transport-wide-cc-extensions-01
+	uint8_t transportSequenceNumberId = 0;
+
+	// Absolute capture time Extension Header, written for frames with a capture time
+	// https://webrtc.googlesource.com/src/+/main/docs/native-code/rtp-hdrext/abs-capture-time/README.md
+	uint8_t absCaptureTimeId = 0;
+
+	// Register the header extensions negotiated for the media whose ID is not set above
+	bool registerNegotiatedExtensions = false;
+
 	/// Construct RTP configuration used in packetization process
 	/// @param ssrc SSRC of source
 	/// @param cname CNAME of source
@@ -81,6 +98,13 @@ public:
 
 	RtpPacketizationConfig(const RtpPacketizationConfig &) = delete;
 
+	/// Header extensions registered with the IDs above
+	RtpExtensionMap extensionMap() const;
+
+	/// Set the IDs above from registered header extensions
+	/// @param map Header extensions, like the ones negotiated for the media
+	void setExtensionMap(const RtpExtensionMap &map);
+
 	/// Convert timestamp to seconds
 	/// @param timestamp Timestamp
 	/// @param clockRate Clock rate for timestamp calculation
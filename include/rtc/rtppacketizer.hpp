@@ -15,6 +15,8 @@
 #include "message.hpp"
 #include "rtppacketizationconfig.hpp"
 
+#include <array>
+
 namespace rtc {
 
 /// RTP packetizer
@@ -40,6 +42,35 @@ public:
 	const shared_ptr<RtpPacketizationConfig> rtpConfig;
 
 protected:
+	/// View of an RTP payload: a few payload header bytes followed by parts of other data
+	struct PayloadView {
+		struct Part {
+			const byte *data = nullptr;
+			size_t size = 0;
+			bool sizePrefixed = false; // preceded by its 16-bit size, like in aggregation packets
+		};
+
+		static const size_t MaxParts = 8;
+
+		std::array<byte, 8> header = {}; // payload header, like a FU indicator and header
+		size_t headerSize = 0;
+		std::array<Part, MaxParts> parts = {};
+
+		size_t size() const {
+			size_t result = headerSize;
+			for (const auto &part : parts)
+				result += part.size + (part.sizePrefixed ? 2 : 0);
+
+			return result;
+		}
+	};
+
+	/// Fragment data into payload views over it, to be written directly into RTP packets
+	/// Default implementation returns false, then fragment() is called instead
+	/// @param data Input data, which outlives the views
+	/// @param views Output payload views
+	virtual bool fragmentViews(const binary &data, std::vector<PayloadView> &views);
+
 	/// Fragment data into payloads
 	/// Default implementation returns data as a single payload
 	/// @param message Input data
@@ -51,12 +82,50 @@ protected:
 	/// @param mark Set marker flag in RTP packet if true
 	virtual message_ptr packetize(const binary &payload, bool mark);
 
+	/// Creates an RTP packet for a payload view
+	/// @note This function increases the sequence number.
+	/// @param payload RTP payload view
+	/// @param mark Set marker flag in RTP packet if true
+	message_ptr packetize(const PayloadView &payload, bool mark);
+
 	// For backward compatibility, do not use
 	[[deprecated]] virtual message_ptr packetize(shared_ptr<binary> payload, bool mark);
 
 private:
 	static const auto RtpHeaderSize = 12;
 	static const auto RtpExtHeaderCvoSize = 8;
+
+	/// Prebuilt RTP header with extensions, copied into each packet then patched
+	struct HeaderTemplate {
+		binary header;
+		size_t absSendTimeOffset = 0; // offsets of values written for each packet, 0 if absent
+		size_t absCaptureTimeOffset = 0;
+	};
+
+	/// Configuration values header templates are built from
+	struct HeaderParams {
+		HeaderParams() = default;
+		HeaderParams(const RtpPacketizationConfig &config);
+
+		bool matches(const RtpPacketizationConfig &config) const;
+
+		SSRC ssrc = 0;
+		uint8_t payloadType = 0;
+		RtpExtensionMap extensions;
+		uint8_t videoOrientation = 0;
+		optional<string> mid;
+		optional<string> rid;
+		uint16_t playoutDelayMin = 0;
+		uint16_t playoutDelayMax = 0;
+	};
+
+	const HeaderTemplate &headerTemplate(bool mark, bool captureTime);
+	HeaderTemplate buildHeaderTemplate(bool mark, bool captureTime) const;
+
+	HeaderParams mHeaderParams;
+	// Indexed by the marker bit and the presence of abs-capture-time
+	std::array<optional<HeaderTemplate>, 4> mHeaderTemplates;
+	uint64_t mCaptureTime = 0; // NTP capture time of the current frame, 0 if unknown
 };
 
 // Generic audio RTP packetizer
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_RTX_UNWRAPPER_H
+#define RTC_RTX_UNWRAPPER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "mediahandler.hpp"
+#include "rtp.hpp"
+
+#include <map>
+
+namespace rtc {
+
+/// Restores the original packets from incoming RTX retransmissions (RFC 4588)
+/// Incoming messages go through the chain from the end, so it must be chained after the
+/// depacketizer and the RTCP receiving session.
+class RTC_CPP_EXPORT RtxUnwrapper final : public MediaHandler {
+public:
+	/// @param ssrc Media SSRC
+	/// @param rtxSsrc RTX SSRC
+	/// @param payloadTypes Original payload type for each RTX payload type
+	RtxUnwrapper(SSRC ssrc, SSRC rtxSsrc, std::map<uint8_t, uint8_t> payloadTypes);
+	/// Same with the FID groups and RTX payload types of the remote media description
+	RtxUnwrapper(const Description::Media &media);
+
+	void incoming(message_vector &messages, const message_callback &send) override;
+
+private:
+	message_ptr unwrap(const message_ptr &message, SSRC ssrc) const;
+
+	std::map<SSRC, SSRC> mSsrcs; // RTX SSRC to media SSRC
+	std::map<uint8_t, uint8_t> mPayloadTypes;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_RTX_UNWRAPPER_H */
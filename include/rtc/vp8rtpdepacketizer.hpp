@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_VP8_RTP_DEPACKETIZER_H
+#define RTC_VP8_RTP_DEPACKETIZER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "mediahandler.hpp"
+#include "message.hpp"
+#include "rtp.hpp"
+#include "rtpjitterbuffer.hpp"
+
+#include <chrono>
+
+namespace rtc {
+
+/// RTP depacketization for VP8
+/// See https://www.rfc-editor.org/rfc/rfc7741.html
+class RTC_CPP_EXPORT VP8RtpDepacketizer : public MediaHandler {
+public:
+	inline static const uint32_t ClockRate = 90 * 1000;
+
+	/// @param latency maximum time to wait for missing packets of a frame
+	VP8RtpDepacketizer(std::chrono::milliseconds latency = RtpJitterBuffer::DefaultLatency);
+	virtual ~VP8RtpDepacketizer() = default;
+
+	void incoming(message_vector &messages, const message_callback &send) override;
+
+private:
+	message_ptr buildFrame(const message_vector &packets);
+
+	RtpJitterBuffer mJitterBuffer;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_VP8_RTP_DEPACKETIZER_H */
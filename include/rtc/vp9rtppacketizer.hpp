@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_VP9_RTP_PACKETIZER_H
+#define RTC_VP9_RTP_PACKETIZER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtppacketizer.hpp"
+
+namespace rtc {
+
+/// RTP packetization for VP9 in flexible mode
+/// See https://www.rfc-editor.org/rfc/rfc9628.html
+class RTC_CPP_EXPORT VP9RtpPacketizer final : public RtpPacketizer {
+public:
+	inline static const uint32_t ClockRate = VideoClockRate;
+
+	/// Constructs VP9 payload packetizer with given RTP configuration.
+	/// @note RTP configuration is used in packetization process which may change some configuration
+	/// properties such as sequence number.
+	/// @note Reference indices are derived from the reference slots in frame headers. A superframe
+	/// is sent as a single layer frame, as spatial layers are not known by the packetizer.
+	/// @param rtpConfig RTP configuration
+	/// @param maxFragmentSize maximum size of one frame fragment, including payload descriptor
+	VP9RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig,
+	                 size_t maxFragmentSize = DefaultMaxFragmentSize);
+
+private:
+	static std::vector<PayloadView::Part> splitSuperframe(const binary &data);
+
+	bool fragmentViews(const binary &data, std::vector<PayloadView> &views) override;
+
+	const size_t mMaxFragmentSize;
+	uint16_t mPictureId; // 15-bit picture ID
+	uint64_t mPictureCount = 0;
+	std::array<optional<uint64_t>, 8> mSlotPictures; // pictures held by the reference slots
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_VP9_RTP_PACKETIZER_H */
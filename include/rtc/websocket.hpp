@@ -23,6 +23,8 @@ struct WebSocket;
 
 }
 
+class WebSocketServer;
+
 class RTC_CPP_EXPORT WebSocket final : private CheshireCat<impl::WebSocket>, public Channel {
 public:
 	enum class State : int {
@@ -54,8 +56,15 @@ public:
 	optional<string> remoteAddress() const;
 	optional<string> path() const;
 
+	// Send statistics, in bytes except for the message count
+	size_t bytesSent() const;    // passed to the transport
+	size_t bytesDropped() const; // dropped by the overflow policy
+	size_t messagesDropped() const;
+
 private:
 	using CheshireCat<impl::WebSocket>::impl;
+
+	friend class WebSocketServer;
 };
 
 std::ostream &operator<<(std::ostream &out, WebSocket::State state);
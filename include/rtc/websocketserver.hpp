@@ -15,6 +15,8 @@
 #include "configuration.hpp"
 #include "websocket.hpp"
 
+#include <vector>
+
 namespace rtc {
 
 namespace impl {
@@ -35,8 +37,15 @@ public:
 
 	uint16_t port() const;
 
+	// The callback is called for one client at a time, but possibly from different threads
 	void onClient(std::function<void(shared_ptr<WebSocket>)> callback);
 
+	// Send a message to several clients, building the frame once and sharing it between them
+	// Backpressure follows the send watermarks and overflow policy of each client, except that
+	// broadcasting never blocks
+	// Returns the number of clients the message was sent or queued to
+	size_t broadcast(const std::vector<shared_ptr<WebSocket>> &clients, message_variant data);
+
 private:
 	using CheshireCat<impl::WebSocketServer>::impl;
 };
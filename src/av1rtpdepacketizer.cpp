@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "av1rtpdepacketizer.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rtc {
+
+namespace {
+
+const uint8_t zMask = 0b10000000;
+const uint8_t yMask = 0b01000000;
+const uint8_t wMask = 0b00110000;
+const uint8_t wBitshift = 4;
+const uint8_t nMask = 0b00001000;
+
+const uint8_t obuTypeMask = 0b01111000;
+const uint8_t obuTypeBitshift = 3;
+const uint8_t obuHasExtensionMask = 0b00000100;
+const uint8_t obuHasSizeMask = 0b00000010;
+
+const uint8_t obuTypeTemporalDelimiter = 2;
+
+const byte obuTemporalDelimiter[2] = {byte(0x12), byte(0x00)};
+
+// Return true if the packet is the first packet of a coded video sequence
+bool IsSequenceStart(const message_ptr &pkt) {
+	auto header = reinterpret_cast<const RtpHeader *>(pkt->data());
+	size_t headerSize = header->getSize() + header->getExtensionHeaderSize();
+	return pkt->size() > headerSize && (uint8_t(pkt->at(headerSize)) & nMask);
+}
+
+// Read a leb128 value, return the number of bytes read or 0 if it is invalid
+// See https://aomediacodec.github.io/av1-spec/#leb128
+size_t ReadLeb128(const byte *data, size_t size, size_t &value) {
+	value = 0;
+	for (size_t i = 0; i < std::min(size, size_t(8)); ++i) {
+		const uint8_t b = uint8_t(data[i]);
+		value |= size_t(b & 0x7F) << (i * 7);
+		if (!(b & 0x80))
+			return i + 1;
+	}
+	return 0;
+}
+
+size_t WriteLeb128(size_t value, byte *out) {
+	size_t size = 0;
+	do {
+		out[size] = byte(value & 0x7F);
+		value >>= 7;
+		if (value > 0)
+			out[size] |= byte(0x80);
+		++size;
+	} while (value > 0);
+	return size;
+}
+
+// Terminate the OBU starting at obuStart in the temporal unit, adding an OBU size field if there is
+// none, as OBUs in RTP packets should not have one. Return false if the OBU is invalid.
+bool FinishObu(binary &tu, size_t obuStart) {
+	const size_t obuSize = tu.size() - obuStart;
+	if (obuSize == 0)
+		return false;
+
+	const uint8_t header = uint8_t(tu[obuStart]);
+	const size_t headerSize = (header & obuHasExtensionMask) ? 2 : 1;
+	if (obuSize < headerSize)
+		return false;
+
+	// Temporal delimiters should be removed by the sender, the output already starts with one
+	if ((header & obuTypeMask) >> obuTypeBitshift == obuTypeTemporalDelimiter) {
+		tu.resize(obuStart);
+		return true;
+	}
+
+	if (header & obuHasSizeMask)
+		return true;
+
+	// The OBU is at the end of the temporal unit, so inserting the size only moves its payload
+	byte leb128[8];
+	const size_t leb128Size = WriteLeb128(obuSize - headerSize, leb128);
+	tu[obuStart] = byte(header | obuHasSizeMask);
+	tu.insert(tu.begin() + obuStart + headerSize, leb128, leb128 + leb128Size);
+	return true;
+}
+
+} // namespace
+
+AV1RtpDepacketizer::AV1RtpDepacketizer(std::chrono::milliseconds latency)
+    : mJitterBuffer(latency) {}
+
+message_ptr AV1RtpDepacketizer::buildFrame(const message_vector &packets) {
+	// The temporal unit is pre-sized from the packets so it does not grow while OBUs are appended,
+	// as the RTP and aggregation headers are larger than the OBU size fields added per packet
+	size_t capacity = sizeof(obuTemporalDelimiter);
+	for (const auto &pkt : packets)
+		capacity += pkt->size();
+
+	binary tu;
+	tu.reserve(capacity);
+	tu.insert(tu.end(), obuTemporalDelimiter, obuTemporalDelimiter + sizeof(obuTemporalDelimiter));
+
+	bool inObu = false; // an OBU fragment continues in the next packet
+	size_t obuStart = 0;
+	for (size_t i = 0; i < packets.size(); ++i) {
+		const auto &pkt = packets[i];
+		auto header = reinterpret_cast<const RtpHeader *>(pkt->data());
+		size_t headerSize = header->getSize() + header->getExtensionHeaderSize();
+		size_t paddingSize = header->padding() ? std::to_integer<uint8_t>(pkt->back()) : 0;
+		if (pkt->size() <= headerSize + paddingSize) {
+			PLOG_VERBOSE << "AV1 RTP packet has no aggregation header";
+			return nullptr;
+		}
+
+		// Aggregation header
+		const byte *payload = pkt->data() + headerSize;
+		const size_t payloadSize = pkt->size() - headerSize - paddingSize;
+		const uint8_t aggregationHeader = uint8_t(payload[0]);
+		const bool continuation = aggregationHeader & zMask;
+		const bool continued = aggregationHeader & yMask;
+		const size_t count = (aggregationHeader & wMask) >> wBitshift;
+		if (continuation != inObu) {
+			PLOG_VERBOSE << "AV1 OBU fragments are inconsistent, dropping temporal unit";
+			return nullptr;
+		}
+
+		// OBU elements
+		size_t offset = 1;
+		size_t element = 0;
+		while (offset < payloadSize) {
+			size_t elementSize = payloadSize - offset;
+			if (count == 0 || element + 1 < count) {
+				size_t length = 0;
+				const size_t leb128Size =
+				    ReadLeb128(payload + offset, payloadSize - offset, length);
+				if (leb128Size == 0 || length > payloadSize - offset - leb128Size) {
+					PLOG_VERBOSE << "AV1 OBU element length is invalid, dropping temporal unit";
+					return nullptr;
+				}
+				offset += leb128Size;
+				elementSize = length;
+			}
+
+			if (!(element == 0 && continuation))
+				obuStart = tu.size();
+
+			tu.insert(tu.end(), payload + offset, payload + offset + elementSize);
+			offset += elementSize;
+			++element;
+
+			const bool last = offset >= payloadSize;
+			if (!(last && continued) && !FinishObu(tu, obuStart)) {
+				PLOG_VERBOSE << "AV1 OBU is invalid, dropping temporal unit";
+				return nullptr;
+			}
+		}
+
+		if (element == 0 || (count != 0 && element != count)) {
+			PLOG_VERBOSE << "AV1 OBU element count is invalid, dropping temporal unit";
+			return nullptr;
+		}
+
+		inObu = continued;
+	}
+
+	if (inObu) {
+		PLOG_VERBOSE << "AV1 temporal unit ends with an OBU fragment, dropping it";
+		return nullptr;
+	}
+
+	auto header = reinterpret_cast<const RtpHeader *>(packets.front()->data());
+	auto frameInfo = std::make_shared<FrameInfo>(header->timestamp());
+	frameInfo->timestampSeconds =
+	    std::chrono::duration<double>(double(header->timestamp()) / double(ClockRate));
+	frameInfo->payloadType = header->payloadType();
+	frameInfo->sequenceStart = IsSequenceStart(packets.front());
+	return make_message(std::move(tu), frameInfo);
+}
+
+void AV1RtpDepacketizer::incoming(message_vector &messages, const message_callback &send) {
+	message_vector result;
+	for (auto &message : messages) {
+		if (message->type == Message::Control) {
+			result.push_back(std::move(message));
+			continue;
+		}
+
+		if (message->size() < sizeof(RtpHeader)) {
+			PLOG_VERBOSE << "RTP packet is too small, size=" << message->size();
+			continue;
+		}
+
+		// A new coded video sequence does not depend on the previous temporal units, so they are
+		// output if complete and not awaited anymore otherwise
+		if (IsSequenceStart(message)) {
+			popFrames(result);
+			mJitterBuffer.insert(message);
+			mJitterBuffer.skipTo(message);
+			continue;
+		}
+
+		mJitterBuffer.insert(std::move(message));
+	}
+
+	popFrames(result);
+	mJitterBuffer.signalLosses(*this, send);
+	mJitterBuffer.schedulePoll(*this);
+	messages.swap(result);
+}
+
+void AV1RtpDepacketizer::popFrames(message_vector &frames) {
+	message_vector packets;
+	while (mJitterBuffer.pop(packets))
+		if (auto frame = buildFrame(packets))
+			frames.push_back(std::move(frame));
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
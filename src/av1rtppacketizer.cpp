@@ -45,8 +45,9 @@ AV1RtpPacketizer::AV1RtpPacketizer(Packetization packetization,
                                    size_t maxFragmentSize)
     : RtpPacketizer(rtpConfig), mPacketization(packetization), mMaxFragmentSize(maxFragmentSize) {}
 
-std::vector<binary> AV1RtpPacketizer::extractTemporalUnitObus(const binary &data) {
-	std::vector<binary> obus;
+std::vector<RtpPacketizer::PayloadView::Part>
+AV1RtpPacketizer::extractTemporalUnitObus(const binary &data) {
+	std::vector<PayloadView::Part> obus;
 
 	if (data.size() <= 2 || (data.at(0) != obuTemporalUnitDelimiter.at(0)) ||
 	    (data.at(1) != obuTemporalUnitDelimiter.at(1))) {
@@ -82,29 +83,27 @@ std::vector<binary> AV1RtpPacketizer::extractTemporalUnitObus(const binary &data
 			}
 		}
 
-		obus.emplace_back(data.begin() + index,
-		                  data.begin() + index + obuHeaderSize + leb128Size + obuLength);
+		const size_t obuSize = obuHeaderSize + leb128Size + obuLength;
+		if (index + obuSize > data.size())
+			break; // truncated OBU
 
-		index += obuHeaderSize + leb128Size + obuLength;
+		obus.push_back({data.data() + index, obuSize});
+		index += obuSize;
 	}
 
 	return obus;
 }
 
-std::vector<binary> AV1RtpPacketizer::fragment(binary data) {
+bool AV1RtpPacketizer::fragmentViews(const binary &data, std::vector<PayloadView> &views) {
+	mSentSequenceHeaders.clear(); // views of the previous data have been packetized
+
 	if (mPacketization == AV1RtpPacketizer::Packetization::TemporalUnit) {
-		std::vector<binary> result;
-		auto obus = extractTemporalUnitObus(data);
-		for (auto obu : obus) {
-			auto fragments = fragmentObu(obu);
-			result.reserve(result.size() + fragments.size());
-			for(auto &fragment : fragments)
-				result.push_back(std::move(fragment));
-		}
-		return result;
+		for (const auto &obu : extractTemporalUnitObus(data))
+			fragmentObu(obu, views);
 	} else {
-		return fragmentObu(data);
+		fragmentObu({data.data(), data.size()}, views);
 	}
+	return true;
 }
 
 /*
@@ -138,69 +137,64 @@ std::vector<binary> AV1RtpPacketizer::fragment(binary data) {
  *
  **/
 
-std::vector<binary> AV1RtpPacketizer::fragmentObu(const binary &data) {
-	std::vector<binary> payloads;
-
-	if (data.size() < 1)
-		return {};
+void AV1RtpPacketizer::fragmentObu(PayloadView::Part obu, std::vector<PayloadView> &views) {
+	if (obu.size < 1)
+		return;
 
 	// Cache sequence header and packetize with next OBU
-	auto frameType = (data.at(0) & obuFrameTypeMask) >> obuFrameTypeBitshift;
+	auto frameType = (obu.data[0] & obuFrameTypeMask) >> obuFrameTypeBitshift;
 	if (frameType == obuFrameTypeSequenceHeader) {
-		mSequenceHeader = std::make_unique<binary>(data.begin(), data.end());
-		return {};
+		mSequenceHeader = std::make_unique<binary>(obu.data, obu.data + obu.size);
+		return;
 	}
 
 	size_t index = 0;
-	size_t remaining = data.size();
+	size_t remaining = obu.size;
 	while (remaining > 0) {
 		size_t obuCount = 1;
 		size_t metadataSize = payloadHeaderSize;
 
 		if (mSequenceHeader) {
 			obuCount++;
-			metadataSize += 1 + int(mSequenceHeader->size()); // 1 byte leb128
+			metadataSize += 1 + mSequenceHeader->size(); // 1 byte leb128
 		}
 
-		binary payload(std::min(size_t(mMaxFragmentSize), remaining + metadataSize));
-		size_t payloadOffset = payloadHeaderSize;
+		const size_t payloadSize = std::min(size_t(mMaxFragmentSize), remaining + metadataSize);
+		if (payloadSize <= metadataSize)
+			break; // no room for the OBU
 
-		payload.at(0) = byte(obuCount) << wBitshift;
+		PayloadView view;
+		view.header[0] = byte(obuCount) << wBitshift;
+		view.headerSize = payloadHeaderSize;
 
-		// Packetize cached SequenceHeader
+		// Packetize cached SequenceHeader, it is kept until the views are packetized
 		if (obuCount == 2) {
-			payload.at(0) ^= nMask;
-			payload.at(1) = byte(mSequenceHeader->size() & sevenLsbBitmask);
-			payloadOffset += oneByteLeb128Size;
-
-			std::memcpy(payload.data() + payloadOffset, mSequenceHeader->data(),
-			            mSequenceHeader->size());
-			payloadOffset += int(mSequenceHeader->size());
+			view.header[0] ^= nMask;
+			view.header[1] = byte(mSequenceHeader->size() & sevenLsbBitmask);
+			view.headerSize += oneByteLeb128Size;
+			view.parts[0] = {mSequenceHeader->data(), mSequenceHeader->size()};
 
-			mSequenceHeader = nullptr;
+			mSentSequenceHeaders.push_back(std::move(mSequenceHeader));
 		}
 
-		// Copy as much of OBU as possible into Payload
-		size_t payloadRemaining = payload.size() - payloadOffset;
-		std::memcpy(payload.data() + payloadOffset, data.data() + index,
-		            payloadRemaining);
+		// Put as much of OBU as possible into Payload
+		const size_t payloadRemaining = payloadSize - metadataSize;
+		view.parts[1] = {obu.data + index, payloadRemaining};
 		remaining -= payloadRemaining;
 		index += payloadRemaining;
 
 		// Does this Fragment contain an OBU that started in a previous payload
-		if (payloads.size() > 0) {
-			payload.at(0) ^= zMask;
+		if (index > payloadRemaining) {
+			view.header[0] ^= zMask;
 		}
 
 		// This OBU will be continued in next Payload
-		if (index < data.size()) {
-			payload.at(0) ^= yMask;
+		if (index < obu.size) {
+			view.header[0] ^= yMask;
 		}
 
-		payloads.push_back(std::move(payload));
+		views.push_back(view);
 	}
-
-	return payloads;
 }
 
 } // namespace rtc
@@ -596,7 +596,7 @@ void Description::removeAttribute(const string &attr) {
 	    mAttributes.end());
 }
 
-std::vector<int> Description::Entry::extIds() {
+std::vector<int> Description::Entry::extIds() const {
 	std::vector<int> result;
 	for (auto it = mExtMaps.begin(); it != mExtMaps.end(); ++it)
 		result.push_back(it->first);
@@ -818,7 +818,7 @@ bool Description::Media::hasSSRC(uint32_t ssrc) const {
 void Description::Media::clearSSRCs() {
 	auto it = mAttributes.begin();
 	while (it != mAttributes.end()) {
-		if (match_prefix(*it, "ssrc:"))
+		if (match_prefix(*it, "ssrc:") || match_prefix(*it, "ssrc-group:"))
 			it = mAttributes.erase(it);
 		else
 			++it;
@@ -830,6 +830,27 @@ void Description::Media::clearSSRCs() {
 
 std::vector<uint32_t> Description::Media::getSSRCs() const { return mSsrcs; }
 
+void Description::Media::addRtxSSRC(uint32_t ssrc, uint32_t rtxSsrc) {
+	addSSRC(rtxSsrc, getCNameForSsrc(ssrc));
+	mAttributes.emplace_back("ssrc-group:FID " + std::to_string(ssrc) + " " +
+	                         std::to_string(rtxSsrc));
+}
+
+std::map<uint32_t, uint32_t> Description::Media::getRtxSSRCs() const {
+	std::map<uint32_t, uint32_t> result;
+	for (const auto &attr : mAttributes) {
+		if (!match_prefix(attr, "ssrc-group:FID "))
+			continue;
+
+		// See https://www.rfc-editor.org/rfc/rfc4588.html#section-8.3
+		std::istringstream ss(attr.substr(15));
+		uint32_t ssrc, rtxSsrc;
+		if (ss >> ssrc >> rtxSsrc)
+			result.emplace(rtxSsrc, ssrc);
+	}
+	return result;
+}
+
 optional<string> Description::Media::getCNameForSsrc(uint32_t ssrc) const {
 	auto it = mCNameMap.find(ssrc);
 	if (it != mCNameMap.end()) {
@@ -849,6 +870,7 @@ Description::Application Description::Application::reciprocate() const {
 	Application reciprocated(*this);
 
 	reciprocated.mMaxMessageSize.reset();
+	reciprocated.mSctpFastOpenStreams.reset();
 
 	return reciprocated;
 }
@@ -859,10 +881,18 @@ void Description::Application::hintSctpPort(uint16_t port) { mSctpPort = mSctpPo
 
 void Description::Application::setMaxMessageSize(size_t size) { mMaxMessageSize = size; }
 
+void Description::Application::setSctpFastOpenStreams(uint16_t count) {
+	mSctpFastOpenStreams = count;
+}
+
 optional<uint16_t> Description::Application::sctpPort() const { return mSctpPort; }
 
 optional<size_t> Description::Application::maxMessageSize() const { return mMaxMessageSize; }
 
+optional<uint16_t> Description::Application::sctpFastOpenStreams() const {
+	return mSctpFastOpenStreams;
+}
+
 string Description::Application::generateSdpLines(string_view eol) const {
 	std::ostringstream sdp;
 	sdp << Entry::generateSdpLines(eol);
@@ -873,6 +903,11 @@ string Description::Application::generateSdpLines(string_view eol) const {
 	if (mMaxMessageSize)
 		sdp << "a=max-message-size:" << *mMaxMessageSize << eol;
 
+	// Non-standard attribute to pre-negotiate SCTP fast-open with the streams count, so that
+	// DataChannels may be opened before INIT and INIT-ACK are exchanged
+	if (mSctpFastOpenStreams)
+		sdp << "a=sctp-fast-open:" << *mSctpFastOpenStreams << eol;
+
 	return sdp.str();
 }
 
@@ -885,6 +920,8 @@ void Description::Application::parseSdpLine(string_view line) {
 			mSctpPort = to_integer<uint16_t>(value);
 		} else if (key == "max-message-size") {
 			mMaxMessageSize = to_integer<size_t>(value);
+		} else if (key == "sctp-fast-open") {
+			mSctpFastOpenStreams = to_integer<uint16_t>(value);
 		} else {
 			Entry::parseSdpLine(line);
 		}
@@ -1046,6 +1083,20 @@ void Description::Media::addRtxCodec(int payloadType, int origPayloadType, unsig
 	addRtpMap(rtp);
 }
 
+std::map<int, int> Description::Media::rtxPayloadTypes() const {
+	std::map<int, int> result;
+	for (const auto &[payloadType, map] : mRtpMaps) {
+		if (!utils::iequals(map.format, "rtx"))
+			continue;
+
+		for (const auto &fmtp : map.fmtps)
+			for (const auto &param : utils::explode(fmtp, ';'))
+				if (match_prefix(param, "apt="))
+					result.emplace(payloadType, to_integer<int>(param.substr(4)));
+	}
+	return result;
+}
+
 string Description::Media::generateSdpLines(string_view eol) const {
 	std::ostringstream sdp;
 	if (mBas >= 0)
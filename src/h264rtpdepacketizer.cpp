@@ -24,7 +24,8 @@ const binary naluShortStartCode = {byte{0}, byte{0}, byte{1}};
 const uint8_t naluTypeSTAPA = 24;
 const uint8_t naluTypeFUA = 28;
 
-H264RtpDepacketizer::H264RtpDepacketizer(Separator separator) : mSeparator(separator) {
+H264RtpDepacketizer::H264RtpDepacketizer(Separator separator, std::chrono::milliseconds latency)
+    : mSeparator(separator), mJitterBuffer(latency) {
 	if (separator != Separator::StartSequence && separator != Separator::LongStartSequence &&
 	    separator != Separator::ShortStartSequence) {
 		throw std::invalid_argument("Invalid separator");
@@ -118,7 +119,7 @@ message_vector H264RtpDepacketizer::buildFrames(message_vector::iterator begin,
 	return out;
 }
 
-void H264RtpDepacketizer::incoming(message_vector &messages, const message_callback &) {
+void H264RtpDepacketizer::incoming(message_vector &messages, const message_callback &send) {
 	messages.erase(std::remove_if(messages.begin(), messages.end(),
 	                              [&](message_ptr message) {
 		                              if (message->type == Message::Control) {
@@ -131,41 +132,22 @@ void H264RtpDepacketizer::incoming(message_vector &messages, const message_callb
 			                              return true;
 		                              }
 
-		                              mRtpBuffer.push_back(std::move(message));
+		                              mJitterBuffer.insert(std::move(message));
 		                              return true;
 	                              }),
 	               messages.end());
 
-	while (mRtpBuffer.size() != 0) {
-		uint8_t payload_type = 0;
-		uint32_t current_timestamp = 0;
-		size_t packets_in_timestamp = 0;
-
-		for (const auto &pkt : mRtpBuffer) {
-			auto p = reinterpret_cast<const rtc::RtpHeader *>(pkt->data());
-
-			if (current_timestamp == 0) {
-				current_timestamp = p->timestamp();
-				payload_type =
-				    p->payloadType(); // should all be the same for data of the same codec
-			} else if (current_timestamp != p->timestamp()) {
-				break;
-			}
-
-			packets_in_timestamp++;
-		}
-
-		if (packets_in_timestamp == mRtpBuffer.size()) {
-			break;
-		}
-
-		auto begin = mRtpBuffer.begin();
-		auto end = mRtpBuffer.begin() + (packets_in_timestamp - 1);
-
-		auto frames = buildFrames(begin, end + 1, payload_type, current_timestamp);
+	message_vector packets;
+	while (mJitterBuffer.pop(packets)) {
+		// Payload type should be the same for all packets of the same codec
+		auto header = reinterpret_cast<const RtpHeader *>(packets.front()->data());
+		auto frames =
+		    buildFrames(packets.begin(), packets.end(), header->payloadType(), header->timestamp());
 		messages.insert(messages.end(), frames.begin(), frames.end());
-		mRtpBuffer.erase(mRtpBuffer.begin(), mRtpBuffer.begin() + packets_in_timestamp);
 	}
+
+	mJitterBuffer.signalLosses(*this, send);
+	mJitterBuffer.schedulePoll(*this);
 }
 
 } // namespace rtc
@@ -25,19 +25,85 @@ namespace rtc {
 
 H264RtpPacketizer::H264RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig,
                                      size_t maxFragmentSize)
-    : RtpPacketizer(std::move(rtpConfig)), mSeparator(Separator::Length), mMaxFragmentSize(maxFragmentSize) {}
+    : RtpPacketizer(std::move(rtpConfig)), mSeparator(Separator::Length),
+      mMaxFragmentSize(maxFragmentSize), mAggregate(false) {}
 
 H264RtpPacketizer::H264RtpPacketizer(Separator separator,
                                      shared_ptr<RtpPacketizationConfig> rtpConfig,
-                                     size_t maxFragmentSize)
-    : RtpPacketizer(rtpConfig), mSeparator(separator), mMaxFragmentSize(maxFragmentSize) {}
+                                     size_t maxFragmentSize, bool aggregate)
+    : RtpPacketizer(rtpConfig), mSeparator(separator), mMaxFragmentSize(maxFragmentSize),
+      mAggregate(aggregate) {}
+
+bool H264RtpPacketizer::fragmentViews(const binary &data, std::vector<PayloadView> &views) {
+	// Consecutive small NAL units are aggregated into STAP-A packets if enabled
+	// See https://www.rfc-editor.org/rfc/rfc6184.html#section-5.7.1
+	PayloadView aggregate;
+	size_t aggregateCount = 0;
+	auto flush = [&]() {
+		if (aggregateCount == 1) {
+			// A single NAL unit is sent as is
+			PayloadView view;
+			view.parts[0] = {aggregate.parts[0].data, aggregate.parts[0].size};
+			views.push_back(view);
+		} else if (aggregateCount > 1) {
+			views.push_back(aggregate);
+		}
+		aggregate = PayloadView();
+		aggregateCount = 0;
+	};
+
+	for (const auto &nalu : splitFrame(data)) {
+		if (mAggregate && nalu.size >= H264_NAL_HEADER_SIZE) {
+			if (aggregateCount == PayloadView::MaxParts ||
+			    aggregate.size() + 2 + nalu.size > mMaxFragmentSize)
+				flush();
+
+			if (H264_NAL_HEADER_SIZE + 2 + nalu.size <= mMaxFragmentSize) {
+				// The F bit is set if any NAL unit has it, and NRI is the highest one
+				const uint8_t header = uint8_t(nalu.data[0]);
+				const uint8_t indicator = uint8_t(aggregate.header[0]);
+				aggregate.header[0] = byte(((indicator | header) & 0x80) |
+				                           std::max(indicator & 0x60, header & 0x60) | 24);
+				aggregate.headerSize = H264_NAL_HEADER_SIZE;
+				aggregate.parts[aggregateCount++] = {nalu.data, nalu.size, true};
+				continue;
+			}
+		}
+		flush();
 
-std::vector<binary> H264RtpPacketizer::fragment(binary data) {
-	return NalUnit::GenerateFragments(splitFrame(data), mMaxFragmentSize);
+		if (nalu.size <= mMaxFragmentSize) {
+			PayloadView view;
+			view.parts[0] = nalu;
+			views.push_back(view);
+			continue;
+		}
+
+		// FU-A fragments of even size, as generated by NalUnit::generateFragments()
+		// See https://www.rfc-editor.org/rfc/rfc6184.html#section-5.8
+		const size_t count = (nalu.size + mMaxFragmentSize - 1) / mMaxFragmentSize;
+		const size_t fragmentSize = (nalu.size + count - 1) / count - 2;
+		const uint8_t header = uint8_t(nalu.data[0]);
+		const byte indicator = byte((header & 0xE0) | 28); // F, NRI, and FU-A type
+		const byte *payload = nalu.data + H264_NAL_HEADER_SIZE;
+		const size_t payloadSize = nalu.size - H264_NAL_HEADER_SIZE;
+		for (size_t offset = 0; offset < payloadSize; offset += fragmentSize) {
+			const bool start = offset == 0;
+			const bool end = !start && offset + fragmentSize >= payloadSize;
+			PayloadView view;
+			view.header = {indicator, byte(start << 7 | end << 6 | (header & 0x1F))};
+			view.headerSize = 2;
+			view.parts[0] = {payload + offset, std::min(fragmentSize, payloadSize - offset)};
+			views.push_back(view);
+		}
+	}
+	flush();
+	return true;
 }
 
-std::vector<NalUnit> H264RtpPacketizer::splitFrame(const binary &frame) {
-	std::vector<NalUnit> nalus;
+std::vector<RtpPacketizer::PayloadView::Part>
+H264RtpPacketizer::splitFrame(const binary &frame) {
+	// NAL units are returned as views over the frame
+	std::vector<PayloadView::Part> nalus;
 	if (mSeparator == Separator::Length) {
 		size_t index = 0;
 		while (index < frame.size()) {
@@ -57,40 +123,26 @@ std::vector<NalUnit> H264RtpPacketizer::splitFrame(const binary &frame) {
 				LOG_WARNING << "Invalid NAL Unit data (incomplete unit), ignoring!";
 				break;
 			}
-			auto begin = frame.begin() + naluStartIndex;
-			auto end = frame.begin() + naluEndIndex;
-			nalus.emplace_back(begin, end);
+			nalus.push_back({frame.data() + naluStartIndex, length});
 			index = naluEndIndex;
 		}
 	} else {
-		NalUnitStartSequenceMatch match = NUSM_noMatch;
-		size_t index = 0;
-		while (index < frame.size()) {
-			match = NalUnit::StartSequenceMatchSucc(match, frame[index++], mSeparator);
-			if (match == NUSM_longMatch || match == NUSM_shortMatch) {
-				match = NUSM_noMatch;
-				break;
-			}
-		}
+		// Data before the first start sequence is skipped
+		size_t length = 0;
+		size_t index = NalUnit::FindStartSequence(frame.data(), frame.size(), mSeparator, length);
+		size_t naluStartIndex = index < frame.size() ? index + length : frame.size();
 
-		size_t naluStartIndex = index;
+		while (naluStartIndex < frame.size()) {
+			const size_t remaining = frame.size() - naluStartIndex;
+			const size_t naluLength = NalUnit::FindStartSequence(
+			    frame.data() + naluStartIndex, remaining, mSeparator, length);
+			if (naluLength == remaining)
+				break;
 
-		while (index < frame.size()) {
-			match = NalUnit::StartSequenceMatchSucc(match, frame[index], mSeparator);
-			if (match == NUSM_longMatch || match == NUSM_shortMatch) {
-				auto sequenceLength = match == NUSM_longMatch ? 4 : 3;
-				size_t naluEndIndex = index - sequenceLength;
-				match = NUSM_noMatch;
-				auto begin = frame.begin() + naluStartIndex;
-				auto end = frame.begin() + naluEndIndex + 1;
-				nalus.emplace_back(begin, end);
-				naluStartIndex = index + 1;
-			}
-			index++;
+			nalus.push_back({frame.data() + naluStartIndex, naluLength});
+			naluStartIndex += naluLength + length;
 		}
-		auto begin = frame.begin() + naluStartIndex;
-		auto end = frame.end();
-		nalus.emplace_back(begin, end);
+		nalus.push_back({frame.data() + naluStartIndex, frame.size() - naluStartIndex});
 	}
 	return nalus;
 }
@@ -12,6 +12,7 @@
 
 #include "impl/internals.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 #ifdef _WIN32
@@ -25,19 +26,95 @@ namespace rtc {
 H265RtpPacketizer::H265RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig,
                                      size_t maxFragmentSize)
     : RtpPacketizer(std::move(rtpConfig)), mSeparator(NalUnit::Separator::Length),
-      mMaxFragmentSize(maxFragmentSize) {}
+      mMaxFragmentSize(maxFragmentSize), mAggregate(false) {}
 
 H265RtpPacketizer::H265RtpPacketizer(NalUnit::Separator separator,
                                      shared_ptr<RtpPacketizationConfig> rtpConfig,
-                                     size_t maxFragmentSize)
-    : RtpPacketizer(std::move(rtpConfig)), mSeparator(separator), mMaxFragmentSize(maxFragmentSize) {}
+                                     size_t maxFragmentSize, bool aggregate)
+    : RtpPacketizer(std::move(rtpConfig)), mSeparator(separator), mMaxFragmentSize(maxFragmentSize),
+      mAggregate(aggregate) {}
+
+bool H265RtpPacketizer::fragmentViews(const binary &data, std::vector<PayloadView> &views) {
+	// Consecutive small NAL units are aggregated into APs if enabled
+	// See https://www.rfc-editor.org/rfc/rfc7798.html#section-4.4.2
+	PayloadView aggregate;
+	size_t aggregateCount = 0;
+	auto flush = [&]() {
+		if (aggregateCount == 1) {
+			// A single NAL unit is sent as is
+			PayloadView view;
+			view.parts[0] = {aggregate.parts[0].data, aggregate.parts[0].size};
+			views.push_back(view);
+		} else if (aggregateCount > 1) {
+			views.push_back(aggregate);
+		}
+		aggregate = PayloadView();
+		aggregateCount = 0;
+	};
+
+	for (const auto &nalu : splitFrame(data)) {
+		if (mAggregate && nalu.size >= H265_NAL_HEADER_SIZE) {
+			if (aggregateCount == PayloadView::MaxParts ||
+			    aggregate.size() + 2 + nalu.size > mMaxFragmentSize)
+				flush();
+
+			if (H265_NAL_HEADER_SIZE + 2 + nalu.size <= mMaxFragmentSize) {
+				// The F bit is set if any NAL unit has it, LayerId and TID are the lowest ones
+				const uint8_t first = uint8_t(nalu.data[0]), second = uint8_t(nalu.data[1]);
+				uint8_t f = first & 0x80;
+				uint8_t layerId = (first & 0x01) << 5 | second >> 3;
+				uint8_t tid = second & 0x07;
+				if (aggregateCount > 0) {
+					const uint8_t apFirst = uint8_t(aggregate.header[0]);
+					const uint8_t apSecond = uint8_t(aggregate.header[1]);
+					f |= apFirst & 0x80;
+					layerId = std::min(layerId, uint8_t((apFirst & 0x01) << 5 | apSecond >> 3));
+					tid = std::min(tid, uint8_t(apSecond & 0x07));
+				}
+				aggregate.header = {byte(f | 48 << 1 | layerId >> 5),
+				                    byte((layerId & 0x1F) << 3 | tid)};
+				aggregate.headerSize = H265_NAL_HEADER_SIZE;
+				aggregate.parts[aggregateCount++] = {nalu.data, nalu.size, true};
+				continue;
+			}
+		}
+		flush();
 
-std::vector<binary> H265RtpPacketizer::fragment(binary data) {
-	return H265NalUnit::GenerateFragments(splitFrame(data), mMaxFragmentSize);
+		if (nalu.size <= mMaxFragmentSize) {
+			PayloadView view;
+			view.parts[0] = nalu;
+			views.push_back(view);
+			continue;
+		}
+
+		// Fragmentation units of even size, as generated by H265NalUnit::generateFragments()
+		// See https://www.rfc-editor.org/rfc/rfc7798.html#section-4.4.3
+		const size_t count = (nalu.size + mMaxFragmentSize - 1) / mMaxFragmentSize;
+		const size_t fragmentSize =
+		    (nalu.size + count - 1) / count - (H265_NAL_HEADER_SIZE + H265_FU_HEADER_SIZE);
+		const uint8_t first = uint8_t(nalu.data[0]);
+		const uint8_t type = (first >> 1) & 0x3F;
+		const byte payloadHeader = byte((first & 0x81) | 49 << 1); // F, FU type, and layer ID
+		const byte *payload = nalu.data + H265_NAL_HEADER_SIZE;
+		const size_t payloadSize = nalu.size - H265_NAL_HEADER_SIZE;
+		for (size_t offset = 0; offset < payloadSize; offset += fragmentSize) {
+			const bool start = offset == 0;
+			const bool end = !start && offset + fragmentSize >= payloadSize;
+			PayloadView view;
+			view.header = {payloadHeader, nalu.data[1], byte(start << 7 | end << 6 | type)};
+			view.headerSize = H265_NAL_HEADER_SIZE + H265_FU_HEADER_SIZE;
+			view.parts[0] = {payload + offset, std::min(fragmentSize, payloadSize - offset)};
+			views.push_back(view);
+		}
+	}
+	flush();
+	return true;
 }
 
-std::vector<H265NalUnit> H265RtpPacketizer::splitFrame(const binary &frame) {
-	std::vector<H265NalUnit> nalus;
+std::vector<RtpPacketizer::PayloadView::Part>
+H265RtpPacketizer::splitFrame(const binary &frame) {
+	// NAL units are returned as views over the frame
+	std::vector<PayloadView::Part> nalus;
 	if (mSeparator == NalUnit::Separator::Length) {
 		size_t index = 0;
 		while (index < frame.size()) {
@@ -57,40 +134,26 @@ std::vector<H265NalUnit> H265RtpPacketizer::splitFrame(const binary &frame) {
 				LOG_WARNING << "Invalid NAL Unit data (incomplete unit), ignoring!";
 				break;
 			}
-			auto begin = frame.begin() + naluStartIndex;
-			auto end = frame.begin() + naluEndIndex;
-			nalus.emplace_back(begin, end);
+			nalus.push_back({frame.data() + naluStartIndex, length});
 			index = naluEndIndex;
 		}
 	} else {
-		NalUnitStartSequenceMatch match = NUSM_noMatch;
-		size_t index = 0;
-		while (index < frame.size()) {
-			match = NalUnit::StartSequenceMatchSucc(match, frame[index++], mSeparator);
-			if (match == NUSM_longMatch || match == NUSM_shortMatch) {
-				match = NUSM_noMatch;
-				break;
-			}
-		}
+		// Data before the first start sequence is skipped
+		size_t length = 0;
+		size_t index = NalUnit::FindStartSequence(frame.data(), frame.size(), mSeparator, length);
+		size_t naluStartIndex = index < frame.size() ? index + length : frame.size();
 
-		size_t naluStartIndex = index;
+		while (naluStartIndex < frame.size()) {
+			const size_t remaining = frame.size() - naluStartIndex;
+			const size_t naluLength = NalUnit::FindStartSequence(
+			    frame.data() + naluStartIndex, remaining, mSeparator, length);
+			if (naluLength == remaining)
+				break;
 
-		while (index < frame.size()) {
-			match = NalUnit::StartSequenceMatchSucc(match, frame[index], mSeparator);
-			if (match == NUSM_longMatch || match == NUSM_shortMatch) {
-				auto sequenceLength = match == NUSM_longMatch ? 4 : 3;
-				size_t naluEndIndex = index - sequenceLength;
-				match = NUSM_noMatch;
-				auto begin = frame.begin() + naluStartIndex;
-				auto end = frame.begin() + naluEndIndex + 1;
-				nalus.emplace_back(begin, end);
-				naluStartIndex = index + 1;
-			}
-			index++;
+			nalus.push_back({frame.data() + naluStartIndex, naluLength});
+			naluStartIndex += naluLength + length;
 		}
-		auto begin = frame.begin() + naluStartIndex;
-		auto end = frame.end();
-		nalus.emplace_back(begin, end);
+		nalus.push_back({frame.data() + naluStartIndex, frame.size() - naluStartIndex});
 	}
 	return nalus;
 }
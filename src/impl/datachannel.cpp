@@ -197,7 +197,7 @@ bool DataChannel::outgoing(message_ptr message) {
 			throw std::invalid_argument("Message size exceeds limit");
 
 		// Before the ACK has been received on a DataChannel, all messages must be sent ordered
-		message->reliability = mIsOpen ? mReliability : nullptr;
+		message->reliability = mIsOpen && !mIsAckPending ? mReliability : nullptr;
 		message->stream = mStream.value();
 	}
 
@@ -218,6 +218,7 @@ void DataChannel::incoming(message_ptr message) {
 			processOpenMessage(message);
 			break;
 		case MESSAGE_ACK:
+			mIsAckPending = false;
 			if (!mIsOpen.exchange(true)) {
 				triggerOpen();
 			}
@@ -255,6 +256,11 @@ void OutgoingDataChannel::open(shared_ptr<SctpTransport> transport) {
 	if (!mStream.has_value())
 		throw std::runtime_error("DataChannel has no stream assigned");
 
+	// The DATA_CHANNEL_OPEN message must be sent only once, even if the channel is opened both
+	// while the association is being established in fast-open mode and once it is established
+	if (mIsOpen || mIsAckPending.exchange(true))
+		return;
+
 	uint8_t channelType;
 	uint32_t reliabilityParameter;
 	if (mReliability->maxPacketLifeTime) {
@@ -307,6 +313,12 @@ void OutgoingDataChannel::open(shared_ptr<SctpTransport> transport) {
 	lock.unlock();
 
 	transport->send(make_message(buffer.begin(), buffer.end(), Message::Control, mStream.value()));
+
+	// RFC 8832 allows sending data right after the DATA_CHANNEL_OPEN message, so if fast-open is
+	// pre-negotiated, the channel is open immediately, and messages are sent ordered until the ACK
+	// is received. See https://www.rfc-editor.org/rfc/rfc8832.html#section-6
+	if (transport->isFastOpen() && !mIsClosed && !mIsOpen.exchange(true))
+		triggerOpen();
 }
 
 void OutgoingDataChannel::processOpenMessage(message_ptr) {
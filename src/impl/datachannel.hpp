@@ -66,6 +66,7 @@ protected:
 
 	std::atomic<bool> mIsOpen = false;
 	std::atomic<bool> mIsClosed = false;
+	std::atomic<bool> mIsAckPending = false; // open message sent, waiting for the ACK
 
 private:
 	Queue<message_ptr> mRecvQueue;
@@ -7,15 +7,24 @@
  */
 
 #include "dtlssrtptransport.hpp"
+#include "internals.hpp"
 #include "logcounter.hpp"
 #include "rtp.hpp"
+#include "rtpextensionmap.hpp"
 #include "tls.hpp"
 
 #if RTC_ENABLE_MEDIA
 
+#include <algorithm>
 #include <cstring>
 #include <exception>
 
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif
+
 using std::to_integer;
 using std::to_string;
 
@@ -40,6 +49,9 @@ static LogCounter
 static LogCounter
     COUNTER_SRTP_FAIL(plog::warning,
                       "Number of SRTP packets received that had an unknown libSRTP failure");
+static LogCounter
+    COUNTER_SRTP_STREAMS_LIMIT(plog::warning,
+                               "Number of SRTP/SRTCP packets dropped as too many streams were open");
 
 void DtlsSrtpTransport::Init() { srtp_init(); }
 
@@ -57,17 +69,30 @@ bool DtlsSrtpTransport::IsGcmSupported() {
 }
 
 DtlsSrtpTransport::DtlsSrtpTransport(shared_ptr<IceTransport> lower,
-                                     shared_ptr<Certificate> certificate, optional<size_t> mtu,
+                                     shared_ptr<Certificate> certificate,
+                                     const Configuration &config,
                                      CertificateFingerprint::Algorithm fingerprintAlgorithm,
                                      verifier_callback verifierCallback,
                                      message_callback srtpRecvCallback,
                                      state_callback stateChangeCallback)
-    : DtlsTransport(lower, certificate, mtu, fingerprintAlgorithm, std::move(verifierCallback),
+    : DtlsTransport(lower, certificate, config, fingerprintAlgorithm, std::move(verifierCallback),
                     std::move(stateChangeCallback)),
-      mSrtpRecvCallback(std::move(srtpRecvCallback)) { // distinct from Transport recv callback
+      mSrtpRecvCallback(std::move(srtpRecvCallback)), // distinct from Transport recv callback
+      mReplayWindowSize(config.srtpReplayWindowSize.value_or(DEFAULT_SRTP_REPLAY_WINDOW_SIZE)),
+      mMaxInboundStreams(config.srtpMaxInboundStreams), mStreamTimeout(config.srtpStreamTimeout) {
 
 	PLOG_DEBUG << "Initializing DTLS-SRTP transport";
 
+	// libSRTP accepts replay windows from 64 to 0x8000 packets
+	if (mReplayWindowSize < 64 || mReplayWindowSize > 0x8000)
+		throw std::invalid_argument("Invalid SRTP replay window size");
+
+	if (mMaxInboundStreams && *mMaxInboundStreams == 0)
+		throw std::invalid_argument("Invalid SRTP max inbound streams count");
+
+	if (mStreamTimeout && mStreamTimeout->count() <= 0)
+		throw std::invalid_argument("Invalid SRTP stream timeout");
+
 	if (srtp_err_status_t err = srtp_create(&mSrtpIn, nullptr)) {
 		throw std::runtime_error("srtp_create failed, status=" + to_string(static_cast<int>(err)));
 	}
@@ -84,7 +109,7 @@ DtlsSrtpTransport::~DtlsSrtpTransport() {
 	srtp_dealloc(mSrtpOut);
 }
 
-bool DtlsSrtpTransport::sendMedia(message_ptr message) {
+bool DtlsSrtpTransport::sendMedia(message_ptr message, uint8_t transportSequenceNumberId) {
 	std::lock_guard lock(sendMutex);
 	if (!message)
 		return false;
@@ -102,6 +127,7 @@ bool DtlsSrtpTransport::sendMedia(message_ptr message) {
 	// Copy instead of resizing so we don't interfere with media handlers keeping references
 	message = make_message(size + SRTP_MAX_TRAILER_LEN, message);
 
+	uint32_t ssrc;
 	if (IsRtcp(*message)) { // Demultiplex RTCP and RTP using payload type
 		if (srtp_err_status_t err = srtp_protect_rtcp(mSrtpOut, message->data(), &size)) {
 			if (err == srtp_err_status_replay_fail)
@@ -111,8 +137,22 @@ bool DtlsSrtpTransport::sendMedia(message_ptr message) {
 				                         to_string(static_cast<int>(err)));
 		}
 		PLOG_VERBOSE << "Protected SRTCP packet, size=" << size;
+		ssrc = reinterpret_cast<RtcpSr *>(message->data())->senderSSRC();
 
 	} else {
+		// The transport-wide sequence number is shared by all tracks, and retransmissions get a
+		// new one as they are sent again
+		size_t length = 0;
+		auto rtp = reinterpret_cast<RtpHeader *>(message->data());
+		if (auto element =
+		        RtpExtensionMap::Find(rtp, size_t(size), transportSequenceNumberId, length);
+		    element && length == 2) {
+			auto value = message->data() + (element - message->data());
+			value[0] = byte(mTransportSequenceNumber >> 8);
+			value[1] = byte(mTransportSequenceNumber & 0xFF);
+			++mTransportSequenceNumber;
+		}
+
 		if (srtp_err_status_t err = srtp_protect(mSrtpOut, message->data(), &size)) {
 			if (err == srtp_err_status_replay_fail)
 				throw std::runtime_error("Outgoing SRTP packet is a replay");
@@ -121,10 +161,14 @@ bool DtlsSrtpTransport::sendMedia(message_ptr message) {
 				                         to_string(static_cast<int>(err)));
 		}
 		PLOG_VERBOSE << "Protected SRTP packet, size=" << size;
+		ssrc = reinterpret_cast<RtpHeader *>(message->data())->ssrc();
 	}
 
 	message->resize(size);
 
+	if (mOutboundStreams.insert(ssrc).second)
+		mOutboundStreamsCount = mOutboundStreams.size();
+
 	if (message->dscp == 0) { // Track might override the value
 		// Set recommended medium-priority DSCP value
 		// See https://www.rfc-editor.org/rfc/rfc8837.html#section-5
@@ -148,7 +192,19 @@ void DtlsSrtpTransport::recvMedia(message_ptr message) {
 	PLOG_VERBOSE << "Demultiplexing SRTCP and SRTP with RTP payload type, value="
 	             << unsigned(value2);
 
-	if (IsRtcp(*message)) { // Demultiplex RTCP and RTP using payload type
+	// libSRTP shares the stream context of an SSRC between RTP and RTCP
+	const bool isRtcp = IsRtcp(*message); // Demultiplex RTCP and RTP using payload type
+	if (isRtcp || size >= int(sizeof(RtpHeader))) {
+		uint32_t ssrc = isRtcp ? reinterpret_cast<RtcpSr *>(message->data())->senderSSRC()
+		                       : reinterpret_cast<RtpHeader *>(message->data())->ssrc();
+		if (!acceptInboundStream(ssrc)) {
+			COUNTER_SRTP_STREAMS_LIMIT++;
+			PLOG_VERBOSE << "Incoming SRTP/SRTCP packet dropped, too many streams, SSRC=" << ssrc;
+			return;
+		}
+	}
+
+	if (isRtcp) {
 		PLOG_VERBOSE << "Incoming SRTCP packet, size=" << size;
 		if (srtp_err_status_t err = srtp_unprotect_rtcp(mSrtpIn, message->data(), &size)) {
 			if (err == srtp_err_status_replay_fail) {
@@ -189,9 +245,75 @@ void DtlsSrtpTransport::recvMedia(message_ptr message) {
 	}
 
 	message->resize(size);
+	touchInboundStream(uint32_t(message->stream));
 	mSrtpRecvCallback(message);
 }
 
+bool DtlsSrtpTransport::acceptInboundStream(uint32_t ssrc) {
+	// Called on recv only, before libSRTP clones the inbound template for a new SSRC
+	if (!mMaxInboundStreams || mInboundStreams.size() < *mMaxInboundStreams ||
+	    mInboundStreams.find(ssrc) != mInboundStreams.end())
+		return true;
+
+	// Active streams are never evicted to make room, as libSRTP would then clone them again with
+	// a reset rollover counter and replay window, so only timed out streams may be replaced
+	sweepInboundStreams(clock::now());
+	return mInboundStreams.size() < *mMaxInboundStreams;
+}
+
+void DtlsSrtpTransport::touchInboundStream(uint32_t ssrc) {
+	// Called on recv only
+	const auto now = clock::now();
+	if (auto it = mInboundStreams.find(ssrc); it != mInboundStreams.end()) {
+		// Move the stream to the back to keep the list in least recently used order
+		it->second->lastUsed = now;
+		mInboundStreamsLru.splice(mInboundStreamsLru.end(), mInboundStreamsLru, it->second);
+	} else {
+		mInboundStreamsLru.push_back(InboundStream{ssrc, now});
+		mInboundStreams.emplace(ssrc, std::prev(mInboundStreamsLru.end()));
+	}
+
+	if (now >= mNextStreamsSweep)
+		sweepInboundStreams(now);
+
+	mInboundStreamsCount = mInboundStreams.size();
+}
+
+void DtlsSrtpTransport::sweepInboundStreams(clock::time_point now) {
+	// Called on recv only
+	if (!mStreamTimeout)
+		return;
+
+	// Streams are in least recently used order, so only timed out ones are visited
+	while (!mInboundStreamsLru.empty() &&
+	       now - mInboundStreamsLru.front().lastUsed > *mStreamTimeout) {
+		const uint32_t ssrc = mInboundStreamsLru.front().ssrc;
+		evictInboundStream(ssrc);
+		mInboundStreams.erase(ssrc);
+		mInboundStreamsLru.pop_front();
+	}
+
+	mNextStreamsSweep = now + *mStreamTimeout / 2;
+	mInboundStreamsCount = mInboundStreams.size();
+}
+
+void DtlsSrtpTransport::evictInboundStream(uint32_t ssrc) {
+	PLOG_DEBUG << "Evicting SRTP inbound stream, SSRC=" << ssrc;
+
+	// libSRTP expects the SSRC in network byte order
+	if (srtp_err_status_t err = srtp_remove_stream(mSrtpIn, htonl(ssrc)))
+		PLOG_WARNING << "SRTP remove stream failed, status=" << err;
+}
+
+size_t DtlsSrtpTransport::srtpStreamsCount() const {
+	return mInboundStreamsCount + mOutboundStreamsCount;
+}
+
+size_t DtlsSrtpTransport::srtpMemoryUsage() const {
+	// Each stream context holds a replay bitmap of the window size
+	return srtpStreamsCount() * (SRTP_STREAM_CONTEXT_SIZE + mReplayWindowSize / 8);
+}
+
 bool DtlsSrtpTransport::demuxMessage(message_ptr message) {
 	if (!mInitDone) {
 		// Bypass
@@ -333,33 +455,18 @@ void DtlsSrtpTransport::postHandshake() {
 	std::memcpy(mServerSessionKey.data(), serverKey, keySize);
 	std::memcpy(mServerSessionKey.data() + keySize, serverSalt, saltSize);
 
-	srtp_policy_t inbound = {};
-	if (srtp_crypto_policy_set_from_profile_for_rtp(&inbound.rtp, srtpProfile))
-		throw std::runtime_error("SRTP profile is not supported");
-	if (srtp_crypto_policy_set_from_profile_for_rtcp(&inbound.rtcp, srtpProfile))
-		throw std::runtime_error("SRTP profile is not supported");
-
-	inbound.ssrc.type = ssrc_any_inbound;
-	inbound.key = mIsClient ? mServerSessionKey.data() : mClientSessionKey.data();
-	inbound.window_size = 1024;
-	inbound.allow_repeat_tx = true;
-	inbound.next = nullptr;
+	// libSRTP clones the templates into a stream context for each SSRC
+	srtp_policy_t inbound = makeStreamTemplate(
+	    srtpProfile, ssrc_any_inbound,
+	    mIsClient ? mServerSessionKey.data() : mClientSessionKey.data());
 
 	if (srtp_err_status_t err = srtp_add_stream(mSrtpIn, &inbound))
 		throw std::runtime_error("SRTP add inbound stream failed, status=" +
 		                         to_string(static_cast<int>(err)));
 
-	srtp_policy_t outbound = {};
-	if (srtp_crypto_policy_set_from_profile_for_rtp(&outbound.rtp, srtpProfile))
-		throw std::runtime_error("SRTP profile is not supported");
-	if (srtp_crypto_policy_set_from_profile_for_rtcp(&outbound.rtcp, srtpProfile))
-		throw std::runtime_error("SRTP profile is not supported");
-
-	outbound.ssrc.type = ssrc_any_outbound;
-	outbound.key = mIsClient ? mClientSessionKey.data() : mServerSessionKey.data();
-	outbound.window_size = 1024;
-	outbound.allow_repeat_tx = true;
-	outbound.next = nullptr;
+	srtp_policy_t outbound = makeStreamTemplate(
+	    srtpProfile, ssrc_any_outbound,
+	    mIsClient ? mClientSessionKey.data() : mServerSessionKey.data());
 
 	if (srtp_err_status_t err = srtp_add_stream(mSrtpOut, &outbound))
 		throw std::runtime_error("SRTP add outbound stream failed, status=" +
@@ -368,6 +475,22 @@ void DtlsSrtpTransport::postHandshake() {
 	mInitDone = true;
 }
 
+srtp_policy_t DtlsSrtpTransport::makeStreamTemplate(srtp_profile_t profile, srtp_ssrc_type_t type,
+                                                    unsigned char *key) const {
+	srtp_policy_t policy = {};
+	if (srtp_crypto_policy_set_from_profile_for_rtp(&policy.rtp, profile))
+		throw std::runtime_error("SRTP profile is not supported");
+	if (srtp_crypto_policy_set_from_profile_for_rtcp(&policy.rtcp, profile))
+		throw std::runtime_error("SRTP profile is not supported");
+
+	policy.ssrc.type = type;
+	policy.key = key;
+	policy.window_size = mReplayWindowSize;
+	policy.allow_repeat_tx = true;
+	policy.next = nullptr;
+	return policy;
+}
+
 #if !USE_GNUTLS && !USE_MBEDTLS
 DtlsSrtpTransport::ProfileParams DtlsSrtpTransport::getProfileParamsFromName(string_view name) {
 	if (name == "SRTP_AES128_CM_SHA1_80")
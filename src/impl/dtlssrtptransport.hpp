@@ -21,6 +21,10 @@
 #endif
 
 #include <atomic>
+#include <chrono>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace rtc::impl {
 
@@ -31,15 +35,30 @@ public:
 	static bool IsGcmSupported();
 
 	DtlsSrtpTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
-	                  optional<size_t> mtu, CertificateFingerprint::Algorithm fingerprintAlgorithm,
+	                  const Configuration &config,
+	                  CertificateFingerprint::Algorithm fingerprintAlgorithm,
 	                  verifier_callback verifierCallback, message_callback srtpRecvCallback,
 	                  state_callback stateChangeCallback);
 	~DtlsSrtpTransport();
 
-	bool sendMedia(message_ptr message);
+	// If transportSequenceNumberId is not 0, the transport-wide sequence number element with this
+	// ID is written in RTP packets, so packets of all tracks are numbered in sending order
+	bool sendMedia(message_ptr message, uint8_t transportSequenceNumberId = 0);
+
+	// Stats
+	size_t srtpStreamsCount() const;
+	size_t srtpMemoryUsage() const; // approximate size of SRTP stream contexts
 
 private:
+	using clock = std::chrono::steady_clock;
+
 	void recvMedia(message_ptr message);
+	bool acceptInboundStream(uint32_t ssrc);
+	void touchInboundStream(uint32_t ssrc);
+	void sweepInboundStreams(clock::time_point now);
+	void evictInboundStream(uint32_t ssrc);
+	srtp_policy_t makeStreamTemplate(srtp_profile_t profile, srtp_ssrc_type_t type,
+	                                 unsigned char *key) const;
 	bool demuxMessage(message_ptr message) override;
 	void postHandshake() override;
 
@@ -55,9 +74,24 @@ private:
 
 	message_callback mSrtpRecvCallback;
 	srtp_t mSrtpIn, mSrtpOut;
+
+	// SSRC contexts cloned by libSRTP from the stream templates
+	const size_t mReplayWindowSize;
+	const optional<size_t> mMaxInboundStreams;
+	const optional<clock::duration> mStreamTimeout;
+	struct InboundStream {
+		uint32_t ssrc;
+		clock::time_point lastUsed;
+	};
+	std::list<InboundStream> mInboundStreamsLru; // least recently used first
+	std::unordered_map<uint32_t, std::list<InboundStream>::iterator> mInboundStreams; // recv only
+	std::unordered_set<uint32_t> mOutboundStreams; // accessed under sendMutex
+	std::atomic<size_t> mInboundStreamsCount = 0, mOutboundStreamsCount = 0;
+	clock::time_point mNextStreamsSweep;
 	std::atomic<bool> mInitDone = false;
 	std::vector<unsigned char> mClientSessionKey;
 	std::vector<unsigned char> mServerSessionKey;
+	uint16_t mTransportSequenceNumber = 0; // accessed under sendMutex
 	std::mutex sendMutex;
 };
 
@@ -39,6 +39,26 @@ void DtlsTransport::enqueueRecv() {
 	}
 }
 
+byte *DtlsTransport::recvBuffer(size_t size) {
+	// Called with mRecvMutex locked
+	if (!mRecvBuffer)
+		mRecvBuffer = make_message(size);
+	else
+		mRecvBuffer->resize(size);
+
+	return mRecvBuffer->data();
+}
+
+void DtlsTransport::recvDecrypted(size_t size) {
+	// Called with mRecvMutex locked
+	mRecvBuffer->resize(size);
+	recv(mRecvBuffer);
+
+	// Reuse the buffer for the next record unless a layer above kept a reference to it
+	if (mRecvBuffer.use_count() > 1)
+		mRecvBuffer.reset();
+}
+
 #if USE_GNUTLS
 
 void DtlsTransport::Init() {
@@ -47,11 +67,16 @@ void DtlsTransport::Init() {
 
 void DtlsTransport::Cleanup() { gnutls_global_deinit(); }
 
+bool DtlsTransport::IsDtls13Supported() { return false; }
+
+bool DtlsTransport::IsConnectionIdSupported() { return false; }
+
 DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
-                             optional<size_t> mtu,
+                             const Configuration &config,
                              CertificateFingerprint::Algorithm fingerprintAlgorithm,
                              verifier_callback verifierCallback, state_callback stateChangeCallback)
-    : Transport(lower, std::move(stateChangeCallback)), mMtu(mtu), mCertificate(certificate),
+    : Transport(lower, std::move(stateChangeCallback)), mIceTransport(lower), mMtu(config.mtu),
+      mCertificate(certificate),
       mFingerprintAlgorithm(fingerprintAlgorithm), mVerifierCallback(std::move(verifierCallback)),
       mIsClient(lower->role() == Description::Role::Active),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
@@ -61,6 +86,12 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 	if (!mCertificate)
 		throw std::invalid_argument("DTLS certificate is null");
 
+	if (config.enableDtls13)
+		throw std::invalid_argument("DTLS 1.3 is not supported with GnuTLS");
+
+	if (config.enableDtlsConnectionId)
+		throw std::invalid_argument("DTLS Connection ID is not supported with GnuTLS");
+
 	gnutls_certificate_credentials_t creds = mCertificate->credentials();
 	gnutls_certificate_set_verify_function(creds, CertificateCallback);
 
@@ -172,6 +203,13 @@ bool DtlsTransport::outgoing(message_ptr message) {
 	return result;
 }
 
+bool DtlsTransport::outgoing(const byte *data, size_t size) {
+	// Records are handed to the ICE transport without copying them into a message first
+	bool result = mIceTransport->send(data, size, mCurrentDscp);
+	mOutgoingResult = result;
+	return result;
+}
+
 bool DtlsTransport::demuxMessage(message_ptr) {
 	// Dummy
 	return false;
@@ -190,7 +228,6 @@ void DtlsTransport::doRecv() {
 
 	try {
 		const size_t bufferSize = 4096;
-		char buffer[bufferSize];
 
 		// Handle handshake if connecting
 		if (state() == State::Connecting) {
@@ -225,7 +262,7 @@ void DtlsTransport::doRecv() {
 
 		if (state() == State::Connected) {
 			while (true) {
-				ssize_t ret = gnutls_record_recv(mSession, buffer, bufferSize);
+				ssize_t ret = gnutls_record_recv(mSession, recvBuffer(bufferSize), bufferSize);
 
 				if (ret == GNUTLS_E_AGAIN) {
 					return;
@@ -255,8 +292,7 @@ void DtlsTransport::doRecv() {
 						PLOG_DEBUG << "DTLS connection cleanly closed";
 						break;
 					}
-					auto *b = reinterpret_cast<byte *>(buffer);
-					recv(make_message(b, b + ret));
+					recvDecrypted(size_t(ret));
 				}
 			}
 		}
@@ -312,10 +348,8 @@ int DtlsTransport::CertificateCallback(gnutls_session_t session) {
 ssize_t DtlsTransport::WriteCallback(gnutls_transport_ptr_t ptr, const void *data, size_t len) {
 	DtlsTransport *t = static_cast<DtlsTransport *>(ptr);
 	try {
-		if (len > 0) {
-			auto b = reinterpret_cast<const byte *>(data);
-			t->outgoing(make_message(b, b + len));
-		}
+		if (len > 0)
+			t->outgoing(reinterpret_cast<const byte *>(data), len);
 		gnutls_transport_set_errno(t->mSession, 0);
 		return ssize_t(len);
 
@@ -376,10 +410,11 @@ const mbedtls_ssl_srtp_profile srtpSupportedProtectionProfiles[] = {
 };
 
 DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
-                             optional<size_t> mtu,
+                             const Configuration &config,
                              CertificateFingerprint::Algorithm fingerprintAlgorithm,
                              verifier_callback verifierCallback, state_callback stateChangeCallback)
-    : Transport(lower, std::move(stateChangeCallback)), mMtu(mtu), mCertificate(certificate),
+    : Transport(lower, std::move(stateChangeCallback)), mIceTransport(lower), mMtu(config.mtu),
+      mCertificate(certificate),
       mFingerprintAlgorithm(fingerprintAlgorithm), mVerifierCallback(std::move(verifierCallback)),
       mIsClient(lower->role() == Description::Role::Active),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
@@ -389,6 +424,12 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 	if (!mCertificate)
 		throw std::invalid_argument("DTLS certificate is null");
 
+	if (config.enableDtls13)
+		throw std::invalid_argument("DTLS 1.3 is not supported with Mbed TLS");
+
+	if (config.enableDtlsConnectionId && !IsConnectionIdSupported())
+		throw std::invalid_argument("DTLS Connection ID is not enabled in Mbed TLS");
+
 	mbedtls_entropy_init(&mEntropy);
 	mbedtls_ctr_drbg_init(&mDrbg);
 	mbedtls_ssl_init(&mSsl);
@@ -413,8 +454,25 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 		mbedtls_ssl_conf_dtls_cookies(&mConf, NULL, NULL, NULL);
 		mbedtls_ssl_conf_dtls_srtp_protection_profiles(&mConf, srtpSupportedProtectionProfiles);
 
+#ifdef MBEDTLS_SSL_DTLS_CONNECTION_ID
+		if (config.enableDtlsConnectionId)
+			mbedtls::check(mbedtls_ssl_conf_cid(&mConf, DTLS_CONNECTION_ID_LENGTH,
+			                                    MBEDTLS_SSL_UNEXPECTED_CID_IGNORE));
+#endif
+
 		mbedtls::check(mbedtls_ssl_setup(&mSsl, &mConf));
 
+#ifdef MBEDTLS_SSL_DTLS_CONNECTION_ID
+		// RFC 9146: The peer includes our Connection ID in its records, so they can still be
+		// associated with the connection after a NAT rebinding
+		if (config.enableDtlsConnectionId) {
+			unsigned char cid[DTLS_CONNECTION_ID_LENGTH];
+			mbedtls::check(mbedtls_ctr_drbg_random(&mDrbg, cid, DTLS_CONNECTION_ID_LENGTH));
+			mbedtls::check(mbedtls_ssl_set_cid(&mSsl, MBEDTLS_SSL_CID_ENABLED, cid,
+			                                   DTLS_CONNECTION_ID_LENGTH));
+		}
+#endif
+
 		mbedtls_ssl_set_export_keys_cb(&mSsl, DtlsTransport::ExportKeysCallback, this);
 		mbedtls_ssl_set_bio(&mSsl, this, WriteCallback, ReadCallback, NULL);
 		mbedtls_ssl_set_timer_cb(&mSsl, this, SetTimerCallback, GetTimerCallback);
@@ -450,6 +508,16 @@ void DtlsTransport::Cleanup() {
 	// Nothing to do
 }
 
+bool DtlsTransport::IsDtls13Supported() { return false; }
+
+bool DtlsTransport::IsConnectionIdSupported() {
+#ifdef MBEDTLS_SSL_DTLS_CONNECTION_ID
+	return true;
+#else
+	return false;
+#endif
+}
+
 void DtlsTransport::start() {
 	PLOG_DEBUG << "Starting DTLS transport";
 	registerIncoming();
@@ -511,6 +579,13 @@ bool DtlsTransport::outgoing(message_ptr message) {
 	return result;
 }
 
+bool DtlsTransport::outgoing(const byte *data, size_t size) {
+	// Records are handed to the ICE transport without copying them into a message first
+	bool result = mIceTransport->send(data, size, mCurrentDscp);
+	mOutgoingResult = result;
+	return result;
+}
+
 bool DtlsTransport::demuxMessage(message_ptr) {
 	// Dummy
 	return false;
@@ -529,7 +604,6 @@ void DtlsTransport::doRecv() {
 
 	try {
 		const size_t bufferSize = 4096;
-		char buffer[bufferSize];
 
 		// Handle handshake if connecting
 		if (state() == State::Connecting) {
@@ -570,8 +644,9 @@ void DtlsTransport::doRecv() {
 				int ret;
 				{
 					std::lock_guard lock(mSslMutex);
-					ret = mbedtls_ssl_read(&mSsl, reinterpret_cast<unsigned char *>(buffer),
-					                       bufferSize);
+					ret = mbedtls_ssl_read(
+					    &mSsl, reinterpret_cast<unsigned char *>(recvBuffer(bufferSize)),
+					    bufferSize);
 				}
 
 				if (ret == MBEDTLS_ERR_SSL_WANT_READ) {
@@ -588,8 +663,7 @@ void DtlsTransport::doRecv() {
 						PLOG_DEBUG << "DTLS connection terminated";
 						break;
 					}
-					auto *b = reinterpret_cast<byte *>(buffer);
-					recv(make_message(b, b + ret));
+					recvDecrypted(size_t(ret));
 				}
 			}
 		}
@@ -631,10 +705,8 @@ void DtlsTransport::ExportKeysCallback(void *ctx, mbedtls_ssl_key_export_type /*
 int DtlsTransport::WriteCallback(void *ctx, const unsigned char *buf, size_t len) {
 	auto *t = static_cast<DtlsTransport *>(ctx);
 	try {
-		if (len > 0) {
-			auto b = reinterpret_cast<const byte *>(buf);
-			t->outgoing(make_message(b, b + len));
-		}
+		if (len > 0)
+			t->outgoing(reinterpret_cast<const byte *>(buf), len);
 		return int(len);
 
 	} catch (const std::exception &e) {
@@ -658,7 +730,7 @@ int DtlsTransport::ReadCallback(void *ctx, unsigned char *buf, size_t len) {
 
 			auto bufMin = std::min(len, size_t(message->size()));
 			std::memcpy(buf, message->data(), bufMin);
-			return int(len);
+			return int(bufMin);
 		}
 
 		// Closed
@@ -708,12 +780,13 @@ void DtlsTransport::Init() {
 	openssl::init();
 
 	if (!BioMethods) {
-		BioMethods = BIO_meth_new(BIO_TYPE_BIO, "DTLS writer");
+		BioMethods = BIO_meth_new(BIO_TYPE_BIO, "DTLS datagram");
 		if (!BioMethods)
-			throw std::runtime_error("Failed to create BIO methods for DTLS writer");
+			throw std::runtime_error("Failed to create BIO methods for DTLS datagrams");
 		BIO_meth_set_create(BioMethods, BioMethodNew);
 		BIO_meth_set_destroy(BioMethods, BioMethodFree);
 		BIO_meth_set_write(BioMethods, BioMethodWrite);
+		BIO_meth_set_read(BioMethods, BioMethodRead);
 		BIO_meth_set_ctrl(BioMethods, BioMethodCtrl);
 	}
 	if (TransportExIndex < 0) {
@@ -725,11 +798,22 @@ void DtlsTransport::Cleanup() {
 	// Nothing to do
 }
 
+bool DtlsTransport::IsDtls13Supported() {
+#ifdef DTLS1_3_VERSION
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool DtlsTransport::IsConnectionIdSupported() { return false; }
+
 DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
-                             optional<size_t> mtu,
+                             const Configuration &config,
                              CertificateFingerprint::Algorithm fingerprintAlgorithm,
                              verifier_callback verifierCallback, state_callback stateChangeCallback)
-    : Transport(lower, std::move(stateChangeCallback)), mMtu(mtu), mCertificate(certificate),
+    : Transport(lower, std::move(stateChangeCallback)), mIceTransport(lower), mMtu(config.mtu),
+      mCertificate(certificate),
       mFingerprintAlgorithm(fingerprintAlgorithm), mVerifierCallback(std::move(verifierCallback)),
       mIsClient(lower->role() == Description::Role::Active),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
@@ -739,6 +823,12 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 	if (!mCertificate)
 		throw std::invalid_argument("DTLS certificate is null");
 
+	if (config.enableDtls13 && !IsDtls13Supported())
+		throw std::invalid_argument("DTLS 1.3 is not supported by this OpenSSL version");
+
+	if (config.enableDtlsConnectionId)
+		throw std::invalid_argument("DTLS Connection ID is not supported with OpenSSL");
+
 	try {
 		mCtx = SSL_CTX_new(DTLS_method());
 		if (!mCtx)
@@ -753,6 +843,11 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 		                              SSL_OP_NO_RENEGOTIATION);
 
 		SSL_CTX_set_min_proto_version(mCtx, DTLS1_VERSION);
+#ifdef DTLS1_3_VERSION
+		// RFC 9147: DTLS 1.3 saves a round trip on connection setup, it must be explicitly enabled
+		SSL_CTX_set_max_proto_version(mCtx,
+		                              config.enableDtls13 ? DTLS1_3_VERSION : DTLS1_2_VERSION);
+#endif
 		SSL_CTX_set_read_ahead(mCtx, 1);
 		SSL_CTX_set_quiet_shutdown(mCtx, 0); // send the close_notify alert
 		SSL_CTX_set_info_callback(mCtx, InfoCallback);
@@ -788,12 +883,14 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 		else
 			SSL_set_accept_state(mSsl);
 
-		mInBio = BIO_new(BIO_s_mem());
+		// Both BIOs are backed by the transport: incoming datagrams are read in place from the
+		// queued messages and outgoing records are handed directly to the ICE transport
+		mInBio = BIO_new(BioMethods);
 		mOutBio = BIO_new(BioMethods);
 		if (!mInBio || !mOutBio)
 			throw std::runtime_error("Failed to create BIO");
 
-		BIO_set_mem_eof_return(mInBio, BIO_EOF);
+		BIO_set_data(mInBio, this);
 		BIO_set_data(mOutBio, this);
 		SSL_set_bio(mSsl, mInBio, mOutBio);
 
@@ -906,6 +1003,13 @@ bool DtlsTransport::outgoing(message_ptr message) {
 	return result;
 }
 
+bool DtlsTransport::outgoing(const byte *data, size_t size) {
+	// Records are handed to the ICE transport without copying them into a message first
+	bool result = mIceTransport->send(data, size, mCurrentDscp);
+	mOutgoingResult = result;
+	return result;
+}
+
 bool DtlsTransport::demuxMessage(message_ptr) {
 	// Dummy
 	return false;
@@ -924,7 +1028,6 @@ void DtlsTransport::doRecv() {
 
 	try {
 		const size_t bufferSize = 4096;
-		byte buffer[bufferSize];
 
 		// Process pending messages
 		while (mIncomingQueue.running()) {
@@ -941,7 +1044,11 @@ void DtlsTransport::doRecv() {
 			if (demuxMessage(message))
 				continue;
 
-			BIO_write(mInBio, message->data(), int(message->size()));
+			{
+				std::lock_guard lock(mSslMutex);
+				mIncomingMessage = std::move(message);
+				mIncomingOffset = 0;
+			}
 
 			if (state() == State::Connecting) {
 				// Continue the handshake
@@ -967,25 +1074,34 @@ void DtlsTransport::doRecv() {
 			}
 
 			if (state() == State::Connected) {
-				int ret, err;
-				{
-					std::lock_guard lock(mSslMutex);
-					ret = SSL_read(mSsl, buffer, bufferSize);
-					err = SSL_get_error(mSsl, ret);
+				// Read every record of the datagram as it is only exposed until the next one
+				int err;
+				while (true) {
+					int ret;
+					{
+						std::lock_guard lock(mSslMutex);
+						ret = SSL_read(mSsl, recvBuffer(bufferSize), bufferSize);
+						err = SSL_get_error(mSsl, ret);
+					}
+
+					if (err == SSL_ERROR_ZERO_RETURN || !openssl::check_error(err))
+						break;
+
+					recvDecrypted(size_t(ret));
 				}
 
 				if (err == SSL_ERROR_ZERO_RETURN) {
 					PLOG_DEBUG << "TLS connection cleanly closed";
 					break;
 				}
-
-				if (openssl::check_error(err))
-					recv(make_message(buffer, buffer + ret));
 			}
+
+			releaseIncoming(); // the datagram is consumed
 		}
 
 		std::lock_guard lock(mSslMutex);
 		SSL_shutdown(mSsl);
+		mIncomingMessage.reset();
 
 	} catch (const std::exception &e) {
 		PLOG_ERROR << "DTLS recv: " << e.what();
@@ -1001,6 +1117,12 @@ void DtlsTransport::doRecv() {
 	}
 }
 
+void DtlsTransport::releaseIncoming() {
+	std::lock_guard lock(mSslMutex);
+	mIncomingMessage.reset();
+	mIncomingOffset = 0;
+}
+
 void DtlsTransport::handleTimeout() {
 	std::lock_guard lock(mSslMutex);
 
@@ -1074,11 +1196,31 @@ int DtlsTransport::BioMethodWrite(BIO *bio, const char *in, int inl) {
 	auto transport = reinterpret_cast<DtlsTransport *>(BIO_get_data(bio));
 	if (!transport)
 		return -1;
-	auto b = reinterpret_cast<const byte *>(in);
-	transport->outgoing(make_message(b, b + inl));
+	transport->outgoing(reinterpret_cast<const byte *>(in), size_t(inl));
 	return inl; // can't fail
 }
 
+int DtlsTransport::BioMethodRead(BIO *bio, char *out, int outl) {
+	BIO_clear_retry_flags(bio);
+	if (outl <= 0)
+		return 0;
+	auto transport = reinterpret_cast<DtlsTransport *>(BIO_get_data(bio));
+	if (!transport)
+		return -1;
+
+	// Called with mSslMutex locked
+	const auto &message = transport->mIncomingMessage;
+	if (!message || transport->mIncomingOffset >= message->size()) {
+		BIO_set_retry_read(bio);
+		return -1;
+	}
+
+	size_t len = std::min(size_t(outl), message->size() - transport->mIncomingOffset);
+	std::memcpy(out, message->data() + transport->mIncomingOffset, len);
+	transport->mIncomingOffset += len;
+	return int(len);
+}
+
 long DtlsTransport::BioMethodCtrl(BIO * /*bio*/, int cmd, long /*num*/, void * /*ptr*/) {
 	switch (cmd) {
 	case BIO_CTRL_FLUSH:
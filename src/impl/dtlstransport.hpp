@@ -11,6 +11,7 @@
 
 #include "certificate.hpp"
 #include "common.hpp"
+#include "configuration.hpp"
 #include "queue.hpp"
 #include "tls.hpp"
 #include "transport.hpp"
@@ -29,9 +30,14 @@ public:
 	static void Init();
 	static void Cleanup();
 
+	// Optional protocol features, depending on the TLS backend and its build options
+	static bool IsDtls13Supported();
+	static bool IsConnectionIdSupported();
+
 	using verifier_callback = std::function<bool(const std::string &fingerprint)>;
 
-	DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate, optional<size_t> mtu,
+	DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
+	              const Configuration &config,
 	              CertificateFingerprint::Algorithm fingerprintAlgorithm,
 	              verifier_callback verifierCallback, state_callback stateChangeCallback);
 	~DtlsTransport();
@@ -48,9 +54,14 @@ protected:
 	virtual bool demuxMessage(message_ptr message);
 	virtual void postHandshake();
 
+	bool outgoing(const byte *data, size_t size); // send a record straight to the ICE transport
+
 	void enqueueRecv();
+	byte *recvBuffer(size_t size);
+	void recvDecrypted(size_t size);
 	void doRecv();
 
+	const shared_ptr<IceTransport> mIceTransport;
 	const optional<size_t> mMtu;
 	const certificate_ptr mCertificate;
 	CertificateFingerprint::Algorithm mFingerprintAlgorithm;
@@ -60,6 +71,7 @@ protected:
 	Queue<message_ptr> mIncomingQueue;
 	std::atomic<int> mPendingRecvCount = 0;
 	std::mutex mRecvMutex;
+	message_ptr mRecvBuffer; // decryption buffer under mRecvMutex, pooled across records
 	std::atomic<unsigned int> mCurrentDscp = 0;
 	std::atomic<bool> mOutgoingResult = true;
 
@@ -104,7 +116,11 @@ protected:
 	BIO *mInBio, *mOutBio;
 	std::mutex mSslMutex;
 
+	message_ptr mIncomingMessage; // datagram currently exposed to OpenSSL through mInBio
+	size_t mIncomingOffset = 0;
+
 	void handleTimeout();
+	void releaseIncoming();
 
 	static BIO_METHOD *BioMethods;
 	static int TransportExIndex;
@@ -116,6 +132,7 @@ protected:
 	static int BioMethodNew(BIO *bio);
 	static int BioMethodFree(BIO *bio);
 	static int BioMethodWrite(BIO *bio, const char *in, int inl);
+	static int BioMethodRead(BIO *bio, char *out, int outl);
 	static long BioMethodCtrl(BIO *bio, int cmd, long num, void *ptr);
 #endif
 };
@@ -7,8 +7,10 @@
  */
 
 #include "http.hpp"
+#include "utils.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 namespace rtc::impl {
 
@@ -63,4 +65,200 @@ std::multimap<string, string> parseHttpHeaders(const std::list<string> &lines) {
 	return headers;
 }
 
+namespace {
+
+// RFC 9110 5.6.2. Tokens
+// See https://www.rfc-editor.org/rfc/rfc9110.html#section-5.6.2
+struct TokenCharTable {
+	bool values[256] = {};
+
+	constexpr TokenCharTable() {
+		for (int c = '0'; c <= '9'; ++c)
+			values[c] = true;
+		for (int c = 'a'; c <= 'z'; ++c)
+			values[c] = values[c - 'a' + 'A'] = true;
+		for (char c : std::string_view("!#$%&'*+-.^_`|~"))
+			values[static_cast<uint8_t>(c)] = true;
+	}
+};
+
+constexpr TokenCharTable TokenChars;
+
+bool IsTokenChar(char c) { return TokenChars.values[static_cast<uint8_t>(c)]; }
+
+// RFC 9110 5.5. Field Values, obs-text is allowed
+// See https://www.rfc-editor.org/rfc/rfc9110.html#section-5.5
+bool IsFieldChar(char c) {
+	const auto u = static_cast<uint8_t>(c);
+	return u == '\t' || (u >= 0x20 && u != 0x7F);
+}
+
+bool IsToken(std::string_view str) {
+	return !str.empty() && std::all_of(str.begin(), str.end(), IsTokenChar);
+}
+
+bool IsHttpVersion(std::string_view str) {
+	return str.size() == 8 && str.substr(0, 7) == "HTTP/1." && str[7] >= '0' && str[7] <= '9';
+}
+
+const size_t MaxMethodLength = 16;
+
+} // namespace
+
+HttpParser::HttpParser(Type type, size_t maxSize) : mType(type), mMaxSize(maxSize) {}
+
+HttpParser::Status HttpParser::parse(const byte *buffer, size_t size) {
+	if (mStatus != Status::Incomplete || size < mOffset)
+		reset();
+
+	mData = reinterpret_cast<const char *>(buffer);
+	const size_t limit = std::min(size, mMaxSize);
+	while (true) {
+		auto eol = static_cast<const char *>(std::memchr(mData + mOffset, '\n', limit - mOffset));
+		if (!eol) {
+			if (size >= mMaxSize)
+				return mStatus = Status::TooLarge;
+
+			// Reject early what can't be the beginning of a valid message
+			if (!mStartLineParsed && !checkPartialStartLine(size))
+				return mStatus = Status::Invalid;
+
+			return Status::Incomplete;
+		}
+
+		Range line{mOffset, size_t(eol - mData)};
+		mOffset = line.end + 1;
+		if (line.end > line.begin && mData[line.end - 1] == '\r')
+			--line.end;
+
+		if (!mStartLineParsed) {
+			if (!parseStartLine(line))
+				return mStatus = Status::Invalid;
+
+			mStartLineParsed = true;
+
+		} else if (line.begin == line.end) {
+			return mStatus = Status::Complete;
+
+		} else {
+			if (mHeaderCount == MaxHeaders)
+				return mStatus = Status::TooLarge;
+
+			if (!parseHeaderLine(line))
+				return mStatus = Status::Invalid;
+		}
+	}
+}
+
+void HttpParser::reset() {
+	mData = nullptr;
+	mStatus = Status::Incomplete;
+	mOffset = 0;
+	mStartLineParsed = false;
+	mMethod = mTarget = Range{};
+	mStatusCode = 0;
+	mHeaderCount = 0;
+}
+
+size_t HttpParser::length() const { return mStatus == Status::Complete ? mOffset : 0; }
+
+std::string_view HttpParser::method() const { return view(mMethod); }
+
+std::string_view HttpParser::target() const { return view(mTarget); }
+
+int HttpParser::statusCode() const { return mStatusCode; }
+
+size_t HttpParser::headerCount() const { return mHeaderCount; }
+
+std::string_view HttpParser::headerName(size_t index) const {
+	return index < mHeaderCount ? view(mHeaders[index].first) : std::string_view();
+}
+
+std::string_view HttpParser::headerValue(size_t index) const {
+	return index < mHeaderCount ? view(mHeaders[index].second) : std::string_view();
+}
+
+optional<std::string_view> HttpParser::header(std::string_view name) const {
+	for (size_t i = 0; i < mHeaderCount; ++i)
+		if (utils::iequals(view(mHeaders[i].first), name))
+			return view(mHeaders[i].second);
+
+	return nullopt;
+}
+
+bool HttpParser::parseStartLine(Range line) {
+	const auto str = view(line);
+	if (mType == Type::Request) {
+		// request-line = method SP request-target SP HTTP-version
+		size_t first = str.find(' ');
+		size_t second = first != std::string_view::npos ? str.find(' ', first + 1)
+		                                                : std::string_view::npos;
+		if (second == std::string_view::npos || second == first + 1)
+			return false;
+
+		auto method = str.substr(0, first);
+		auto target = str.substr(first + 1, second - first - 1);
+		if (method.size() > MaxMethodLength || !IsToken(method) ||
+		    !std::all_of(target.begin(), target.end(),
+		                 [](char c) { return IsFieldChar(c) && c != ' ' && c != '\t'; }) ||
+		    !IsHttpVersion(str.substr(second + 1)))
+			return false;
+
+		mMethod = Range{line.begin, line.begin + first};
+		mTarget = Range{line.begin + first + 1, line.begin + second};
+
+	} else {
+		// status-line = HTTP-version SP status-code SP [ reason-phrase ]
+		if (str.size() < 12 || !IsHttpVersion(str.substr(0, 8)) || str[8] != ' ' ||
+		    (str.size() > 12 && str[12] != ' ') ||
+		    !std::all_of(str.begin() + 9, str.begin() + 12,
+		                 [](char c) { return c >= '0' && c <= '9'; }) ||
+		    !std::all_of(str.begin() + 12, str.end(), IsFieldChar))
+			return false;
+
+		mStatusCode = (str[9] - '0') * 100 + (str[10] - '0') * 10 + (str[11] - '0');
+	}
+
+	return true;
+}
+
+bool HttpParser::parseHeaderLine(Range line) {
+	// field-line = field-name ":" OWS field-value OWS
+	// Obsolete line folding, starting with whitespace, is rejected
+	const auto str = view(line);
+	size_t colon = str.find(':');
+	if (colon == std::string_view::npos || !IsToken(str.substr(0, colon)))
+		return false;
+
+	size_t begin = colon + 1, end = str.size();
+	while (begin < end && (str[begin] == ' ' || str[begin] == '\t'))
+		++begin;
+	while (end > begin && (str[end - 1] == ' ' || str[end - 1] == '\t'))
+		--end;
+
+	if (!std::all_of(str.begin() + begin, str.begin() + end, IsFieldChar))
+		return false;
+
+	mHeaders[mHeaderCount++] = std::make_pair(Range{line.begin, line.begin + colon},
+	                                          Range{line.begin + begin, line.begin + end});
+	return true;
+}
+
+bool HttpParser::checkPartialStartLine(size_t end) const {
+	const auto str = std::string_view(mData, end);
+	if (mType == Type::Request) {
+		auto method = str.substr(0, str.find(' '));
+		return method.size() <= MaxMethodLength &&
+		       std::all_of(method.begin(), method.end(), IsTokenChar);
+	} else {
+		const std::string_view prefix = "HTTP/1.";
+		return str.substr(0, prefix.size()) == prefix.substr(0, std::min(end, prefix.size()));
+	}
+}
+
+std::string_view HttpParser::view(Range range) const {
+	return mData ? std::string_view(mData + range.begin, range.end - range.begin)
+	             : std::string_view();
+}
+
 } // namespace rtc::impl
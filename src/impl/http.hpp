@@ -11,8 +11,10 @@
 
 #include "common.hpp"
 
+#include <array>
 #include <list>
 #include <map>
+#include <string_view>
 
 namespace rtc::impl {
 
@@ -25,6 +27,58 @@ size_t parseHttpLines(const byte *buffer, size_t size, std::list<string> &lines)
 // Parse headers of a http message
 std::multimap<string, string> parseHttpHeaders(const std::list<string> &lines);
 
+// Incremental HTTP/1.1 request or response head parser, which does not allocate
+// Successive calls must pass the same buffer content, possibly extended, as parsing resumes where
+// it stopped. Fields are stored as offsets, so views are valid until the buffer is modified.
+class HttpParser final {
+public:
+	enum class Type { Request, Response };
+	enum class Status { Incomplete, Complete, Invalid, TooLarge };
+
+	static const size_t MaxHeaders = 64;
+
+	HttpParser(Type type, size_t maxSize);
+
+	// Parsing a new message after a complete or failed one starts over
+	Status parse(const byte *buffer, size_t size);
+	void reset();
+
+	size_t length() const; // head length including the final empty line, once complete
+
+	std::string_view method() const; // request only
+	std::string_view target() const; // request only
+	int statusCode() const;          // response only
+
+	size_t headerCount() const;
+	std::string_view headerName(size_t index) const;
+	std::string_view headerValue(size_t index) const;
+
+	// Return the value of the first header with the name, case-insensitive
+	optional<std::string_view> header(std::string_view name) const;
+
+private:
+	struct Range {
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	bool parseStartLine(Range line);
+	bool parseHeaderLine(Range line);
+	bool checkPartialStartLine(size_t end) const;
+	std::string_view view(Range range) const;
+
+	const Type mType;
+	const size_t mMaxSize;
+	const char *mData = nullptr;
+	Status mStatus = Status::Incomplete;
+	size_t mOffset = 0; // next line to parse
+	bool mStartLineParsed = false;
+	Range mMethod, mTarget;
+	int mStatusCode = 0;
+	std::array<std::pair<Range, Range>, MaxHeaders> mHeaders;
+	size_t mHeaderCount = 0;
+};
+
 } // namespace rtc::impl
 
 #endif
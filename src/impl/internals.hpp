@@ -11,6 +11,8 @@
 
 #include "common.hpp"
 
+#include <chrono>
+
 // Disable warnings before including plog
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -42,6 +44,16 @@ const size_t DEFAULT_LOCAL_MAX_MESSAGE_SIZE = 256 * 1024; // Default local max m
 const size_t DEFAULT_REMOTE_MAX_MESSAGE_SIZE = 65536;     // Remote max message size if not in SDP
 
 const size_t DEFAULT_WS_MAX_MESSAGE_SIZE = 256 * 1024;   // Default max message size for WebSockets
+const auto DEFAULT_WS_PING_INTERVAL = std::chrono::milliseconds(10000); // Default WebSocket ping
+const size_t WS_DEFLATE_MIN_MESSAGE_SIZE = 128; // Smaller WebSocket messages are sent uncompressed
+const size_t WS_SEGMENT_MIN_SIZE = 1024; // Larger WebSocket payloads are sent without copy
+const size_t WS_MAX_HANDSHAKE_SIZE = 16 * 1024; // Larger WebSocket HTTP handshakes are rejected
+
+const int DEFAULT_TCP_LISTEN_BACKLOG = 1024; // Default listen queue size for servers
+const size_t TCP_ACCEPT_BATCH_SIZE = 64;     // Max connections accepted per poll wakeup
+const size_t TCP_MAX_SEND_SEGMENTS = 64;     // Max queued messages written per gather write
+const size_t TCP_MIN_RECV_BUFFER_SIZE = 4 * 1024;   // Initial and min TCP read size
+const size_t TCP_MAX_RECV_BUFFER_SIZE = 256 * 1024; // Max TCP read size under sustained load
 
 const size_t RECV_QUEUE_LIMIT = 1024; // Max per-channel queue size (messages)
 
@@ -49,6 +61,11 @@ const int MIN_THREADPOOL_SIZE = 4; // Minimum number of threads in the global th
 
 const size_t DEFAULT_MTU = RTC_DEFAULT_MTU; // defined in rtc.h
 
+const size_t DTLS_CONNECTION_ID_LENGTH = 8; // Length of the local DTLS Connection ID (RFC 9146)
+
+const size_t DEFAULT_SRTP_REPLAY_WINDOW_SIZE = 1024; // Default SRTP replay window (packets)
+const size_t SRTP_STREAM_CONTEXT_SIZE = 2048; // Approximate libSRTP stream size without window
+
 } // namespace rtc
 
 #endif
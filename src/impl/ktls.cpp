@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "ktls.hpp"
+#include "internals.hpp"
+#include "tcptransport.hpp"
+
+#if RTC_KTLS_SUPPORTED
+
+namespace rtc::impl::ktls {
+
+namespace {
+
+struct WriteBioData {
+	shared_ptr<TcpTransport> lower;
+	std::function<bool(message_ptr)> outgoing;
+};
+
+int WriteBioWrite(BIO *bio, const char *in, int inl) {
+	auto data = static_cast<WriteBioData *>(BIO_get_data(bio));
+	BIO *next = BIO_next(bio);
+	BIO_clear_retry_flags(bio);
+	if (!data || !next || inl < 0)
+		return -1;
+
+	if (!BIO_get_ktls_send(next)) {
+		// The record is encrypted by OpenSSL
+		try {
+			auto b = reinterpret_cast<const byte *>(in);
+			data->outgoing(make_message(b, b + inl));
+			return inl;
+
+		} catch (const std::exception &e) {
+			PLOG_WARNING << "TLS send failed: " << e.what();
+			return -1;
+		}
+	}
+
+	// The kernel encrypts the record, with the content type set by OpenSSL on the socket BIO, so
+	// it is written only if it can't overtake plaintext pending in the TCP transport
+	int ret = -1;
+	if (!data->lower->configureSocketIfIdle([&](socket_t) {
+		    ret = BIO_write(next, in, inl);
+		    return true;
+	    })) {
+		BIO_set_retry_write(bio);
+		return -1;
+	}
+
+	BIO_copy_next_retry(bio);
+	return ret;
+}
+
+long WriteBioCtrl(BIO *bio, int cmd, long num, void *ptr) {
+	auto data = static_cast<WriteBioData *>(BIO_get_data(bio));
+	BIO *next = BIO_next(bio);
+	if (!data || !next)
+		return 0;
+
+	switch (cmd) {
+	case BIO_CTRL_FLUSH:
+		return 1; // records are passed to the TCP transport as they are written
+
+	case BIO_CTRL_PUSH:
+	case BIO_CTRL_POP:
+		return 0;
+
+	case BIO_CTRL_GET_KTLS_SEND:
+	case BIO_CTRL_GET_KTLS_RECV:
+		return BIO_ctrl(next, cmd, num, ptr);
+
+	default: {
+		// Once enabled, controls like the content type of the next record are passed through
+		if (BIO_get_ktls_send(next))
+			return BIO_ctrl(next, cmd, num, ptr);
+
+		// Moving the record layer to the kernel requires previous records to be on the socket
+		long ret = 0;
+		data->lower->configureSocketIfIdle([&](socket_t) {
+			ret = BIO_ctrl(next, cmd, num, ptr);
+			return true;
+		});
+		return ret;
+	}
+	}
+}
+
+int WriteBioCreate(BIO *bio) {
+	BIO_set_data(bio, nullptr);
+	BIO_set_init(bio, 1);
+	return 1;
+}
+
+int WriteBioDestroy(BIO *bio) {
+	delete static_cast<WriteBioData *>(BIO_get_data(bio));
+	BIO_set_data(bio, nullptr);
+	return 1;
+}
+
+const BIO_METHOD *WriteBioMethod() {
+	static BIO_METHOD *method = []() {
+		BIO_METHOD *m = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_FILTER, "kernel TLS write");
+		if (!m)
+			throw std::runtime_error("Failed to create BIO method");
+
+		BIO_meth_set_write(m, WriteBioWrite);
+		BIO_meth_set_ctrl(m, WriteBioCtrl);
+		BIO_meth_set_create(m, WriteBioCreate);
+		BIO_meth_set_destroy(m, WriteBioDestroy);
+		return m;
+	}();
+	return method;
+}
+
+} // namespace
+
+BIO *NewWriteBio(shared_ptr<TcpTransport> lower, std::function<bool(message_ptr)> outgoing) {
+	socket_t sock = INVALID_SOCKET;
+	lower->configureSocketIfIdle([&sock](socket_t s) {
+		sock = s;
+		return true;
+	});
+	if (sock == INVALID_SOCKET)
+		return nullptr;
+
+	// The socket BIO is only used to set up kernel TLS and write records once it is enabled
+	BIO *socketBio = BIO_new_socket(int(sock), BIO_NOCLOSE);
+	BIO *bio = BIO_new(WriteBioMethod());
+	if (!socketBio || !bio) {
+		BIO_free(socketBio);
+		BIO_free(bio);
+		throw std::runtime_error("Failed to create BIO");
+	}
+
+	BIO_set_data(bio, new WriteBioData{std::move(lower), std::move(outgoing)});
+	return BIO_push(bio, socketBio);
+}
+
+} // namespace rtc::impl::ktls
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_IMPL_KTLS_H
+#define RTC_IMPL_KTLS_H
+
+#include "common.hpp"
+#include "message.hpp"
+#include "tls.hpp"
+
+#include <functional>
+
+// Kernel TLS requires Linux and OpenSSL 3 built with KTLS support
+#if RTC_ENABLE_WEBSOCKET && defined(__linux__) && !USE_GNUTLS && !USE_MBEDTLS &&                   \
+    OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(OPENSSL_NO_KTLS)
+#define RTC_KTLS_SUPPORTED 1
+#else
+#define RTC_KTLS_SUPPORTED 0
+#endif
+
+#if RTC_KTLS_SUPPORTED
+
+namespace rtc::impl {
+
+class TcpTransport;
+
+namespace ktls {
+
+// Write BIO for an SSL object with SSL_OP_ENABLE_KTLS, on top of a socket BIO for the TCP socket
+// Records encrypted by OpenSSL are passed to the outgoing callback. If OpenSSL moves the sending
+// record layer to the kernel, BIO_get_ktls_send() becomes true: application data must then be
+// sent in plaintext through the TCP transport, and the remaining records from OpenSSL, like
+// alerts, are written to the socket by OpenSSL when nothing is pending in the TCP transport.
+// Returns nullptr if the TCP socket is not available.
+BIO *NewWriteBio(shared_ptr<TcpTransport> lower, std::function<bool(message_ptr)> outgoing);
+
+} // namespace ktls
+
+} // namespace rtc::impl
+
+#endif
+
+#endif
@@ -67,6 +67,13 @@ PeerConnection::PeerConnection(Configuration config_) : config(std::move(config_
 	if (config.portRangeEnd && config.portRangeBegin > config.portRangeEnd)
 		throw std::invalid_argument("Invalid port range");
 
+	// Fail early rather than silently falling back to DTLS 1.2 without Connection ID
+	if (config.enableDtls13 && !DtlsTransport::IsDtls13Supported())
+		throw std::invalid_argument("DTLS 1.3 is not supported by the TLS backend");
+
+	if (config.enableDtlsConnectionId && !DtlsTransport::IsConnectionIdSupported())
+		throw std::invalid_argument("DTLS Connection ID is not supported by the TLS backend");
+
 	if (config.mtu) {
 		if (*config.mtu < 576) // Min MTU for IPv4
 			throw std::invalid_argument("Invalid MTU value");
@@ -132,6 +139,20 @@ size_t PeerConnection::remoteMaxMessageSize() const {
 	return std::min(remoteMax, localMax);
 }
 
+optional<uint16_t> PeerConnection::sctpFastOpenStreamsCount() const {
+	if (!config.enableSctpFastOpen)
+		return nullopt;
+
+	// Fast-open applies only if both peers advertise it, with the lowest streams count
+	std::lock_guard lock(mRemoteDescriptionMutex);
+	if (mRemoteDescription)
+		if (auto *application = mRemoteDescription->application())
+			if (auto count = application->sctpFastOpenStreams(); count && *count > 0)
+				return std::min(*count, MAX_SCTP_STREAMS_COUNT);
+
+	return nullopt;
+}
+
 // Helper for PeerConnection::initXTransport methods: start and emplace the transport
 template <typename T>
 shared_ptr<T> emplaceTransport(PeerConnection *pc, shared_ptr<T> *member, shared_ptr<T> transport) {
@@ -278,7 +299,7 @@ shared_ptr<DtlsTransport> PeerConnection::initDtlsTransport() {
 
 			// DTLS-SRTP
 			transport = std::make_shared<DtlsSrtpTransport>(
-			    lower, certificate, config.mtu, fingerprintAlgorithm, verifierCallback,
+			    lower, certificate, config, fingerprintAlgorithm, verifierCallback,
 			    weak_bind(&PeerConnection::forwardMedia, this, _1), dtlsStateChangeCallback);
 #else
 			PLOG_WARNING << "Ignoring media support (not compiled with media support)";
@@ -287,7 +308,7 @@ shared_ptr<DtlsTransport> PeerConnection::initDtlsTransport() {
 
 		if (!transport) {
 			// DTLS only
-			transport = std::make_shared<DtlsTransport>(lower, certificate, config.mtu,
+			transport = std::make_shared<DtlsTransport>(lower, certificate, config,
 			                                            fingerprintAlgorithm, verifierCallback,
 			                                            dtlsStateChangeCallback);
 		}
@@ -326,7 +347,8 @@ shared_ptr<SctpTransport> PeerConnection::initSctpTransport() {
 		ports.remote = remote->application()->sctpPort().value_or(DEFAULT_SCTP_PORT);
 
 		auto transport = std::make_shared<SctpTransport>(
-		    lower, config, std::move(ports), weak_bind(&PeerConnection::forwardMessage, this, _1),
+		    lower, config, std::move(ports), sctpFastOpenStreamsCount(),
+		    weak_bind(&PeerConnection::forwardMessage, this, _1),
 		    weak_bind(&PeerConnection::forwardBufferedAmount, this, _1, _2),
 		    [this, weak_this = weak_from_this()](SctpTransport::State transportState) {
 			    auto shared_this = weak_this.lock();
@@ -334,6 +356,15 @@ shared_ptr<SctpTransport> PeerConnection::initSctpTransport() {
 				    return;
 
 			    switch (transportState) {
+			    case SctpTransport::State::Connecting:
+				    // If fast-open is pre-negotiated, open DataChannels without waiting for the
+				    // association, with the streams count agreed via the SDP
+				    if (auto sctpTransport = std::atomic_load(&mSctpTransport);
+				        sctpTransport && sctpTransport->isFastOpen()) {
+					    assignDataChannels();
+					    mProcessor.enqueue(&PeerConnection::openDataChannels, shared_from_this());
+				    }
+				    break;
 			    case SctpTransport::State::Connected:
 				    changeState(State::Connected);
 				    assignDataChannels();
@@ -676,9 +707,9 @@ shared_ptr<DataChannel> PeerConnection::emplaceDataChannel(string label, DataCha
 
 	lock.unlock(); // we are going to call assignDataChannels()
 
-	// If SCTP is connected, assign and open now
+	// If SCTP is writable, assign and open now
 	auto sctpTransport = std::atomic_load(&mSctpTransport);
-	if (sctpTransport && sctpTransport->state() == SctpTransport::State::Connected) {
+	if (sctpTransport && sctpTransport->isWritable()) {
 		assignDataChannels();
 		channel->open(sctpTransport);
 	}
@@ -945,6 +976,8 @@ void PeerConnection::populateLocalDescription(Description &description) const {
 					        Description::Application app(remoteApp->mid());
 					        app.setSctpPort(localSctpPort);
 					        app.setMaxMessageSize(localMaxMessageSize);
+					        if (config.enableSctpFastOpen)
+						        app.setSctpFastOpenStreams(MAX_SCTP_STREAMS_COUNT);
 
 					        PLOG_DEBUG << "Adding application to local description, mid=\""
 					                   << app.mid() << "\"";
@@ -955,6 +988,8 @@ void PeerConnection::populateLocalDescription(Description &description) const {
 							auto reciprocated = remoteApp->reciprocate();
 							reciprocated.hintSctpPort(localSctpPort);
 							reciprocated.setMaxMessageSize(localMaxMessageSize);
+							if (config.enableSctpFastOpen)
+								reciprocated.setSctpFastOpenStreams(MAX_SCTP_STREAMS_COUNT);
 
 							PLOG_DEBUG << "Reciprocating application in local description, mid=\""
 								       << reciprocated.mid() << "\"";
@@ -1022,6 +1057,8 @@ void PeerConnection::populateLocalDescription(Description &description) const {
 				Description::Application app(std::to_string(m));
 				app.setSctpPort(localSctpPort);
 				app.setMaxMessageSize(localMaxMessageSize);
+				if (config.enableSctpFastOpen)
+					app.setSctpFastOpenStreams(MAX_SCTP_STREAMS_COUNT);
 
 				PLOG_DEBUG << "Adding application to local description, mid=\"" << app.mid()
 				           << "\"";
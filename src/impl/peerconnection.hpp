@@ -42,6 +42,7 @@ struct PeerConnection : std::enable_shared_from_this<PeerConnection> {
 	optional<Description> localDescription() const;
 	optional<Description> remoteDescription() const;
 	size_t remoteMaxMessageSize() const;
+	optional<uint16_t> sctpFastOpenStreamsCount() const;
 
 	shared_ptr<IceTransport> initIceTransport();
 	shared_ptr<DtlsTransport> initDtlsTransport();
@@ -51,6 +51,8 @@ void PollService::join() {
 	mInterrupter.reset();
 }
 
+bool PollService::isPollThread() const { return std::this_thread::get_id() == mThreadId.load(); }
+
 void PollService::add(socket_t sock, Params params) {
 	assert(sock != INVALID_SOCKET);
 	assert(params.callback);
@@ -167,6 +169,7 @@ void PollService::process(std::vector<struct pollfd> &pfds) {
 
 void PollService::runLoop() {
 	utils::this_thread::set_name("RTC poll");
+	mThreadId = std::this_thread::get_id();
 	PLOG_DEBUG << "Poll service started";
 
 	try {
@@ -16,6 +16,7 @@
 
 #if RTC_ENABLE_WEBSOCKET
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <mutex>
@@ -51,6 +52,8 @@ public:
 	void add(socket_t sock, Params params);
 	void remove(socket_t sock);
 
+	bool isPollThread() const; // true if called from a poll callback
+
 private:
 	PollService();
 	~PollService();
@@ -70,6 +73,7 @@ private:
 
 	std::recursive_mutex mMutex;
 	std::thread mThread;
+	std::atomic<std::thread::id> mThreadId;
 	bool mStopped;
 };
 
@@ -151,11 +151,13 @@ void SctpTransport::Cleanup() {
 }
 
 SctpTransport::SctpTransport(shared_ptr<Transport> lower, const Configuration &config, Ports ports,
-                             message_callback recvCallback, amount_callback bufferedAmountCallback,
+                             optional<uint16_t> fastOpenStreamsCount, message_callback recvCallback,
+                             amount_callback bufferedAmountCallback,
                              state_callback stateChangeCallback)
     : Transport(lower, std::move(stateChangeCallback)),
       mMaxMessageSize(config.maxMessageSize.value_or(DEFAULT_LOCAL_MAX_MESSAGE_SIZE)),
-      mPorts(std::move(ports)), mSendQueue(0, message_size_func),
+      mPorts(std::move(ports)), mFastOpenStreamsCount(fastOpenStreamsCount),
+      mSendQueue(0, message_size_func),
       mBufferedAmountCallback(std::move(bufferedAmountCallback)) {
 	onRecv(std::move(recvCallback));
 
@@ -364,11 +366,17 @@ void SctpTransport::connect() {
 	int ret = usrsctp_connect(mSock, reinterpret_cast<struct sockaddr *>(&remote), sizeof(remote));
 	if (ret && errno != EINPROGRESS)
 		throw std::runtime_error("Connection attempt failed, errno=" + std::to_string(errno));
+
+	mConnectInitiated = true;
+
+	// In fast-open mode, messages queued in the meantime can now be handed to usrsctp
+	if (isFastOpen())
+		enqueueFlush();
 }
 
 bool SctpTransport::send(message_ptr message) {
 	std::lock_guard lock(mSendMutex);
-	if (state() != State::Connected)
+	if (!isWritable())
 		return false;
 
 	if (!message)
@@ -391,7 +399,7 @@ bool SctpTransport::send(message_ptr message) {
 bool SctpTransport::flush() {
 	try {
 		std::lock_guard lock(mSendMutex);
-		if (state() != State::Connected)
+		if (!isWritable())
 			return false;
 
 		trySendQueue();
@@ -434,10 +442,25 @@ void SctpTransport::close() {
 }
 
 unsigned int SctpTransport::maxStream() const {
-	unsigned int streamsCount = mNegotiatedStreamsCount.value_or(MAX_SCTP_STREAMS_COUNT);
+	// In fast-open mode, the count pre-negotiated via the SDP applies until the association is up
+	unsigned int streamsCount = mNegotiatedStreamsCount.value_or(
+	    mFastOpenStreamsCount.value_or(MAX_SCTP_STREAMS_COUNT));
 	return streamsCount > 0 ? streamsCount - 1 : 0;
 }
 
+bool SctpTransport::isFastOpen() const { return mFastOpenStreamsCount.has_value(); }
+
+bool SctpTransport::isWritable() const {
+	switch (state()) {
+	case State::Connected:
+		return true;
+	case State::Connecting:
+		return isFastOpen();
+	default:
+		return false;
+	}
+}
+
 void SctpTransport::incoming(message_ptr message) {
 	// There could be a race condition here where we receive the remote INIT before the local one is
 	// sent, which would result in the connection being aborted. Therefore, we need to wait for data
@@ -593,7 +616,8 @@ bool SctpTransport::trySendQueue() {
 
 bool SctpTransport::trySendMessage(message_ptr message) {
 	// Requires mSendMutex to be locked
-	if (state() != State::Connected)
+	// In fast-open mode, usrsctp queues user data in COOKIE-WAIT and bundles it with COOKIE-ECHO
+	if (!isWritable() || !mConnectInitiated)
 		return false;
 
 	uint32_t ppid;
@@ -608,6 +632,10 @@ bool SctpTransport::trySendMessage(message_ptr message) {
 		ppid = PPID_CONTROL;
 		break;
 	case Message::Reset:
+		// Stream reset requires the association to be established
+		if (state() != State::Connected)
+			return false;
+
 		sendReset(uint16_t(message->stream));
 		return true;
 	default:
@@ -38,9 +38,10 @@ public:
 		uint16_t remote = DEFAULT_SCTP_PORT;
 	};
 
+	// fastOpenStreamsCount is set if fast-open is pre-negotiated, with the agreed streams count
 	SctpTransport(shared_ptr<Transport> lower, const Configuration &config, Ports ports,
-	              message_callback recvCallback, amount_callback bufferedAmountCallback,
-	              state_callback stateChangeCallback);
+	              optional<uint16_t> fastOpenStreamsCount, message_callback recvCallback,
+	              amount_callback bufferedAmountCallback, state_callback stateChangeCallback);
 	~SctpTransport();
 
 	void onBufferedAmount(amount_callback callback);
@@ -53,6 +54,8 @@ public:
 	void close();
 
 	unsigned int maxStream() const;
+	bool isFastOpen() const;
+	bool isWritable() const; // true if connected, or connecting in fast-open mode
 
 	// Stats
 	void clearStats();
@@ -98,8 +101,10 @@ private:
 
 	const size_t mMaxMessageSize;
 	const Ports mPorts;
+	const optional<uint16_t> mFastOpenStreamsCount;
 	struct socket *mSock;
 	std::optional<uint16_t> mNegotiatedStreamsCount;
+	std::atomic<bool> mConnectInitiated = false;
 
 	Processor mProcessor;
 	std::atomic<int> mPendingRecvCount = 0;
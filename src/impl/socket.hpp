@@ -57,6 +57,9 @@ typedef ULONG nfds_t;
 #define SECONNREFUSED WSAECONNREFUSED
 #define SECONNRESET WSAECONNRESET
 #define SENETRESET WSAENETRESET
+#define SECONNABORTED WSAECONNABORTED
+#define SEMFILE WSAEMFILE
+#define SENOBUFS WSAENOBUFS
 
 #else // assume POSIX
 
@@ -104,6 +107,9 @@ typedef int sockopt_t;
 #define SECONNREFUSED ECONNREFUSED
 #define SECONNRESET ECONNRESET
 #define SENETRESET ENETRESET
+#define SECONNABORTED ECONNABORTED
+#define SEMFILE EMFILE
+#define SENOBUFS ENOBUFS
 
 #endif // _WIN32
 
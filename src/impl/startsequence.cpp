@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "startsequence.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define START_SEQUENCE_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define START_SEQUENCE_AVX2 1 // compiled with a target attribute and selected at runtime
+#include <immintrin.h>
+#endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)) &&                     \
+    (defined(__aarch64__) || defined(_M_ARM64))
+#define START_SEQUENCE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace rtc::impl {
+
+namespace {
+
+// Every start sequence begins with two zero bytes, which are rare in NAL unit payloads thanks to
+// emulation prevention, so kernels look for zero pairs and candidates are checked afterwards.
+// Kernels return the offset of the first zero pair at or after the offset, or size - 1 if none.
+
+[[maybe_unused]] int CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return int(index);
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+size_t FindZeroPairScalar(const uint8_t *data, size_t size, size_t i) {
+	// Skip 8 bytes at a time while no byte is zero, see "Determine if a word has a zero byte" in
+	// https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
+	for (; i + 9 <= size; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		if ((word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL)
+			break;
+	}
+
+	for (; i + 1 < size; ++i)
+		if (data[i] == 0 && data[i + 1] == 0)
+			return i;
+
+	return size > 0 ? size - 1 : 0;
+}
+
+#if START_SEQUENCE_SSE2
+
+size_t FindZeroPairSse2(const uint8_t *data, size_t size, size_t i) {
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 17 <= size; i += 16) {
+		auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 1));
+		if (int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(a, b), zero)))
+			return i + size_t(CountTrailingZeros(uint32_t(mask)));
+	}
+	return FindZeroPairScalar(data, size, i);
+}
+
+#endif
+
+#if START_SEQUENCE_AVX2
+
+__attribute__((target("avx2"))) size_t FindZeroPairAvx2(const uint8_t *data, size_t size,
+                                                        size_t i) {
+	const __m256i zero = _mm256_setzero_si256();
+	for (; i + 33 <= size; i += 32) {
+		auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+		auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 1));
+		auto cmp = _mm256_cmpeq_epi8(_mm256_or_si256(a, b), zero);
+		if (uint32_t mask = uint32_t(_mm256_movemask_epi8(cmp))) {
+			_mm256_zeroupper(); // avoid the AVX-SSE transition penalty
+			return i + size_t(CountTrailingZeros(mask));
+		}
+	}
+	_mm256_zeroupper();
+	return FindZeroPairSse2(data, size, i);
+}
+
+bool HasAvx2() {
+	static const bool result = __builtin_cpu_supports("avx2");
+	return result;
+}
+
+#endif
+
+#if START_SEQUENCE_NEON
+
+size_t FindZeroPairNeon(const uint8_t *data, size_t size, size_t i) {
+	for (; i + 17 <= size; i += 16) {
+		uint8x16_t v = vorrq_u8(vld1q_u8(data + i), vld1q_u8(data + i + 1));
+		if (vminvq_u8(v) == 0)
+			break; // the pair is located by the scalar kernel
+	}
+	return FindZeroPairScalar(data, size, i);
+}
+
+#endif
+
+size_t FindZeroPair(const uint8_t *data, size_t size, size_t i) {
+#if START_SEQUENCE_AVX2
+	if (HasAvx2())
+		return FindZeroPairAvx2(data, size, i);
+#endif
+#if START_SEQUENCE_SSE2
+	return FindZeroPairSse2(data, size, i);
+#elif START_SEQUENCE_NEON
+	return FindZeroPairNeon(data, size, i);
+#else
+	return FindZeroPairScalar(data, size, i);
+#endif
+}
+
+} // namespace
+
+size_t FindStartSequence(const byte *data, size_t size, NalUnit::Separator separator,
+                         size_t &length) {
+	using Separator = NalUnit::Separator;
+	auto d = reinterpret_cast<const uint8_t *>(data);
+	const size_t minZeros = separator == Separator::LongStartSequence ? 3 : 2;
+	size_t i = 0;
+	while (i + 2 < size) {
+		// The zero run can't extend before the pair since it is the first one from i, and i is
+		// either the beginning or follows a non-zero byte
+		const size_t pair = FindZeroPair(d, size, i);
+		size_t end = pair + 2;
+		while (end < size && d[end] == 0)
+			++end;
+
+		if (end >= size)
+			break;
+
+		const size_t zeros = end - pair;
+		if (d[end] == 0x01 && zeros >= minZeros) {
+			if (separator == Separator::StartSequence)
+				length = zeros >= 3 ? 4 : 3;
+			else
+				length = separator == Separator::LongStartSequence ? 4 : 3;
+
+			return end + 1 - length;
+		}
+
+		i = end + 1;
+	}
+
+	return size;
+}
+
+} // namespace rtc::impl
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_IMPL_START_SEQUENCE_H
+#define RTC_IMPL_START_SEQUENCE_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "nalunit.hpp"
+
+namespace rtc::impl {
+
+// Find the first Annex-B start sequence in data, as matched by NalUnit::StartSequenceMatchSucc
+// from the beginning of data, and return its offset, or size if there is none. On a match, length
+// is set to the sequence length, 3 or 4 bytes; extra leading zeros are not part of the sequence.
+// See ITU-T H.264 Annex B
+size_t FindStartSequence(const byte *data, size_t size, NalUnit::Separator separator,
+                         size_t &length);
+
+} // namespace rtc::impl
+
+#endif
+
+#endif
@@ -19,16 +19,30 @@
 #include <unistd.h>
 #endif
 
+#include <chrono>
+#include <thread>
+
 namespace rtc::impl {
 
-TcpServer::TcpServer(uint16_t port, const char *bindAddress) {
+bool TcpServer::IsReusePortSupported() {
+	// Only Linux balances incoming connections between sockets bound with SO_REUSEPORT
+#if defined(__linux__) && defined(SO_REUSEPORT)
+	return true;
+#else
+	return false;
+#endif
+}
+
+TcpServer::TcpServer(uint16_t port, const char *bindAddress, optional<int> backlog,
+                     bool reusePort) {
 	PLOG_DEBUG << "Initializing TCP server";
-	listen(port, bindAddress);
+	listen(port, bindAddress, backlog.value_or(DEFAULT_TCP_LISTEN_BACKLOG), reusePort);
 }
 
 TcpServer::~TcpServer() { close(); }
 
-shared_ptr<TcpTransport> TcpServer::accept() {
+std::vector<socket_t> TcpServer::accept(size_t maxCount) {
+	std::vector<socket_t> incoming;
 	while (true) {
 		std::unique_lock lock(mSockMutex);
 
@@ -61,26 +75,55 @@ shared_ptr<TcpTransport> TcpServer::accept() {
 		}
 
 		if (pfd[1].revents & POLLIN) {
-			struct sockaddr_storage addr;
-			socklen_t addrlen = sizeof(addr);
-			socket_t incomingSock = ::accept(mSock, (struct sockaddr *)&addr, &addrlen);
-
-			if (incomingSock != INVALID_SOCKET) {
-				try {
-					return std::make_shared<TcpTransport>(incomingSock, nullptr); // no state callback
-				} catch(const std::exception &e) {
-					PLOG_WARNING << e.what();
-					::closesocket(incomingSock);
+			// Drain the listen queue instead of accepting a single connection per wakeup
+			bool exhausted = false;
+			while (incoming.size() < maxCount) {
+				struct sockaddr_storage addr;
+				socklen_t addrlen = sizeof(addr);
+#ifdef __linux__
+				socket_t incomingSock = ::accept4(mSock, (struct sockaddr *)&addr, &addrlen,
+				                                  SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+				socket_t incomingSock = ::accept(mSock, (struct sockaddr *)&addr, &addrlen);
+#endif
+				if (incomingSock != INVALID_SOCKET) {
+					incoming.push_back(incomingSock);
+					continue;
 				}
-			} else if (sockerrno != SEAGAIN && sockerrno != SEWOULDBLOCK) {
-				PLOG_ERROR << "TCP server failed, errno=" << sockerrno;
+
+				int err = sockerrno;
+				if (err == SEAGAIN || err == SEWOULDBLOCK)
+					break;
+
+				if (err == SEINTR || err == SECONNABORTED)
+					continue;
+
+				if (err == SEMFILE || err == SENOBUFS) {
+					// The pending connection stays in the queue, retry later
+					PLOG_WARNING << "TCP server is out of resources, errno=" << err;
+					exhausted = true;
+					break;
+				}
+
+				PLOG_ERROR << "TCP server failed, errno=" << err;
+				for (socket_t sock : incoming)
+					::closesocket(sock);
+
 				throw std::runtime_error("TCP server failed");
 			}
+
+			if (!incoming.empty())
+				return incoming;
+
+			if (exhausted) {
+				lock.unlock();
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
 		}
 	}
 
 	PLOG_DEBUG << "TCP server closed";
-	return nullptr;
+	return incoming;
 }
 
 void TcpServer::close() {
@@ -93,7 +136,7 @@ void TcpServer::close() {
 	}
 }
 
-void TcpServer::listen(uint16_t port, const char *bindAddress) {
+void TcpServer::listen(uint16_t port, const char *bindAddress, int backlog, bool reusePort) {
 	PLOG_DEBUG << "Listening on port " << port;
 
 	struct addrinfo hints = {};
@@ -134,6 +177,16 @@ void TcpServer::listen(uint16_t port, const char *bindAddress) {
 		::setsockopt(mSock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&enabled),
 		             sizeof(enabled));
 
+#ifdef SO_REUSEPORT
+		// Enable REUSEPORT so the kernel balances connections between listening sockets
+		if (reusePort)
+			::setsockopt(mSock, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<const char *>(&enabled),
+			             sizeof(enabled));
+#else
+		if (reusePort)
+			throw std::logic_error("SO_REUSEPORT is not supported");
+#endif
+
 		// Listen on both IPv6 and IPv4
 		if (ai->ai_family == AF_INET6)
 			::setsockopt(mSock, IPPROTO_IPV6, IPV6_V6ONLY,
@@ -152,7 +205,6 @@ void TcpServer::listen(uint16_t port, const char *bindAddress) {
 		}
 
 		// Listen
-		const int backlog = 10;
 		if (::listen(mSock, backlog) < 0) {
 			PLOG_WARNING << "TCP server socket listening failed, errno=" << sockerrno;
 			throw std::runtime_error("TCP server socket listening failed");
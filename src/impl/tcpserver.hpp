@@ -17,23 +17,31 @@
 
 #if RTC_ENABLE_WEBSOCKET
 
+#include <vector>
+
 namespace rtc::impl {
 
 class TcpServer final {
 public:
-	TcpServer(uint16_t port, const char *bindAddress = nullptr);
+	// Return true if several servers can listen on the same port with load balancing
+	static bool IsReusePortSupported();
+
+	TcpServer(uint16_t port, const char *bindAddress = nullptr, optional<int> backlog = nullopt,
+	          bool reusePort = false);
 	~TcpServer();
 
 	TcpServer(const TcpServer &other) = delete;
 	void operator=(const TcpServer &other) = delete;
 
-	shared_ptr<TcpTransport> accept();
+	// Wait for incoming connections and accept up to maxCount of them at once
+	// The caller takes ownership of returned sockets, the result is empty once closed
+	std::vector<socket_t> accept(size_t maxCount);
 	void close();
 
 	uint16_t port() const { return mPort; }
 
 private:
-	void listen(uint16_t port, const char *bindAddress);
+	void listen(uint16_t port, const char *bindAddress, int backlog, bool reusePort);
 
 	uint16_t mPort;
 	socket_t mSock = INVALID_SOCKET;
@@ -14,9 +14,11 @@
 
 #ifndef _WIN32
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <chrono>
 
 namespace rtc::impl {
@@ -52,13 +54,15 @@ bool unmap_inet6_v4mapped(struct sockaddr *sa, socklen_t *len) {
 
 TcpTransport::TcpTransport(string hostname, string service, state_callback callback)
     : Transport(nullptr, std::move(callback)), mIsActive(true), mHostname(std::move(hostname)),
-      mService(std::move(service)), mSock(INVALID_SOCKET) {
+      mService(std::move(service)), mSock(INVALID_SOCKET),
+      mRecvBufferSize(TCP_MIN_RECV_BUFFER_SIZE) {
 
 	PLOG_DEBUG << "Initializing TCP transport";
 }
 
 TcpTransport::TcpTransport(socket_t sock, state_callback callback)
-    : Transport(nullptr, std::move(callback)), mIsActive(false), mSock(sock) {
+    : Transport(nullptr, std::move(callback)), mIsActive(false), mSock(sock),
+      mRecvBufferSize(TCP_MIN_RECV_BUFFER_SIZE) {
 
 	PLOG_DEBUG << "Initializing TCP transport with socket";
 
@@ -124,20 +128,61 @@ void TcpTransport::incoming(message_ptr message) {
 	recv(message);
 }
 
+bool TcpTransport::sendSegments(std::vector<message_ptr> segments) {
+	std::lock_guard lock(mSendMutex);
+
+	if (state() != State::Connected)
+		throw std::runtime_error("Connection is not open");
+
+	// Segments are queued together so they are written contiguously, without copy
+	size_t size = 0;
+	for (auto &segment : segments) {
+		if (segment && segment->size() > 0) {
+			size += segment->size();
+			mSendQueue.push_back(std::move(segment));
+		}
+	}
+
+	PLOG_VERBOSE << "Send size=" << size << " in " << segments.size() << " segments";
+	if (trySendQueue(size))
+		return true;
+
+	setPoll(PollService::Direction::Both);
+	return false;
+}
+
 bool TcpTransport::outgoing(message_ptr message) {
 	// mSendMutex must be locked
-	// Flush the queue, and if nothing is pending, try to send directly
-	if (trySendQueue() && trySendMessage(message))
+	// Queue the message and flush the queue, it is sent directly if nothing is pending
+	const size_t size = message->size();
+	if (size > 0)
+		mSendQueue.push_back(std::move(message));
+
+	if (trySendQueue(size))
 		return true;
 
-	mSendQueue.push(message);
-	updateBufferedAmount(ptrdiff_t(message->size()));
 	setPoll(PollService::Direction::Both);
 	return false;
 }
 
+void TcpTransport::hibernate() {
+	std::lock_guard lock(mSendMutex);
+	if (mSendQueue.empty()) {
+		std::deque<message_ptr> empty;
+		mSendQueue.swap(empty); // release the deque blocks
+	}
+}
+
 bool TcpTransport::isActive() const { return mIsActive; }
 
+bool TcpTransport::configureSocketIfIdle(const std::function<bool(socket_t sock)> &func) {
+	std::lock_guard lock(mSendMutex);
+	if (mSock == INVALID_SOCKET || !mSendQueue.empty())
+		return false;
+
+	return func(mSock);
+}
+
 string TcpTransport::remoteAddress() const { return mHostname + ':' + mService; }
 
 void TcpTransport::connect() {
@@ -305,53 +350,83 @@ void TcpTransport::close() {
 	changeState(State::Disconnected);
 }
 
-bool TcpTransport::trySendQueue() {
+bool TcpTransport::trySendQueue(size_t added) {
 	// mSendMutex must be locked
-	while (auto next = mSendQueue.peek()) {
-		message_ptr message = std::move(*next);
-		size_t size = message->size();
-		if (!trySendMessage(message)) { // replaces message
-			mSendQueue.exchange(message);
-			updateBufferedAmount(-ptrdiff_t(size) + ptrdiff_t(message->size()));
-			return false;
+	// The added bytes have just been queued and are not counted in the buffered amount yet
+	// Queued messages are written with gather writes, a partially sent message is tracked with
+	// an offset instead of being copied
+	size_t sent = 0;
+	while (!mSendQueue.empty()) {
+#ifdef _WIN32
+		WSABUF bufs[TCP_MAX_SEND_SEGMENTS];
+#else
+		struct iovec bufs[TCP_MAX_SEND_SEGMENTS];
+#endif
+		size_t count = 0;
+		size_t total = 0;
+		for (auto it = mSendQueue.begin();
+		     it != mSendQueue.end() && count < TCP_MAX_SEND_SEGMENTS; ++it, ++count) {
+			const size_t offset = count == 0 ? mSendOffset : 0;
+			auto data = reinterpret_cast<char *>((*it)->data()) + offset;
+			const size_t size = (*it)->size() - offset;
+#ifdef _WIN32
+			bufs[count].buf = data;
+			bufs[count].len = ULONG(size);
+#else
+			bufs[count].iov_base = data;
+			bufs[count].iov_len = size;
+#endif
+			total += size;
 		}
 
-		mSendQueue.pop();
-		updateBufferedAmount(-ptrdiff_t(size));
-	}
-
-	return true;
-}
-
-bool TcpTransport::trySendMessage(message_ptr &message) {
-	// mSendMutex must be locked
-
-	auto data = reinterpret_cast<const char *>(message->data());
-	auto size = message->size();
-	while (size) {
-#if defined(__APPLE__) || defined(_WIN32)
+#ifdef _WIN32
+		DWORD written = 0;
+		ptrdiff_t len = ::WSASend(mSock, bufs, DWORD(count), &written, 0, NULL, NULL) == 0
+		                    ? ptrdiff_t(written)
+		                    : -1;
+#else
+#if defined(__APPLE__)
 		int flags = 0;
 #else
 		int flags = MSG_NOSIGNAL;
 #endif
-		int len = ::send(mSock, data, int(size), flags);
+		struct msghdr msg = {};
+		msg.msg_iov = bufs;
+		msg.msg_iovlen = decltype(msg.msg_iovlen)(count);
+		ptrdiff_t len = ::sendmsg(mSock, &msg, flags);
+#endif
 		if (len < 0) {
-			if (sockerrno == SEAGAIN || sockerrno == SEWOULDBLOCK) {
-				if (size < message->size())
-					message = make_message(message->end() - size, message->end());
-
-				return false;
-			} else {
-				PLOG_ERROR << "Connection closed, errno=" << sockerrno;
-				throw std::runtime_error("Connection closed");
+			if (sockerrno == SEINTR)
+				continue;
+
+			if (sockerrno == SEAGAIN || sockerrno == SEWOULDBLOCK)
+				break;
+
+			PLOG_ERROR << "Connection closed, errno=" << sockerrno;
+			throw std::runtime_error("Connection closed");
+		}
+
+		sent += size_t(len);
+
+		// Pop fully sent messages and keep the offset in the partially sent one
+		size_t remaining = size_t(len);
+		while (remaining > 0) {
+			const size_t available = mSendQueue.front()->size() - mSendOffset;
+			if (remaining < available) {
+				mSendOffset += remaining;
+				break;
 			}
+			remaining -= available;
+			mSendQueue.pop_front();
+			mSendOffset = 0;
 		}
 
-		data += len;
-		size -= len;
+		if (size_t(len) < total)
+			break; // the socket buffer is full
 	}
-	message = nullptr;
-	return true;
+
+	updateBufferedAmount(ptrdiff_t(added) - ptrdiff_t(sent));
+	return mSendQueue.empty();
 }
 
 void TcpTransport::updateBufferedAmount(ptrdiff_t delta) {
@@ -388,6 +463,9 @@ void TcpTransport::process(PollService::Event event) {
 
 		case PollService::Event::Timeout: {
 			PLOG_VERBOSE << "TCP is idle";
+			// The receive buffer is only accessed here, release it while idle
+			mRecvMessage.reset();
+			mRecvBufferSize = TCP_MIN_RECV_BUFFER_SIZE;
 			incoming(make_message(0));
 			setPoll(PollService::Direction::In);
 			return;
@@ -402,18 +480,58 @@ void TcpTransport::process(PollService::Event event) {
 		}
 
 		case PollService::Event::In: {
-			const size_t bufferSize = 4096;
-			char buffer[bufferSize];
+			// Read directly into the pooled message, it is reused unless retained upstream
+			if (!mRecvMessage)
+				mRecvMessage = make_message(0);
+
+			// Read until the socket is drained or the max size is reached, then pass all the
+			// data up in a single message
+			auto &buffer = *mRecvMessage;
+			size_t total = 0;
 			int len;
-			while ((len = ::recv(mSock, buffer, bufferSize, 0)) > 0) {
-				auto *b = reinterpret_cast<byte *>(buffer);
-				incoming(make_message(b, b + len));
+			while (true) {
+				// The buffer is only resized when it grows, so it is not zero-filled on each read
+				const size_t size = mRecvBufferSize;
+				if (buffer.size() < total + size)
+					buffer.resize(total + size);
+
+				len = ::recv(mSock, reinterpret_cast<char *>(buffer.data() + total), int(size), 0);
+				if (len <= 0)
+					break;
+
+				total += size_t(len);
+
+				// A short read means the socket is drained, poll will tell if more arrives
+				if (size_t(len) < size)
+					break;
+
+				// The read filled the buffer, so grow the read size under sustained load
+				if (mRecvBufferSize < TCP_MAX_RECV_BUFFER_SIZE)
+					mRecvBufferSize *= 2;
+
+				if (total >= TCP_MAX_RECV_BUFFER_SIZE)
+					break;
 			}
 
+			buffer.resize(total);
+			if (total > 0) {
+				incoming(mRecvMessage);
+
+				if (mRecvMessage.use_count() > 1)
+					mRecvMessage.reset();
+			}
+
+			// Shrink back when the load decreases, and release the buffer if it is much larger
+			if (total < mRecvBufferSize / 4 && mRecvBufferSize > TCP_MIN_RECV_BUFFER_SIZE)
+				mRecvBufferSize /= 2;
+
+			if (mRecvMessage && mRecvMessage->capacity() > 2 * mRecvBufferSize)
+				mRecvMessage.reset();
+
 			if (len == 0)
 				break; // clean close
 
-			if (sockerrno != SEAGAIN && sockerrno != SEWOULDBLOCK) {
+			if (len < 0 && sockerrno != SEAGAIN && sockerrno != SEWOULDBLOCK) {
 				PLOG_WARNING << "TCP connection lost";
 				break;
 			}
@@ -11,13 +11,13 @@
 
 #include "common.hpp"
 #include "pollservice.hpp"
-#include "queue.hpp"
 #include "socket.hpp"
 #include "transport.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
 
 #include <chrono>
+#include <deque>
 #include <list>
 #include <mutex>
 #include <tuple>
@@ -37,6 +37,8 @@ public:
 
 	void start() override;
 	bool send(message_ptr message) override;
+	bool sendSegments(std::vector<message_ptr> segments) override;
+	void hibernate() override;
 
 	void incoming(message_ptr message) override;
 	bool outgoing(message_ptr message) override;
@@ -44,6 +46,9 @@ public:
 	bool isActive() const;
 	string remoteAddress() const;
 
+	// Call func on the socket if nothing is pending in the send queue, returns the result
+	bool configureSocketIfIdle(const std::function<bool(socket_t sock)> &func);
+
 private:
 	void connect();
 	void resolve();
@@ -53,8 +58,7 @@ private:
 	void setPoll(PollService::Direction direction);
 	void close();
 
-	bool trySendQueue();
-	bool trySendMessage(message_ptr &message);
+	bool trySendQueue(size_t added = 0);
 	void updateBufferedAmount(ptrdiff_t delta);
 	void triggerBufferedAmount(size_t amount);
 
@@ -69,9 +73,13 @@ private:
 	std::list<std::tuple<struct sockaddr_storage, socklen_t>> mResolved;
 
 	socket_t mSock;
-	Queue<message_ptr> mSendQueue;
+	std::deque<message_ptr> mSendQueue;
+	size_t mSendOffset = 0; // already sent bytes of the first queued message
 	size_t mBufferedAmount = 0;
 	std::mutex mSendMutex;
+
+	message_ptr mRecvMessage; // pooled receive buffer passed up
+	size_t mRecvBufferSize;   // adaptive read size
 };
 
 } // namespace rtc::impl
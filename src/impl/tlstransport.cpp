@@ -8,6 +8,7 @@
 
 #include "tlstransport.hpp"
 #include "httpproxytransport.hpp"
+#include "ktls.hpp"
 #include "tcptransport.hpp"
 #include "threadpool.hpp"
 
@@ -32,6 +33,28 @@ void TlsTransport::enqueueRecv() {
 	}
 }
 
+bool TlsTransport::sendSegments(std::vector<message_ptr> segments) {
+	if (!mKernelTls)
+		return Transport::sendSegments(std::move(segments)); // concatenate and encrypt
+
+	// The kernel encrypts, so plaintext segments are written directly to the socket
+	if (state() != State::Connected)
+		throw std::runtime_error("TLS is not open");
+
+	return outgoingSegments(std::move(segments));
+}
+
+void TlsTransport::hibernate() {
+#if !USE_GNUTLS && !USE_MBEDTLS && OPENSSL_VERSION_NUMBER >= 0x10101000L
+	{
+		// Record buffers are allocated again by OpenSSL on the next read or write
+		std::lock_guard lock(mSslMutex);
+		SSL_free_buffers(mSsl);
+	}
+#endif
+	Transport::hibernate();
+}
+
 #if USE_GNUTLS
 
 namespace {
@@ -61,12 +84,15 @@ void TlsTransport::Cleanup() {
 
 TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
                            optional<string> host, certificate_ptr certificate,
-                           state_callback callback)
+                           state_callback callback, bool kernelTls)
     : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
                 std::move(callback)),
       mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
 
+	if (kernelTls)
+		PLOG_WARNING << "Kernel TLS is only supported with OpenSSL on Linux";
+
 	PLOG_DEBUG << "Initializing TLS transport (GnuTLS)";
 
 	unsigned int flags = GNUTLS_NONBLOCK | (mIsClient ? GNUTLS_CLIENT : GNUTLS_SERVER);
@@ -315,12 +341,15 @@ void TlsTransport::Cleanup() {
 
 TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
                            optional<string> host, certificate_ptr certificate,
-                           state_callback callback)
+                           state_callback callback, bool kernelTls)
     : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
                 std::move(callback)),
       mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
 
+	if (kernelTls)
+		PLOG_WARNING << "Kernel TLS is only supported with OpenSSL on Linux";
+
 	PLOG_DEBUG << "Initializing TLS transport (MbedTLS)";
 
 	psa_crypto_init();
@@ -570,12 +599,25 @@ void TlsTransport::Cleanup() {
 
 TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
                            optional<string> host, certificate_ptr certificate,
-                           state_callback callback)
+                           state_callback callback, bool kernelTls)
     : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
                 std::move(callback)),
       mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
 
+#if RTC_KTLS_SUPPORTED
+	// Kernel TLS requires direct access to the TCP socket
+	if (kernelTls) {
+		if (std::holds_alternative<shared_ptr<TcpTransport>>(lower))
+			mKernelTlsLower = std::get<shared_ptr<TcpTransport>>(lower);
+		else
+			PLOG_WARNING << "Kernel TLS is not supported through a proxy";
+	}
+#else
+	if (kernelTls)
+		PLOG_WARNING << "Kernel TLS is only supported with OpenSSL on Linux";
+#endif
+
 	PLOG_DEBUG << "Initializing TLS transport (OpenSSL)";
 
 	try {
@@ -615,11 +657,29 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 		SSL_CTX_set_info_callback(mCtx, InfoCallback);
 		SSL_CTX_set_verify(mCtx, SSL_VERIFY_NONE, NULL);
 
+#if RTC_KTLS_SUPPORTED
+		// OpenSSL moves the sending record layer to the kernel when switching to traffic keys,
+		// if the kernel supports the protocol version and the cipher
+		if (mKernelTlsLower)
+			SSL_CTX_set_options(mCtx, SSL_OP_ENABLE_KTLS);
+#endif
+
 		if (!(mSsl = SSL_new(mCtx)))
 			throw std::runtime_error("Failed to create SSL instance");
 
 		SSL_set_ex_data(mSsl, TransportExIndex, this);
 
+#if RTC_KTLS_SUPPORTED
+		if (mKernelTlsLower) {
+			// Session tickets would be written after the switch to kernel TLS, and the handshake
+			// would stall if the socket were busy
+			if (!mIsClient)
+				SSL_set_num_tickets(mSsl, 0);
+
+			SSL_set_msg_callback(mSsl, MessageCallback);
+		}
+#endif
+
 		if (mIsClient && mHost) {
 			SSL_set_hostflags(mSsl, 0);
 			openssl::check(SSL_set1_host(mSsl, mHost->c_str()), "Failed to set SSL host");
@@ -633,11 +693,31 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 		else
 			SSL_set_accept_state(mSsl);
 
-		if (!(mInBio = BIO_new(BIO_s_mem())) || !(mOutBio = BIO_new(BIO_s_mem())))
+		if (!(mInBio = BIO_new(BIO_s_mem())))
 			throw std::runtime_error("Failed to create BIO");
 
+		mOutBio = nullptr;
+#if RTC_KTLS_SUPPORTED
+		// Records are written to the TCP socket through a BIO able to set up kernel TLS
+		if (mKernelTlsLower) {
+			mOutBio = ktls::NewWriteBio(mKernelTlsLower, [this](message_ptr message) {
+				return mOutgoingResult = outgoing(std::move(message));
+			});
+			if (!mOutBio) {
+				PLOG_WARNING << "TCP socket is not available for kernel TLS";
+				mKernelTlsLower.reset();
+			}
+		}
+#endif
+		if (!mOutBio) {
+			if (!(mOutBio = BIO_new(BIO_s_mem()))) {
+				BIO_free(mInBio);
+				throw std::runtime_error("Failed to create BIO");
+			}
+			BIO_set_mem_eof_return(mOutBio, BIO_EOF);
+		}
+
 		BIO_set_mem_eof_return(mInBio, BIO_EOF);
-		BIO_set_mem_eof_return(mOutBio, BIO_EOF);
 		SSL_set_bio(mSsl, mInBio, mOutBio);
 
 	} catch (...) {
@@ -685,7 +765,7 @@ bool TlsTransport::send(message_ptr message) {
 	if (state() != State::Connected)
 		throw std::runtime_error("TLS is not open");
 
-	if (!message || message->size() == 0)
+	if (!message || message->size() == 0 || mKernelTls)
 		return outgoing(message); // pass through
 
 	PLOG_VERBOSE << "Send size=" << message->size();
@@ -758,6 +838,13 @@ void TlsTransport::doRecv() {
 
 				if (openssl::check_error(err, "Handshake failed")) {
 					PLOG_INFO << "TLS handshake finished";
+#if RTC_KTLS_SUPPORTED
+					// Application data is then sent in plaintext and encrypted by the kernel
+					if (mKernelTlsLower && BIO_get_ktls_send(mOutBio)) {
+						PLOG_INFO << "Kernel TLS enabled for sending";
+						mKernelTls = true;
+					}
+#endif
 					changeState(State::Connected);
 					postHandshake();
 				}
@@ -791,6 +878,11 @@ void TlsTransport::doRecv() {
 
 		std::lock_guard lock(mSslMutex);
 		SSL_shutdown(mSsl);
+		try {
+			flushOutput(); // send the close_notify alert
+		} catch (const std::exception &e) {
+			PLOG_DEBUG << "TLS close_notify not sent: " << e.what();
+		}
 
 	} catch (const std::exception &e) {
 		PLOG_ERROR << "TLS recv: " << e.what();
@@ -808,6 +900,12 @@ void TlsTransport::doRecv() {
 
 bool TlsTransport::flushOutput() {
 	// Requires mSslMutex to be locked
+#if RTC_KTLS_SUPPORTED
+	// The write BIO for kernel TLS passes records as they are written
+	if (mKernelTlsLower)
+		return mOutgoingResult;
+#endif
+
 	bool result = true;
 	const size_t bufferSize = 4096;
 	byte buffer[bufferSize];
@@ -818,6 +916,24 @@ bool TlsTransport::flushOutput() {
 	return result;
 }
 
+#if RTC_KTLS_SUPPORTED
+
+void TlsTransport::MessageCallback(int writeP, int /*version*/, int contentType,
+                                   const void * /*buf*/, size_t /*len*/, SSL *ssl, void * /*arg*/) {
+	// Called with mSslMutex locked
+	TlsTransport *t =
+	    static_cast<TlsTransport *>(SSL_get_ex_data(ssl, TlsTransport::TransportExIndex));
+
+	// The only post-handshake message sent is a key update as session tickets are disabled, but
+	// the kernel can't switch to the next traffic secret, so the peer would fail to decrypt
+	if (writeP && t->mKernelTls && contentType == SSL3_RT_HANDSHAKE) {
+		PLOG_WARNING << "TLS key update can't be followed with kernel TLS, closing";
+		t->mIncomingQueue.stop();
+	}
+}
+
+#endif
+
 void TlsTransport::InfoCallback(const SSL *ssl, int where, int ret) {
 	TlsTransport *t =
 	    static_cast<TlsTransport *>(SSL_get_ex_data(ssl, TlsTransport::TransportExIndex));
@@ -11,6 +11,7 @@
 
 #include "certificate.hpp"
 #include "common.hpp"
+#include "ktls.hpp"
 #include "queue.hpp"
 #include "tls.hpp"
 #include "transport.hpp"
@@ -31,12 +32,15 @@ public:
 	static void Cleanup();
 
 	TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
-	             optional<string> host, certificate_ptr certificate, state_callback callback);
+	             optional<string> host, certificate_ptr certificate, state_callback callback,
+	             bool kernelTls = false);
 	virtual ~TlsTransport();
 
 	void start() override;
 	void stop() override;
 	bool send(message_ptr message) override;
+	bool sendSegments(std::vector<message_ptr> segments) override;
+	void hibernate() override;
 
 	bool isClient() const { return mIsClient; }
 
@@ -54,6 +58,7 @@ protected:
 	Queue<message_ptr> mIncomingQueue;
 	std::atomic<int> mPendingRecvCount = 0;
 	std::mutex mRecvMutex;
+	std::atomic<bool> mKernelTls = false; // the kernel encrypts outgoing records
 
 #if USE_GNUTLS
 	gnutls_session_t mSession;
@@ -92,6 +97,14 @@ protected:
 	static int TransportExIndex;
 
 	static void InfoCallback(const SSL *ssl, int where, int ret);
+
+#if RTC_KTLS_SUPPORTED
+	shared_ptr<TcpTransport> mKernelTlsLower;
+	std::atomic<bool> mOutgoingResult = true;
+
+	static void MessageCallback(int writeP, int version, int contentType, const void *buf,
+	                            size_t len, SSL *ssl, void *arg);
+#endif
 #endif
 };
 
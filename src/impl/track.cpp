@@ -11,6 +11,7 @@
 #include "logcounter.hpp"
 #include "peerconnection.hpp"
 #include "rtp.hpp"
+#include "rtpextensionmap.hpp"
 
 namespace rtc::impl {
 
@@ -19,8 +20,21 @@ static LogCounter COUNTER_MEDIA_BAD_DIRECTION(plog::warning,
 static LogCounter COUNTER_QUEUE_FULL(plog::warning,
                                      "Number of media packets dropped due to a full queue");
 
+namespace {
+
+uint8_t TransportSequenceNumberId([[maybe_unused]] const Description::Media &desc) {
+#if RTC_ENABLE_MEDIA
+	return RtpExtensionMap(desc).id(RtpExtensionMap::Extension::TransportSequenceNumber);
+#else
+	return 0;
+#endif
+}
+
+} // namespace
+
 Track::Track(weak_ptr<PeerConnection> pc, Description::Media desc)
     : mPeerConnection(pc), mMediaDescription(std::move(desc)),
+      mTransportSequenceNumberId(TransportSequenceNumberId(mMediaDescription)),
       mRecvQueue(RECV_QUEUE_LIMIT, [](const message_ptr &m) { return m->size(); }) {
 
 	// Discard messages by default if track is send only
@@ -59,6 +73,7 @@ void Track::setDescription(Description::Media desc) {
 			throw std::logic_error("Media description mid does not match track mid");
 
 		mMediaDescription = std::move(desc);
+		mTransportSequenceNumberId = TransportSequenceNumberId(mMediaDescription);
 	}
 
 	if (auto handler = getMediaHandler())
@@ -141,7 +156,18 @@ void Track::incoming(message_ptr message) {
 		return;
 	}
 
-	message_vector messages{std::move(message)};
+	processIncoming(message_vector{std::move(message)});
+}
+
+void Track::pollIncoming() {
+	if (!mIsClosed)
+		processIncoming(message_vector());
+}
+
+void Track::processIncoming(message_vector messages) {
+	// Handlers are also polled from timers, the chain must not run concurrently
+	std::lock_guard lock(mIncomingMutex);
+
 	if (auto handler = getMediaHandler()) {
 		try {
 			handler->incomingChain(messages, [this, weak_this = weak_from_this()](message_ptr m) {
@@ -206,6 +232,7 @@ bool Track::outgoing(message_ptr message) {
 bool Track::transportSend([[maybe_unused]] message_ptr message) {
 #if RTC_ENABLE_MEDIA
 	shared_ptr<DtlsSrtpTransport> transport;
+	uint8_t transportSequenceNumberId;
 	{
 		std::shared_lock lock(mMutex);
 		transport = mDtlsSrtpTransport.lock();
@@ -218,22 +245,33 @@ bool Track::transportSend([[maybe_unused]] message_ptr message) {
 			message->dscp = 46; // EF: Expedited Forwarding
 		else
 			message->dscp = 36; // AF42: Assured Forwarding class 4, medium drop probability
+
+		transportSequenceNumberId = mTransportSequenceNumberId;
 	}
 
-	return transport->sendMedia(message);
+	return transport->sendMedia(message, transportSequenceNumberId);
 #else
 	throw std::runtime_error("Track is disabled (not compiled with media support)");
 #endif
 }
 
 void Track::setMediaHandler(shared_ptr<MediaHandler> handler) {
+	shared_ptr<MediaHandler> previous;
 	{
 		std::unique_lock lock(mMutex);
-		mMediaHandler = handler;
+		previous = std::exchange(mMediaHandler, handler);
 	}
 
-	if (handler)
+	if (previous && previous != handler)
+		previous->setPollCallback(nullptr);
+
+	if (handler) {
+		handler->setPollCallback([weak_this = weak_from_this()]() {
+			if (auto locked = weak_this.lock())
+				locked->pollIncoming();
+		});
 		handler->media(description());
+	}
 }
 
 shared_ptr<MediaHandler> Track::getMediaHandler() {
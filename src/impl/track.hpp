@@ -20,6 +20,7 @@
 #endif
 
 #include <atomic>
+#include <mutex>
 #include <shared_mutex>
 
 namespace rtc::impl {
@@ -33,6 +34,7 @@ public:
 
 	void close();
 	void incoming(message_ptr message);
+	void pollIncoming();
 	bool outgoing(message_ptr message);
 
 	optional<message_variant> receive() override;
@@ -64,6 +66,8 @@ public:
 	synchronized_callback<binary, FrameInfo> frameCallback;
 
 private:
+	void processIncoming(message_vector messages);
+
 	const weak_ptr<PeerConnection> mPeerConnection;
 #if RTC_ENABLE_MEDIA
 	weak_ptr<DtlsSrtpTransport> mDtlsSrtpTransport;
@@ -71,8 +75,10 @@ private:
 
 	Description::Media mMediaDescription;
 	shared_ptr<MediaHandler> mMediaHandler;
+	uint8_t mTransportSequenceNumberId = 0; // negotiated ID, 0 if not negotiated
 
 	mutable std::shared_mutex mMutex;
+	std::mutex mIncomingMutex;
 
 	std::atomic<bool> mIsClosed = false;
 
@@ -50,6 +50,30 @@ void Transport::stop() { unregisterIncoming(); }
 
 bool Transport::send(message_ptr message) { return outgoing(message); }
 
+void Transport::hibernate() {
+	if (mLower)
+		mLower->hibernate();
+}
+
+bool Transport::sendSegments(std::vector<message_ptr> segments) {
+	if (segments.empty())
+		return send(nullptr);
+
+	if (segments.size() == 1)
+		return send(std::move(segments.front()));
+
+	size_t size = 0;
+	for (const auto &segment : segments)
+		size += segment->size();
+
+	auto message = make_message(size, segments.front()->type);
+	auto it = message->begin();
+	for (const auto &segment : segments)
+		it = std::copy(segment->begin(), segment->end(), it);
+
+	return send(std::move(message));
+}
+
 void Transport::recv(message_ptr message) {
 	try {
 		mRecvCallback(message);
@@ -76,4 +100,11 @@ bool Transport::outgoing(message_ptr message) {
 		return false;
 }
 
+bool Transport::outgoingSegments(std::vector<message_ptr> segments) {
+	if (mLower)
+		return mLower->sendSegments(std::move(segments));
+	else
+		return false;
+}
+
 } // namespace rtc::impl
@@ -17,6 +17,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace rtc::impl {
 
@@ -39,11 +40,20 @@ public:
 	virtual void stop();
 	virtual bool send(message_ptr message);
 
+	// Send segments as a single contiguous unit, they are concatenated unless the transport
+	// supports gather writes
+	virtual bool sendSegments(std::vector<message_ptr> segments);
+
+	// Release memory held while the connection is idle, called on the receive path
+	// The lower transport is hibernated too, and buffers are allocated again on demand
+	virtual void hibernate();
+
 protected:
 	void recv(message_ptr message);
 	void changeState(State state);
 	virtual void incoming(message_ptr message);
 	virtual bool outgoing(message_ptr message);
+	bool outgoingSegments(std::vector<message_ptr> segments);
 
 private:
 	const init_token mInitToken = Init::Instance().token();
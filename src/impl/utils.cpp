@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <cmath>
 #include <functional>
 #include <iterator>
 #include <sstream>
@@ -55,6 +56,13 @@ string implode(const std::vector<string> &tokens, char delim) {
 	return result;
 }
 
+bool iequals(std::string_view a, std::string_view b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+		       return std::tolower(static_cast<unsigned char>(x)) ==
+		              std::tolower(static_cast<unsigned char>(y));
+	       });
+}
+
 string url_decode(const string &str) {
 	string result;
 	size_t i = 0;
@@ -140,6 +148,12 @@ std::seed_seq random_seed() {
 	return std::seed_seq(seed.begin(), seed.end());
 }
 
+uint64_t ntp_time(std::chrono::system_clock::time_point time) {
+	const double secs = std::chrono::duration<double>(time.time_since_epoch()).count();
+	// Assume the epoch is 01/01/1970 and adds the number of seconds between 1900 and 1970
+	return uint64_t(std::floor((secs + 2208988800.) * double(uint64_t(1) << 32)));
+}
+
 namespace {
 
 void thread_set_name_self(const char *name) {
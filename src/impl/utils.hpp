@@ -11,11 +11,13 @@
 
 #include "common.hpp"
 
+#include <chrono>
 #include <climits>
 #include <limits>
 #include <map>
 #include <random>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 namespace rtc::impl::utils {
@@ -23,6 +25,9 @@ namespace rtc::impl::utils {
 std::vector<string> explode(const string &str, char delim);
 string implode(const std::vector<string> &tokens, char delim);
 
+// Compare ASCII strings case-insensitively
+bool iequals(std::string_view a, std::string_view b);
+
 // Decode URL percent-encoding (RFC 3986)
 // See https://www.rfc-editor.org/rfc/rfc3986.html#section-2.1
 string url_decode(const string &str);
@@ -34,6 +39,10 @@ string base64_encode(const binary &data);
 // Return a random seed sequence
 std::seed_seq random_seed();
 
+// Return a time as a 64-bit NTP timestamp, in seconds since 1900 as 32.32 fixed-point
+// See https://www.rfc-editor.org/rfc/rfc5905.html#section-6
+uint64_t ntp_time(std::chrono::system_clock::time_point time = std::chrono::system_clock::now());
+
 template <typename Generator, typename Result = typename Generator::result_type>
 struct random_engine_wrapper {
 	Generator &engine;
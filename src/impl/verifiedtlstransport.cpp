@@ -17,8 +17,10 @@ static const string PemBeginCertificateTag = "-----BEGIN CERTIFICATE-----";
 
 VerifiedTlsTransport::VerifiedTlsTransport(
     variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower, string host,
-    certificate_ptr certificate, state_callback callback, [[maybe_unused]] optional<string> cacert)
-    : TlsTransport(std::move(lower), std::move(host), std::move(certificate), std::move(callback)) {
+    certificate_ptr certificate, state_callback callback, [[maybe_unused]] optional<string> cacert,
+    bool kernelTls)
+    : TlsTransport(std::move(lower), std::move(host), std::move(certificate), std::move(callback),
+                   kernelTls) {
 
 	PLOG_DEBUG << "Setting up TLS certificate verification";
 
@@ -19,7 +19,7 @@ class VerifiedTlsTransport final : public TlsTransport {
 public:
 	VerifiedTlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
 	                     string host, certificate_ptr certificate, state_callback callback,
-	                     optional<string> cacert);
+	                     optional<string> cacert, bool kernelTls = false);
 	~VerifiedTlsTransport();
 
 private:
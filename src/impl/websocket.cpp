@@ -11,7 +11,9 @@
 #include "websocket.hpp"
 #include "common.hpp"
 #include "internals.hpp"
+#include "pollservice.hpp"
 #include "processor.hpp"
+#include "threadpool.hpp"
 #include "utils.hpp"
 
 #include "httpproxytransport.hpp"
@@ -64,6 +66,17 @@ WebSocket::WebSocket(optional<Configuration> optConfig, certificate_ptr certific
 			PLOG_WARNING << "HTTP authentication support for proxy is not implemented";
 		}
 	}
+
+	if (config.sendHighWatermark) {
+		if (*config.sendHighWatermark == 0)
+			throw std::invalid_argument("Send high watermark must be positive");
+
+		const size_t low = sendLowWatermark();
+		if (low > *config.sendHighWatermark)
+			throw std::invalid_argument("Send low watermark must not exceed the high watermark");
+
+		bufferedAmountLowThreshold = low;
+	}
 }
 
 WebSocket::~WebSocket() { PLOG_VERBOSE << "Destroying WebSocket"; }
@@ -178,16 +191,186 @@ size_t WebSocket::availableAmount() const { return mRecvQueue.amount(); }
 
 bool WebSocket::changeState(State newState) { return state.exchange(newState) != newState; }
 
-bool WebSocket::outgoing(message_ptr message) {
+bool WebSocket::outgoing(message_ptr message, WsTransport::SharedFrames *frames) {
 	if (state != State::Open || !mWsTransport)
 		throw std::runtime_error("WebSocket is not open");
 
 	if (message->size() > maxMessageSize())
 		throw std::runtime_error("Message size exceeds limit");
 
-	return mWsTransport->send(message);
+	if (!config.sendHighWatermark)
+		return sendNow(std::move(message), frames);
+
+	using OverflowPolicy = Configuration::OverflowPolicy;
+	const size_t high = *config.sendHighWatermark;
+	const size_t low = sendLowWatermark();
+	const size_t size = message->size();
+
+	std::unique_lock lock(mSendMutex);
+	auto fits = [&]() {
+		const size_t transportAmount = mTransportAmount.load();
+		return mPendingQueue.empty() && (transportAmount == 0 || transportAmount + size <= high);
+	};
+
+	if (fits())
+		return sendNow(std::move(message), frames);
+
+	switch (config.overflowPolicy) {
+	case OverflowPolicy::Block:
+		// Blocking the poll thread would prevent the transport from draining, and a broadcast
+		// must not be blocked by a single client, so the message is queued instead
+		if (frames || PollService::Instance().isPollThread())
+			break;
+
+		while (!(mPendingQueue.empty() && mTransportAmount.load() <= low)) {
+			if (state != State::Open)
+				throw std::runtime_error("WebSocket is not open");
+
+			// Woken up by triggerBufferedAmount(), flushPendingQueue(), or closeTransports()
+			lock.unlock();
+			{
+				std::unique_lock conditionLock(mSendConditionMutex);
+				mSendCondition.wait(conditionLock, [&]() {
+					return state != State::Open ||
+					       (mPendingAmount.load() == 0 && mTransportAmount.load() <= low);
+				});
+			}
+			lock.lock();
+		}
+		return sendNow(std::move(message));
+
+	case OverflowPolicy::DropNewest:
+		dropMessage(message);
+		return false;
+
+	case OverflowPolicy::DropOldest:
+		break;
+
+	case OverflowPolicy::Close:
+		lock.unlock();
+		PLOG_WARNING << "WebSocket send buffer is full, closing";
+		close();
+		return false;
+	}
+
+	mPendingQueue.push_back(std::move(message));
+	mPendingAmount += size;
+
+	// Keep at least the new message, even if it exceeds the high watermark on its own
+	while (mPendingQueue.size() > 1 && mTransportAmount.load() + mPendingAmount.load() > high) {
+		dropMessage(mPendingQueue.front());
+		mPendingAmount -= mPendingQueue.front()->size();
+		mPendingQueue.pop_front();
+	}
+
+	updateBufferedAmount();
+
+	// The transport might have drained before the message was queued
+	if (mTransportAmount.load() <= low)
+		schedulePendingFlush();
+
+	return false;
+}
+
+bool WebSocket::sendNow(message_ptr message, WsTransport::SharedFrames *frames) {
+	// mSendMutex must be locked if a high watermark is set
+	auto transport = std::atomic_load(&mWsTransport);
+	if (!transport)
+		throw std::runtime_error("WebSocket is not open");
+
+	const size_t size = message->size();
+	bool sent = frames ? transport->sendShared(std::move(message), *frames)
+	                   : transport->send(std::move(message));
+	mBytesSent += size;
+	return sent;
+}
+
+void WebSocket::notifySendCondition() {
+	// Lock so a waiter can't miss the notification between checking and waiting
+	{ std::lock_guard lock(mSendConditionMutex); }
+	mSendCondition.notify_all();
+}
+
+void WebSocket::dropMessage(const message_ptr &message) {
+	PLOG_VERBOSE << "Dropping WebSocket message, size=" << message->size();
+	mBytesDropped += message->size();
+	++mMessagesDropped;
+}
+
+void WebSocket::triggerBufferedAmount(size_t amount) {
+	if (!config.sendHighWatermark) {
+		Channel::triggerBufferedAmount(amount);
+		return;
+	}
+
+	// This is called synchronously by the TCP transport with its send lock held, so queued
+	// messages and the low threshold callback are handled on the thread pool, which also allows
+	// sending from the callback
+	mTransportAmount = amount;
+	notifySendCondition();
+
+	const size_t pendingAmount = mPendingAmount.load();
+	const size_t total = amount + pendingAmount;
+	const bool crossing = total <= bufferedAmountLowThreshold.load() &&
+	                      bufferedAmount.load() > bufferedAmountLowThreshold.load();
+	if ((pendingAmount > 0 && amount <= sendLowWatermark()) || crossing)
+		schedulePendingFlush();
+	else
+		bufferedAmount = total;
+}
+
+void WebSocket::schedulePendingFlush() {
+	if (mFlushScheduled.exchange(true))
+		return;
+
+	ThreadPool::Instance().enqueue([weak_this = weak_from_this()]() {
+		if (auto locked = weak_this.lock())
+			locked->flushPendingQueue();
+	});
+}
+
+void WebSocket::flushPendingQueue() {
+	mFlushScheduled = false;
+	{
+		std::lock_guard lock(mSendMutex);
+		const size_t high = *config.sendHighWatermark;
+		while (!mPendingQueue.empty() && state == State::Open) {
+			const size_t transportAmount = mTransportAmount.load();
+			auto &message = mPendingQueue.front();
+			if (transportAmount > 0 && transportAmount + message->size() > high)
+				break;
+
+			auto next = std::move(message);
+			mPendingQueue.pop_front();
+			mPendingAmount -= next->size();
+			try {
+				sendNow(std::move(next));
+			} catch (const std::exception &e) {
+				PLOG_WARNING << "WebSocket queued send failed: " << e.what();
+				break;
+			}
+		}
+	}
+
+	notifySendCondition();
+	Channel::triggerBufferedAmount(mTransportAmount.load() + mPendingAmount.load());
 }
 
+void WebSocket::updateBufferedAmount() {
+	// The callback is not triggered as the amount only decreases on flush
+	bufferedAmount = mTransportAmount.load() + mPendingAmount.load();
+}
+
+size_t WebSocket::sendLowWatermark() const {
+	return config.sendLowWatermark.value_or(config.sendHighWatermark.value_or(0) / 2);
+}
+
+size_t WebSocket::bytesSent() const { return mBytesSent.load(); }
+
+size_t WebSocket::bytesDropped() const { return mBytesDropped.load(); }
+
+size_t WebSocket::messagesDropped() const { return mMessagesDropped.load(); }
+
 void WebSocket::incoming(message_ptr message) {
 	if (!message) {
 		remoteClose();
@@ -261,10 +444,13 @@ shared_ptr<TcpTransport> WebSocket::setTcpTransport(shared_ptr<TcpTransport> tra
 			}
 		});
 
-		// WS transport sends a ping on read timeout
-		auto pingInterval = config.pingInterval.value_or(10000ms);
+		// WS transport sends a ping on read timeout, and hibernates if idle for long enough
+		auto pingInterval = config.pingInterval.value_or(DEFAULT_WS_PING_INTERVAL);
+		auto hibernationTimeout = config.hibernationTimeout.value_or(milliseconds::zero());
 		if (pingInterval > milliseconds::zero())
 			transport->setReadTimeout(pingInterval);
+		else if (hibernationTimeout > milliseconds::zero())
+			transport->setReadTimeout(hibernationTimeout);
 
 		scheduleConnectionTimeout();
 
@@ -379,12 +565,12 @@ shared_ptr<TlsTransport> WebSocket::initTlsTransport() {
 
 		shared_ptr<TlsTransport> transport;
 		if (verify)
-			transport = std::make_shared<VerifiedTlsTransport>(lower, mHostname.value(),
-			                                                   mCertificate, stateChangeCallback,
-			                                                   config.caCertificatePemFile);
+			transport = std::make_shared<VerifiedTlsTransport>(
+			    lower, mHostname.value(), mCertificate, stateChangeCallback,
+			    config.caCertificatePemFile, config.enableKernelTls);
 		else
-			transport =
-			    std::make_shared<TlsTransport>(lower, mHostname, mCertificate, stateChangeCallback);
+			transport = std::make_shared<TlsTransport>(lower, mHostname, mCertificate,
+			                                           stateChangeCallback, config.enableKernelTls);
 
 		return emplaceTransport(this, &mTlsTransport, std::move(transport));
 
@@ -498,6 +684,13 @@ void WebSocket::closeTransports() {
 	if (tcp)
 		tcp->onBufferedAmount(nullptr);
 
+	{
+		std::lock_guard lock(mSendMutex);
+		mPendingQueue.clear();
+		mPendingAmount = 0;
+	}
+	notifySendCondition();
+
 	using array = std::array<shared_ptr<Transport>, 3>;
 	array transports{std::move(ws), std::move(tls), std::move(tcp)};
 
@@ -24,6 +24,9 @@
 #include "rtc/websocket.hpp"
 
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
 
 namespace rtc::impl {
@@ -38,7 +41,8 @@ struct WebSocket final : public Channel, public std::enable_shared_from_this<Web
 	void open(const string &url);
 	void close();
 	void remoteClose();
-	bool outgoing(message_ptr message);
+	// If frames is set, the message is broadcast and frames are shared, see WsTransport::sendShared
+	bool outgoing(message_ptr message, WsTransport::SharedFrames *frames = nullptr);
 	void incoming(message_ptr message);
 
 	optional<message_variant> receive() override;
@@ -49,6 +53,11 @@ struct WebSocket final : public Channel, public std::enable_shared_from_this<Web
 	bool isClosed() const;
 	size_t maxMessageSize() const;
 
+	void triggerBufferedAmount(size_t amount) override;
+	size_t bytesSent() const;
+	size_t bytesDropped() const;
+	size_t messagesDropped() const;
+
 	bool changeState(State state);
 
 	shared_ptr<TcpTransport> setTcpTransport(shared_ptr<TcpTransport> transport);
@@ -71,6 +80,14 @@ private:
 
 	void scheduleConnectionTimeout();
 
+	bool sendNow(message_ptr message, WsTransport::SharedFrames *frames = nullptr);
+	void notifySendCondition();
+	void dropMessage(const message_ptr &message);
+	void flushPendingQueue();
+	void schedulePendingFlush();
+	void updateBufferedAmount();
+	size_t sendLowWatermark() const;
+
 	const init_token mInitToken = Init::Instance().token();
 
 	certificate_ptr mCertificate;
@@ -86,6 +103,20 @@ private:
 	shared_ptr<WsHandshake> mWsHandshake;
 
 	Queue<message_ptr> mRecvQueue;
+
+	// Messages held back by the high watermark, only used with the drop-oldest policy or when
+	// blocking is not possible
+	std::deque<message_ptr> mPendingQueue;
+	std::atomic<size_t> mPendingAmount = 0;
+	std::atomic<size_t> mTransportAmount = 0; // buffered amount of the TCP transport
+	std::atomic<bool> mFlushScheduled = false;
+	std::mutex mSendMutex;
+	std::mutex mSendConditionMutex; // never held while sending, so it can be locked on callbacks
+	std::condition_variable mSendCondition;
+
+	std::atomic<size_t> mBytesSent = 0;
+	std::atomic<size_t> mBytesDropped = 0;
+	std::atomic<size_t> mMessagesDropped = 0;
 };
 
 } // namespace rtc::impl
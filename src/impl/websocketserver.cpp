@@ -46,11 +46,25 @@ WebSocketServer::WebSocketServer(Configuration config_)
 	if (config.bindAddress) {
 		bindAddress = config.bindAddress->c_str();
 	}
-	// Create TCP server
-	tcpServer = std::make_unique<TcpServer>(config.port, bindAddress);
+	// Create TCP servers, additional ones listen on the same port as the first one
+	unsigned int count = std::max(config.acceptThreads, 1u);
+	if (count > 1 && !TcpServer::IsReusePortSupported()) {
+		PLOG_WARNING << "SO_REUSEPORT is not supported, using a single accept thread";
+		count = 1;
+	}
+
+	const bool reusePort = count > 1;
+	tcpServers.push_back(
+	    std::make_unique<TcpServer>(config.port, bindAddress, config.listenBacklog, reusePort));
+
+	const uint16_t port = tcpServers.front()->port();
+	while (tcpServers.size() < count)
+		tcpServers.push_back(
+		    std::make_unique<TcpServer>(port, bindAddress, config.listenBacklog, reusePort));
 
-	// Create server thread
-	mThread = std::thread(&WebSocketServer::runLoop, this);
+	// Create server threads
+	for (auto &tcpServer : tcpServers)
+		mThreads.emplace_back(&WebSocketServer::runLoop, this, tcpServer.get());
 }
 
 WebSocketServer::~WebSocketServer() {
@@ -62,32 +76,73 @@ void WebSocketServer::stop() {
 	if (mStopped.exchange(true))
 		return;
 
-	PLOG_DEBUG << "Stopping WebSocketServer thread";
-	tcpServer->close();
-	mThread.join();
+	PLOG_DEBUG << "Stopping WebSocketServer threads";
+	for (auto &tcpServer : tcpServers)
+		tcpServer->close();
+
+	for (auto &thread : mThreads)
+		thread.join();
+}
+
+size_t WebSocketServer::broadcast(const std::vector<shared_ptr<WebSocket>> &clients,
+                                  message_ptr message) {
+	// Server frames are not masked, so the framed message is identical for all clients, except
+	// for compressed ones with context takeover which are framed separately
+	using OverflowPolicy = WebSocket::Configuration::OverflowPolicy;
+	WsTransport::SharedFrames frames;
+	size_t count = 0;
+	for (const auto &ws : clients) {
+		if (!ws->isOpen())
+			continue;
+
+		if (message->size() > ws->maxMessageSize()) {
+			PLOG_WARNING << "Broadcast message size exceeds limit for a client";
+			continue;
+		}
+
+		try {
+			// Go through the WebSocket so the message is queued behind pending ones and counted,
+			// and the overflow policy of the client applies
+			const size_t dropped = ws->messagesDropped();
+			ws->outgoing(message, &frames);
+
+			// Only DropNewest drops the message itself, DropOldest drops older ones
+			if (ws->isOpen() && (ws->config.overflowPolicy != OverflowPolicy::DropNewest ||
+			                     ws->messagesDropped() == dropped))
+				++count;
+
+		} catch (const std::exception &e) {
+			PLOG_WARNING << "WebSocket broadcast failed for a client: " << e.what();
+		}
+	}
+
+	PLOG_VERBOSE << "Broadcast to " << count << " clients with " << frames.size()
+	             << " distinct frames";
+	return count;
 }
 
-void WebSocketServer::runLoop() {
+void WebSocketServer::runLoop(TcpServer *tcpServer) {
 	utils::this_thread::set_name("RTC server");
 	PLOG_INFO << "Starting WebSocketServer";
 
 	try {
-		while (auto incoming = tcpServer->accept()) {
-			try {
-				if (!clientCallback)
+		std::vector<socket_t> incoming;
+		while (!(incoming = tcpServer->accept(TCP_ACCEPT_BATCH_SIZE)).empty()) {
+			// Hand over connections to the thread pool so the accept loop is never blocked by
+			// transport setup. Until the server is shared, they are processed on this thread.
+			auto weak_this = weak_from_this();
+			for (socket_t sock : incoming) {
+				if (weak_this.expired()) {
+					processIncoming(sock);
 					continue;
-
-				WebSocket::Configuration clientConfig;
-				clientConfig.connectionTimeout = config.connectionTimeout;
-				clientConfig.maxMessageSize = config.maxMessageSize;
-
-				auto impl = std::make_shared<WebSocket>(std::move(clientConfig), mCertificate);
-				impl->changeState(WebSocket::State::Connecting);
-				impl->setTcpTransport(incoming);
-				clientCallback(std::make_shared<rtc::WebSocket>(impl));
-
-			} catch (const std::exception &e) {
-				PLOG_ERROR << "WebSocketServer: " << e.what();
+				}
+
+				ThreadPool::Instance().enqueue([weak_this, sock]() {
+					if (auto shared_this = weak_this.lock())
+						shared_this->processIncoming(sock);
+					else
+						::closesocket(sock);
+				});
 			}
 		}
 	} catch (const std::exception &e) {
@@ -97,6 +152,62 @@ void WebSocketServer::runLoop() {
 	PLOG_INFO << "Stopped WebSocketServer";
 }
 
+void WebSocketServer::processIncoming(socket_t sock) {
+	if (mStopped || !clientCallback) {
+		::closesocket(sock);
+		return;
+	}
+
+	shared_ptr<TcpTransport> transport;
+	try {
+		transport = std::make_shared<TcpTransport>(sock, nullptr); // no state callback
+
+	} catch (const std::exception &e) {
+		PLOG_WARNING << e.what();
+		::closesocket(sock);
+		return;
+	}
+
+	try {
+		WebSocket::Configuration clientConfig;
+		clientConfig.connectionTimeout = config.connectionTimeout;
+		clientConfig.maxMessageSize = config.maxMessageSize;
+		clientConfig.enableUtf8Validation = config.enableUtf8Validation;
+		clientConfig.enableKernelTls = config.enableKernelTls;
+		clientConfig.sendHighWatermark = config.sendHighWatermark;
+		clientConfig.sendLowWatermark = config.sendLowWatermark;
+		clientConfig.overflowPolicy = config.overflowPolicy;
+		clientConfig.hibernationTimeout = config.hibernationTimeout;
+		clientConfig.enableDeflate = config.enableDeflate;
+		clientConfig.disableDeflateContextTakeover = config.disableDeflateContextTakeover;
+		clientConfig.deflateMemoryLimit = config.deflateMemoryLimit;
+
+		auto impl = std::make_shared<WebSocket>(std::move(clientConfig), mCertificate);
+		impl->changeState(WebSocket::State::Connecting);
+		impl->setTcpTransport(transport);
+
+		// Connections are set up concurrently on the thread pool, but the client callback is
+		// called for one client at a time, in order
+		auto ws = std::make_shared<rtc::WebSocket>(impl);
+		if (auto shared_this = weak_from_this().lock())
+			mClientProcessor.enqueue(&WebSocketServer::triggerClient, std::move(shared_this),
+			                         std::move(ws));
+		else
+			triggerClient(std::move(ws)); // not shared yet, so on the server thread
+
+	} catch (const std::exception &e) {
+		PLOG_ERROR << "WebSocketServer: " << e.what();
+	}
+}
+
+void WebSocketServer::triggerClient(shared_ptr<rtc::WebSocket> ws) {
+	try {
+		clientCallback(std::move(ws));
+	} catch (const std::exception &e) {
+		PLOG_WARNING << "Uncaught exception in WebSocketServer client callback: " << e.what();
+	}
+}
+
 } // namespace rtc::impl
 
 #endif
@@ -15,6 +15,7 @@
 #include "common.hpp"
 #include "init.hpp"
 #include "message.hpp"
+#include "processor.hpp"
 #include "tcpserver.hpp"
 #include "websocket.hpp"
 
@@ -23,6 +24,7 @@
 
 #include <atomic>
 #include <thread>
+#include <vector>
 
 namespace rtc::impl {
 
@@ -33,19 +35,23 @@ struct WebSocketServer final : public std::enable_shared_from_this<WebSocketServ
 	~WebSocketServer();
 
 	void stop();
+	size_t broadcast(const std::vector<shared_ptr<WebSocket>> &clients, message_ptr message);
 
 	const Configuration config;
-	unique_ptr<TcpServer> tcpServer;
+	std::vector<unique_ptr<TcpServer>> tcpServers; // the first one is always present
 	synchronized_callback<shared_ptr<rtc::WebSocket>> clientCallback;
 
 private:
 	const init_token mInitToken = Init::Instance().token();
 
-	void runLoop();
+	void runLoop(TcpServer *tcpServer);
+	void processIncoming(socket_t sock);
+	void triggerClient(shared_ptr<rtc::WebSocket> ws);
 
 	certificate_ptr mCertificate;
-	std::thread mThread;
+	std::vector<std::thread> mThreads;
 	std::atomic<bool> mStopped;
+	Processor mClientProcessor; // serializes client callbacks
 };
 
 } // namespace rtc::impl
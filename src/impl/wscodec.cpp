@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "wscodec.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WS_CODEC_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define WS_CODEC_AVX2 1 // compiled with a target attribute and selected at runtime
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define WS_CODEC_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace rtc::impl {
+
+namespace {
+
+// Scalar kernels, also used for the tails of vectorized kernels
+
+void MaskScalar(uint8_t *data, size_t size, uint32_t key) {
+	const uint64_t key64 = uint64_t(key) << 32 | key;
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		word ^= key64;
+		std::memcpy(data + i, &word, 8);
+	}
+
+	uint8_t k[4];
+	std::memcpy(k, &key, 4);
+	for (; i < size; ++i)
+		data[i] ^= k[i % 4];
+}
+
+[[maybe_unused]] size_t SkipAsciiScalar(const uint8_t *data, size_t size) {
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		if (word & 0x8080808080808080ULL)
+			break;
+	}
+	return i;
+}
+
+#if WS_CODEC_SSE2
+
+void MaskSse2(uint8_t *data, size_t size, uint32_t key) {
+	const __m128i k = _mm_set1_epi32(int(key));
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		auto p = reinterpret_cast<__m128i *>(data + i);
+		_mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), k));
+	}
+	MaskScalar(data + i, size - i, key);
+}
+
+size_t SkipAsciiSse2(const uint8_t *data, size_t size) {
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		if (_mm_movemask_epi8(v))
+			break;
+	}
+	return i;
+}
+
+#endif
+
+#if WS_CODEC_AVX2
+
+__attribute__((target("avx2"))) void MaskAvx2(uint8_t *data, size_t size, uint32_t key) {
+	const __m256i k = _mm256_set1_epi32(int(key));
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		auto p = reinterpret_cast<__m256i *>(data + i);
+		_mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), k));
+	}
+	_mm256_zeroupper(); // avoid the AVX-SSE transition penalty
+	MaskSse2(data + i, size - i, key);
+}
+
+__attribute__((target("avx2"))) size_t SkipAsciiAvx2(const uint8_t *data, size_t size) {
+	size_t i = 0;
+	for (; i + 32 <= size; i += 32) {
+		auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+		if (_mm256_movemask_epi8(v))
+			break;
+	}
+	return i;
+}
+
+bool HasAvx2() {
+	static const bool result = __builtin_cpu_supports("avx2");
+	return result;
+}
+
+#endif
+
+#if WS_CODEC_NEON
+
+void MaskNeon(uint8_t *data, size_t size, uint32_t key) {
+	const uint8x16_t k = vreinterpretq_u8_u32(vdupq_n_u32(key));
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+		vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), k));
+
+	MaskScalar(data + i, size - i, key);
+}
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+size_t SkipAsciiNeon(const uint8_t *data, size_t size) {
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+		if (vmaxvq_u8(vld1q_u8(data + i)) & 0x80)
+			break;
+
+	return i;
+}
+#endif
+
+#endif
+
+void Mask(uint8_t *data, size_t size, uint32_t key) {
+#if WS_CODEC_AVX2
+	if (HasAvx2())
+		return MaskAvx2(data, size, key);
+#endif
+#if WS_CODEC_SSE2
+	MaskSse2(data, size, key);
+#elif WS_CODEC_NEON
+	MaskNeon(data, size, key);
+#else
+	MaskScalar(data, size, key);
+#endif
+}
+
+size_t SkipAscii(const uint8_t *data, size_t size) {
+#if WS_CODEC_AVX2
+	if (HasAvx2())
+		return SkipAsciiAvx2(data, size);
+#endif
+#if WS_CODEC_SSE2
+	return SkipAsciiSse2(data, size);
+#elif WS_CODEC_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+	return SkipAsciiNeon(data, size);
+#else
+	return SkipAsciiScalar(data, size);
+#endif
+}
+
+bool IsContinuation(uint8_t c) { return (c & 0xC0) == 0x80; }
+
+} // namespace
+
+void WsMask(byte *data, size_t size, const byte *maskingKey) {
+	uint32_t key;
+	std::memcpy(&key, maskingKey, 4); // memory order is preserved when broadcasting the key
+	Mask(reinterpret_cast<uint8_t *>(data), size, key);
+}
+
+bool WsValidateUtf8(const byte *data, size_t size) {
+	auto d = reinterpret_cast<const uint8_t *>(data);
+	size_t i = 0;
+	while (i < size) {
+		// Skip ASCII blocks quickly, then validate sequences one by one
+		i += SkipAscii(d + i, size - i);
+		if (i == size)
+			break;
+
+		const uint8_t c = d[i];
+		if (c < 0x80) {
+			++i;
+			continue;
+		}
+
+		// RFC 3629 4. Syntax of UTF-8 Byte Sequences
+		// See https://www.rfc-editor.org/rfc/rfc3629.html#section-4
+		size_t len;
+		uint8_t min = 0x80, max = 0xBF; // bounds for the second byte
+		if (c >= 0xC2 && c <= 0xDF) {
+			len = 2;
+		} else if (c >= 0xE0 && c <= 0xEF) {
+			len = 3;
+			if (c == 0xE0)
+				min = 0xA0; // overlong
+			else if (c == 0xED)
+				max = 0x9F; // surrogates
+		} else if (c >= 0xF0 && c <= 0xF4) {
+			len = 4;
+			if (c == 0xF0)
+				min = 0x90; // overlong
+			else if (c == 0xF4)
+				max = 0x8F; // above U+10FFFF
+		} else {
+			return false;
+		}
+
+		if (size - i < len)
+			return false;
+
+		if (d[i + 1] < min || d[i + 1] > max)
+			return false;
+
+		for (size_t j = 2; j < len; ++j)
+			if (!IsContinuation(d[i + j]))
+				return false;
+
+		i += len;
+	}
+	return true;
+}
+
+} // namespace rtc::impl
+
+#endif
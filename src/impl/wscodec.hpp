@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_IMPL_WS_CODEC_H
+#define RTC_IMPL_WS_CODEC_H
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include "common.hpp"
+
+namespace rtc::impl {
+
+// Mask or unmask WebSocket payload data in place with the 4-byte masking key (RFC 6455)
+// See https://www.rfc-editor.org/rfc/rfc6455.html#section-5.3
+void WsMask(byte *data, size_t size, const byte *maskingKey);
+
+// Return true if data is valid UTF-8 (RFC 3629), as required for WebSocket text messages
+// See https://www.rfc-editor.org/rfc/rfc6455.html#section-8.1
+bool WsValidateUtf8(const byte *data, size_t size);
+
+} // namespace rtc::impl
+
+#endif
+
+#endif
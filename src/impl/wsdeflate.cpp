@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "wsdeflate.hpp"
+#include "internals.hpp"
+
+#if RTC_ENABLE_WEBSOCKET && RTC_ENABLE_DEFLATE
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace rtc::impl {
+
+namespace {
+
+int MemLevel(int windowBits) { return std::clamp(windowBits - 7, 1, 8); }
+
+size_t EstimateMemory(int windowBits) {
+	// See https://www.zlib.net/zlib_tech.html
+	const size_t deflateMemory =
+	    (size_t(1) << (windowBits + 2)) + (size_t(1) << (MemLevel(windowBits) + 9));
+	const size_t inflateMemory = size_t(1) << windowBits;
+	const size_t overhead = 14 * 1024; // internal state structures
+	return deflateMemory + inflateMemory + overhead;
+}
+
+// The compressor emits an empty stored block with Z_SYNC_FLUSH, which is removed from messages
+// See https://www.rfc-editor.org/rfc/rfc7692.html#section-7.2.1
+const uint8_t SyncFlushTail[4] = {0x00, 0x00, 0xFF, 0xFF};
+
+} // namespace
+
+int WsDeflate::WindowBitsForMemoryLimit(size_t memoryLimit) {
+	for (int bits = MaxWindowBits; bits >= MinWindowBits; --bits)
+		if (EstimateMemory(bits) <= memoryLimit)
+			return bits;
+
+	return 0;
+}
+
+WsDeflate::WsDeflate(Params params, size_t maxMessageSize)
+    : mParams(std::move(params)), mMaxMessageSize(maxMessageSize) {
+
+	if (mParams.compressWindowBits < MinWindowBits || mParams.compressWindowBits > MaxWindowBits ||
+	    mParams.decompressWindowBits < MinWindowBits ||
+	    mParams.decompressWindowBits > MaxWindowBits)
+		throw std::invalid_argument("Invalid deflate window bits");
+
+	if (canCompress())
+		initDeflate();
+
+	try {
+		initInflate();
+	} catch (...) {
+		if (mDeflateInit)
+			deflateEnd(&mDeflateStream);
+
+		throw;
+	}
+
+	PLOG_DEBUG << "WebSocket deflate initialized, compress window bits="
+	           << mParams.compressWindowBits
+	           << ", decompress window bits=" << mParams.decompressWindowBits;
+}
+
+WsDeflate::~WsDeflate() {
+	if (mDeflateInit)
+		deflateEnd(&mDeflateStream);
+
+	if (mInflateInit)
+		inflateEnd(&mInflateStream);
+}
+
+void WsDeflate::initDeflate() {
+	// Negative window bits select raw deflate, without zlib header
+	mDeflateStream = {};
+	if (deflateInit2(&mDeflateStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+	                 -mParams.compressWindowBits, MemLevel(mParams.compressWindowBits),
+	                 Z_DEFAULT_STRATEGY) != Z_OK)
+		throw std::runtime_error("Failed to initialize deflate");
+
+	mDeflateInit = true;
+}
+
+void WsDeflate::initInflate() {
+	mInflateStream = {};
+	if (inflateInit2(&mInflateStream, -mParams.decompressWindowBits) != Z_OK)
+		throw std::runtime_error("Failed to initialize inflate");
+
+	mInflateInit = true;
+}
+
+void WsDeflate::release() {
+	if (mDeflateInit && mParams.compressNoContextTakeover) {
+		deflateEnd(&mDeflateStream);
+		mDeflateInit = false;
+	}
+
+	if (mInflateInit && mParams.decompressNoContextTakeover) {
+		inflateEnd(&mInflateStream);
+		mInflateInit = false;
+	}
+}
+
+bool WsDeflate::canCompress() const { return mParams.compressWindowBits > MinWindowBits; }
+
+bool WsDeflate::isStateless() const { return mParams.compressNoContextTakeover; }
+
+int WsDeflate::compressWindowBits() const { return mParams.compressWindowBits; }
+
+binary WsDeflate::compress(const byte *data, size_t size) {
+	if (!canCompress())
+		throw std::logic_error("WebSocket compression is not available");
+
+	if (!mDeflateInit)
+		initDeflate();
+
+	mDeflateStream.next_in = reinterpret_cast<Bytef *>(const_cast<byte *>(data));
+	mDeflateStream.avail_in = uInt(size);
+
+	binary out(deflateBound(&mDeflateStream, uLong(size)) + sizeof(SyncFlushTail));
+	size_t produced = 0;
+	do {
+		if (produced == out.size())
+			out.resize(out.size() * 2);
+
+		mDeflateStream.next_out = reinterpret_cast<Bytef *>(out.data() + produced);
+		mDeflateStream.avail_out = uInt(out.size() - produced);
+		if (deflate(&mDeflateStream, Z_SYNC_FLUSH) == Z_STREAM_ERROR)
+			throw std::runtime_error("WebSocket message compression failed");
+
+		produced = out.size() - mDeflateStream.avail_out;
+	} while (mDeflateStream.avail_out == 0);
+
+	auto tail = reinterpret_cast<const uint8_t *>(out.data() + produced - sizeof(SyncFlushTail));
+	if (produced >= sizeof(SyncFlushTail) &&
+	    std::equal(SyncFlushTail, SyncFlushTail + sizeof(SyncFlushTail), tail))
+		produced -= sizeof(SyncFlushTail);
+
+	out.resize(produced);
+
+	if (mParams.compressNoContextTakeover)
+		deflateReset(&mDeflateStream);
+
+	return out;
+}
+
+optional<binary> WsDeflate::decompress(const byte *data, size_t size) {
+	if (!mInflateInit)
+		initInflate();
+
+	// Inflating stops as soon as the output exceeds the max message size, so a small compressed
+	// message can't expand into a large allocation. The context is left inconsistent, so the
+	// connection must then be failed.
+	binary out;
+	auto inflateInput = [&](const uint8_t *input, size_t length) {
+		mInflateStream.next_in = const_cast<Bytef *>(input);
+		mInflateStream.avail_in = uInt(length);
+		do {
+			size_t offset = out.size();
+			out.resize(std::min(std::max(offset * 2, length * 2 + 64), mMaxMessageSize + 1));
+			mInflateStream.next_out = reinterpret_cast<Bytef *>(out.data() + offset);
+			mInflateStream.avail_out = uInt(out.size() - offset);
+
+			int ret = inflate(&mInflateStream, Z_SYNC_FLUSH);
+			out.resize(out.size() - mInflateStream.avail_out);
+			if (out.size() > mMaxMessageSize)
+				return false;
+
+			if (ret == Z_STREAM_END) {
+				// The peer terminated the stream with a final block
+				inflateReset(&mInflateStream);
+				break;
+			}
+			if (ret == Z_BUF_ERROR)
+				break; // no progress possible
+
+			if (ret != Z_OK)
+				throw std::runtime_error("WebSocket message decompression failed");
+
+		} while (mInflateStream.avail_in > 0 || mInflateStream.avail_out == 0);
+
+		return true;
+	};
+
+	if (!inflateInput(reinterpret_cast<const uint8_t *>(data), size) ||
+	    !inflateInput(SyncFlushTail, sizeof(SyncFlushTail))) {
+		PLOG_WARNING << "WebSocket decompressed message is too large";
+		inflateReset(&mInflateStream);
+		return nullopt;
+	}
+
+	if (mParams.decompressNoContextTakeover)
+		inflateReset(&mInflateStream);
+
+	return out;
+}
+
+} // namespace rtc::impl
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_IMPL_WS_DEFLATE_H
+#define RTC_IMPL_WS_DEFLATE_H
+
+#if RTC_ENABLE_WEBSOCKET && RTC_ENABLE_DEFLATE
+
+#include "common.hpp"
+
+#include <zlib.h>
+
+namespace rtc::impl {
+
+// permessage-deflate compression and decompression contexts for a connection (RFC 7692)
+// See https://www.rfc-editor.org/rfc/rfc7692.html
+class WsDeflate final {
+public:
+	static const int MinWindowBits = 8;
+	static const int MaxWindowBits = 15;
+
+	// Return the largest window bits for which both contexts fit in the memory limit, or 0
+	static int WindowBitsForMemoryLimit(size_t memoryLimit);
+
+	struct Params {
+		int compressWindowBits = MaxWindowBits;
+		bool compressNoContextTakeover = false;
+		int decompressWindowBits = MaxWindowBits;
+		bool decompressNoContextTakeover = false;
+	};
+
+	WsDeflate(Params params, size_t maxMessageSize);
+	~WsDeflate();
+
+	bool canCompress() const; // zlib can't compress with a 256-byte window
+	bool isStateless() const; // compressed output only depends on the message and window bits
+	int compressWindowBits() const;
+	binary compress(const byte *data, size_t size);
+	optional<binary> decompress(const byte *data, size_t size); // nullopt if over the max size
+
+	// Free the contexts which are not kept between messages, they are created again on demand
+	void release();
+
+private:
+	void initDeflate();
+	void initInflate();
+
+	const Params mParams;
+	const size_t mMaxMessageSize;
+	z_stream mDeflateStream = {};
+	z_stream mInflateStream = {};
+	bool mDeflateInit = false;
+	bool mInflateInit = false;
+};
+
+} // namespace rtc::impl
+
+#endif
+
+#endif
@@ -28,10 +28,11 @@ namespace rtc::impl {
 using std::to_string;
 using std::chrono::system_clock;
 
-WsHandshake::WsHandshake() {}
+WsHandshake::WsHandshake() : mParser(HttpParser::Type::Request, WS_MAX_HANDSHAKE_SIZE) {}
 
 WsHandshake::WsHandshake(string host, string path, std::vector<string> protocols)
-    : mHost(std::move(host)), mPath(std::move(path)), mProtocols(std::move(protocols)) {
+    : mHost(std::move(host)), mPath(std::move(path)), mProtocols(std::move(protocols)),
+      mParser(HttpParser::Type::Response, WS_MAX_HANDSHAKE_SIZE) {
 
 	if (mHost.empty())
 		throw std::invalid_argument("WebSocket HTTP host cannot be empty");
@@ -55,6 +56,16 @@ std::vector<string> WsHandshake::protocols() const {
 	return mProtocols;
 }
 
+void WsHandshake::setDeflateOptions(DeflateOptions options) {
+	std::unique_lock lock(mMutex);
+	mDeflateOptions = std::move(options);
+}
+
+optional<WsHandshake::DeflateParams> WsHandshake::deflateParams() const {
+	std::unique_lock lock(mMutex);
+	return mDeflateParams;
+}
+
 string WsHandshake::generateHttpRequest() {
 	std::unique_lock lock(mMutex);
 	mKey = generateKey();
@@ -73,6 +84,18 @@ string WsHandshake::generateHttpRequest() {
 	if (!mProtocols.empty())
 		out += "Sec-WebSocket-Protocol: " + utils::implode(mProtocols, ',') + "\r\n";
 
+	if (mDeflateOptions) {
+		// RFC 7692 7.1. Extension Negotiation Parameters
+		// See https://www.rfc-editor.org/rfc/rfc7692.html#section-7.1
+		const int bits = mDeflateOptions->maxWindowBits;
+		out += "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits";
+		if (bits < 15)
+			out += "=" + to_string(bits) + "; server_max_window_bits=" + to_string(bits);
+		if (mDeflateOptions->noContextTakeover)
+			out += "; client_no_context_takeover; server_no_context_takeover";
+		out += "\r\n";
+	}
+
 	out += "\r\n";
 
 	return out;
@@ -91,6 +114,9 @@ string WsHandshake::generateHttpResponse() {
 	if (!mProtocols.empty())
 		out += "Sec-WebSocket-Protocol: " + utils::implode(mProtocols, ',') + "\r\n";
 
+	if (!mDeflateResponse.empty())
+		out += "Sec-WebSocket-Extensions: " + mDeflateResponse + "\r\n";
+
 	out += "\r\n";
 
 	return out;
@@ -98,6 +124,74 @@ string WsHandshake::generateHttpResponse() {
 
 namespace {
 
+string Trim(const string &str) {
+	const char *whitespace = " \t";
+	size_t begin = str.find_first_not_of(whitespace);
+	if (begin == string::npos)
+		return "";
+
+	size_t end = str.find_last_not_of(whitespace);
+	return str.substr(begin, end + 1 - begin);
+}
+
+struct Extension {
+	string name;
+	std::vector<std::pair<string, string>> params; // value is empty if absent
+};
+
+// Parse a Sec-WebSocket-Extensions header value
+// See https://www.rfc-editor.org/rfc/rfc6455.html#section-9.1
+std::vector<Extension> ParseExtensions(const string &value) {
+	std::vector<Extension> extensions;
+	for (const auto &item : utils::explode(value, ',')) {
+		auto tokens = utils::explode(item, ';');
+		if (tokens.empty() || Trim(tokens[0]).empty())
+			continue;
+
+		Extension extension;
+		extension.name = Trim(tokens[0]);
+		for (auto it = tokens.begin() + 1; it != tokens.end(); ++it) {
+			string param = Trim(*it);
+			string paramValue;
+			if (size_t pos = param.find('='); pos != string::npos) {
+				paramValue = Trim(param.substr(pos + 1));
+				param = Trim(param.substr(0, pos));
+				if (paramValue.size() >= 2 && paramValue.front() == '"' && paramValue.back() == '"')
+					paramValue = paramValue.substr(1, paramValue.size() - 2);
+			}
+			extension.params.emplace_back(std::move(param), std::move(paramValue));
+		}
+		extensions.push_back(std::move(extension));
+	}
+	return extensions;
+}
+
+optional<int> ParseWindowBits(const string &value) {
+	if (value.size() < 1 || value.size() > 2 ||
+	    !std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; }))
+		return nullopt;
+
+	int bits = std::stoi(value);
+	if (bits < 8 || bits > 15)
+		return nullopt;
+
+	return bits;
+}
+
+string JoinHeaderValues(const HttpParser &parser, std::string_view name) {
+	string result;
+	for (size_t i = 0; i < parser.headerCount(); ++i) {
+		if (!utils::iequals(parser.headerName(i), name))
+			continue;
+
+		if (!result.empty())
+			result += ',';
+
+		result.append(parser.headerValue(i));
+	}
+	return result;
+}
+
 string GetHttpErrorName(int responseCode) {
 	switch (responseCode) {
 	case 400:
@@ -108,6 +202,8 @@ string GetHttpErrorName(int responseCode) {
 		return "Method Not Allowed";
 	case 426:
 		return "Upgrade Required";
+	case 431:
+		return "Request Header Fields Too Large";
 	case 500:
 		return "Internal Server Error";
 	default:
@@ -136,100 +232,186 @@ string WsHandshake::generateHttpError(int responseCode) {
 }
 
 size_t WsHandshake::parseHttpRequest(const byte *buffer, size_t size) {
-	if (!isHttpRequest(buffer, size))
-		throw RequestError("Invalid HTTP request for WebSocket", 400);
-
 	std::unique_lock lock(mMutex);
-	std::list<string> lines;
-	size_t length = parseHttpLines(buffer, size, lines);
-	if (length == 0)
+	switch (mParser.parse(buffer, size)) {
+	case HttpParser::Status::Incomplete:
 		return 0;
-
-	if (lines.empty())
+	case HttpParser::Status::TooLarge:
+		throw RequestError("HTTP request for WebSocket is too large", 431);
+	case HttpParser::Status::Invalid:
 		throw RequestError("Invalid HTTP request for WebSocket", 400);
+	default:
+		break;
+	}
 
-	std::istringstream requestLine(std::move(lines.front()));
-	lines.pop_front();
-
-	string method, path, protocol;
-	requestLine >> method >> path >> protocol;
-	PLOG_DEBUG << "WebSocket request method=\"" << method << "\", path=\"" << path << "\"";
+	const auto method = mParser.method();
+	PLOG_DEBUG << "WebSocket request method=\"" << method << "\", path=\"" << mParser.target()
+	           << "\"";
 	if (method != "GET")
-		throw RequestError("Invalid request method \"" + method + "\" for WebSocket", 405);
-
-	mPath = std::move(path);
+		throw RequestError("Invalid request method \"" + string(method) + "\" for WebSocket", 405);
 
-	auto headers = parseHttpHeaders(lines);
+	mPath.assign(mParser.target());
 
-	auto h = headers.find("host");
-	if (h == headers.end())
+	auto h = mParser.header("host");
+	if (!h)
 		throw RequestError("WebSocket host header missing in request", 400);
 
-	mHost = std::move(h->second);
+	mHost.assign(*h);
 
-	h = headers.find("upgrade");
-	if (h == headers.end())
+	h = mParser.header("upgrade");
+	if (!h)
 		throw RequestError("WebSocket upgrade header missing in request", 426);
 
-	string upgrade;
-	std::transform(h->second.begin(), h->second.end(), std::back_inserter(upgrade),
-	               [](char c) { return std::tolower(c); });
-	if (upgrade != "websocket")
+	if (!utils::iequals(*h, "websocket"))
 		throw RequestError("WebSocket upgrade header mismatching", 426);
 
-	h = headers.find("sec-websocket-key");
-	if (h == headers.end())
+	h = mParser.header("sec-websocket-key");
+	if (!h)
 		throw RequestError("WebSocket key header missing in request", 400);
 
-	mKey = std::move(h->second);
+	mKey.assign(*h);
 
-	h = headers.find("sec-websocket-protocol");
-	if (h != headers.end())
-		mProtocols = utils::explode(h->second, ',');
+	h = mParser.header("sec-websocket-protocol");
+	if (h)
+		mProtocols = utils::explode(string(*h), ',');
 
-	return length;
+	mDeflateParams.reset();
+	mDeflateResponse.clear();
+	if (mDeflateOptions)
+		negotiateDeflate(JoinHeaderValues(mParser, "sec-websocket-extensions"));
+
+	return mParser.length();
 }
 
 size_t WsHandshake::parseHttpResponse(const byte *buffer, size_t size) {
 	std::unique_lock lock(mMutex);
-	std::list<string> lines;
-	size_t length = parseHttpLines(buffer, size, lines);
-	if (length == 0)
+	switch (mParser.parse(buffer, size)) {
+	case HttpParser::Status::Incomplete:
 		return 0;
-
-	if (lines.empty())
+	case HttpParser::Status::TooLarge:
+		throw Error("HTTP response for WebSocket is too large");
+	case HttpParser::Status::Invalid:
 		throw Error("Invalid HTTP response for WebSocket");
+	default:
+		break;
+	}
 
-	std::istringstream status(std::move(lines.front()));
-	lines.pop_front();
-
-	string protocol;
-	unsigned int code = 0;
-	status >> protocol >> code;
+	const int code = mParser.statusCode();
 	PLOG_DEBUG << "WebSocket response code=" << code;
 	if (code != 101)
 		throw std::runtime_error("Unexpected response code " + to_string(code) + " for WebSocket");
 
-	auto headers = parseHttpHeaders(lines);
-
-	auto h = headers.find("upgrade");
-	if (h == headers.end())
+	auto h = mParser.header("upgrade");
+	if (!h)
 		throw Error("WebSocket update header missing");
 
-	string upgrade;
-	std::transform(h->second.begin(), h->second.end(), std::back_inserter(upgrade),
-	               [](char c) { return std::tolower(c); });
-	if (upgrade != "websocket")
+	if (!utils::iequals(*h, "websocket"))
 		throw Error("WebSocket update header mismatching");
 
-	h = headers.find("sec-websocket-accept");
-	if (h == headers.end())
+	h = mParser.header("sec-websocket-accept");
+	if (!h)
 		throw Error("WebSocket accept header missing");
 
-	if (h->second != computeAcceptKey(mKey))
+	if (*h != computeAcceptKey(mKey))
 		throw Error("WebSocket accept header is invalid");
 
-	return length;
+	mDeflateParams.reset();
+	parseDeflateResponse(JoinHeaderValues(mParser, "sec-websocket-extensions"));
+
+	return mParser.length();
+}
+
+void WsHandshake::negotiateDeflate(const string &offers) {
+	// Requires mMutex to be locked
+	// RFC 7692 5. Extension Negotiation: the server accepts the first offer it supports
+	// See https://www.rfc-editor.org/rfc/rfc7692.html#section-5
+	for (const auto &offer : ParseExtensions(offers)) {
+		if (offer.name != "permessage-deflate")
+			continue;
+
+		DeflateParams params;
+		bool serverBitsOffered = false, clientBitsOffered = false, valid = true;
+		for (const auto &[name, value] : offer.params) {
+			if (name == "server_no_context_takeover" && value.empty()) {
+				params.serverNoContextTakeover = true;
+			} else if (name == "client_no_context_takeover" && value.empty()) {
+				params.clientNoContextTakeover = true;
+			} else if (name == "server_max_window_bits") {
+				auto bits = ParseWindowBits(value);
+				valid = valid && bits;
+				params.serverMaxWindowBits = bits.value_or(15);
+				serverBitsOffered = true;
+			} else if (name == "client_max_window_bits") {
+				auto bits = value.empty() ? optional<int>(15) : ParseWindowBits(value);
+				valid = valid && bits;
+				params.clientMaxWindowBits = bits.value_or(15);
+				clientBitsOffered = true;
+			} else {
+				valid = false;
+			}
+		}
+		if (!valid)
+			continue;
+
+		// The client window can only be limited if the client supports it
+		const int maxBits = mDeflateOptions->maxWindowBits;
+		params.serverMaxWindowBits = std::min(params.serverMaxWindowBits, maxBits);
+		params.clientMaxWindowBits =
+		    clientBitsOffered ? std::min(params.clientMaxWindowBits, maxBits) : 15;
+
+		if (mDeflateOptions->noContextTakeover)
+			params.serverNoContextTakeover = params.clientNoContextTakeover = true;
+
+		string response = "permessage-deflate";
+		if (params.serverNoContextTakeover)
+			response += "; server_no_context_takeover";
+		if (params.clientNoContextTakeover)
+			response += "; client_no_context_takeover";
+		if (serverBitsOffered || params.serverMaxWindowBits < 15)
+			response += "; server_max_window_bits=" + to_string(params.serverMaxWindowBits);
+		if (clientBitsOffered && params.clientMaxWindowBits < 15)
+			response += "; client_max_window_bits=" + to_string(params.clientMaxWindowBits);
+
+		PLOG_DEBUG << "WebSocket accepted extension: " << response;
+		mDeflateParams.emplace(std::move(params));
+		mDeflateResponse = std::move(response);
+		return;
+	}
+}
+
+void WsHandshake::parseDeflateResponse(const string &response) {
+	// Requires mMutex to be locked
+	for (const auto &extension : ParseExtensions(response)) {
+		if (extension.name != "permessage-deflate" || !mDeflateOptions || mDeflateParams)
+			throw Error("Unexpected WebSocket extension \"" + extension.name + "\"");
+
+		DeflateParams params;
+		for (const auto &[name, value] : extension.params) {
+			if (name == "server_no_context_takeover" && value.empty()) {
+				params.serverNoContextTakeover = true;
+			} else if (name == "client_no_context_takeover" && value.empty()) {
+				params.clientNoContextTakeover = true;
+			} else if (name == "server_max_window_bits" || name == "client_max_window_bits") {
+				auto bits = ParseWindowBits(value);
+				if (!bits)
+					throw Error("Invalid WebSocket deflate parameter " + name + "=" + value);
+
+				(name == "server_max_window_bits" ? params.serverMaxWindowBits
+				                                  : params.clientMaxWindowBits) = *bits;
+			} else {
+				throw Error("Unexpected WebSocket deflate parameter " + name);
+			}
+		}
+
+		// Local options are always honored for the local compressor
+		params.clientMaxWindowBits =
+		    std::min(params.clientMaxWindowBits, mDeflateOptions->maxWindowBits);
+		if (mDeflateOptions->noContextTakeover)
+			params.clientNoContextTakeover = true;
+
+		PLOG_DEBUG << "WebSocket negotiated extension: permessage-deflate";
+		mDeflateParams.emplace(std::move(params));
+	}
 }
 
 string WsHandshake::generateKey() {
@@ -10,6 +10,7 @@
 #define RTC_IMPL_WS_HANDSHAKE_H
 
 #include "common.hpp"
+#include "http.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
 
@@ -29,6 +30,22 @@ public:
 	string path() const;
 	std::vector<string> protocols() const;
 
+	// permessage-deflate extension (RFC 7692)
+	struct DeflateOptions {
+		bool noContextTakeover = false;
+		int maxWindowBits = 15;
+	};
+
+	struct DeflateParams {
+		bool serverNoContextTakeover = false;
+		bool clientNoContextTakeover = false;
+		int serverMaxWindowBits = 15;
+		int clientMaxWindowBits = 15;
+	};
+
+	void setDeflateOptions(DeflateOptions options); // offer or accept the extension
+	optional<DeflateParams> deflateParams() const;  // negotiated parameters, if any
+
 	string generateHttpRequest();
 	string generateHttpResponse();
 	string generateHttpError(int responseCode = 400);
@@ -54,10 +71,17 @@ private:
 	static string generateKey();
 	static string computeAcceptKey(const string &key);
 
+	void negotiateDeflate(const string &offers);
+	void parseDeflateResponse(const string &response);
+
 	string mHost;
 	string mPath;
 	std::vector<string> mProtocols;
 	string mKey;
+	optional<DeflateOptions> mDeflateOptions;
+	optional<DeflateParams> mDeflateParams;
+	string mDeflateResponse;
+	HttpParser mParser;
 	mutable std::mutex mMutex;
 };
 
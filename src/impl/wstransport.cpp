@@ -12,6 +12,8 @@
 #include "threadpool.hpp"
 #include "tlstransport.hpp"
 #include "utils.hpp"
+#include "wscodec.hpp"
+#include "wsdeflate.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
 
@@ -41,6 +43,8 @@ namespace rtc::impl {
 
 using std::to_integer;
 using std::to_string;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
 using std::chrono::system_clock;
 
 WsTransport::WsTransport(LowerTransport lower, shared_ptr<WsHandshake> handshake,
@@ -54,10 +58,33 @@ WsTransport::WsTransport(LowerTransport lower, shared_ptr<WsHandshake> handshake
                                      [](shared_ptr<TlsTransport> l) { return l->isClient(); }},
                      lower)),
       mMaxMessageSize(config.maxMessageSize.value_or(DEFAULT_WS_MAX_MESSAGE_SIZE)),
-      mMaxOutstandingPings(config.maxOutstandingPings.value_or(0)) {
+      mMaxOutstandingPings(config.maxOutstandingPings.value_or(0)),
+      mValidateUtf8(config.enableUtf8Validation),
+      mPingEnabled(config.pingInterval.value_or(DEFAULT_WS_PING_INTERVAL) > milliseconds::zero()),
+      mHibernationTimeout(config.hibernationTimeout.value_or(milliseconds::zero()) >
+                                  milliseconds::zero()
+                              ? config.hibernationTimeout
+                              : nullopt),
+      mLastActivity(steady_clock::now()) {
 
 	onRecv(std::move(recvCallback));
 
+	if (config.enableDeflate) {
+#if RTC_ENABLE_DEFLATE
+		// The memory limit is enforced by reducing the window size
+		int windowBits = WsDeflate::MaxWindowBits;
+		if (config.deflateMemoryLimit)
+			windowBits = WsDeflate::WindowBitsForMemoryLimit(*config.deflateMemoryLimit);
+
+		if (windowBits > 0)
+			mHandshake->setDeflateOptions({config.disableDeflateContextTakeover, windowBits});
+		else
+			PLOG_WARNING << "WebSocket deflate memory limit is too low, disabling compression";
+#else
+		PLOG_WARNING << "WebSocket compression support is not enabled";
+#endif
+	}
+
 	PLOG_DEBUG << "Initializing WebSocket transport";
 }
 
@@ -81,11 +108,61 @@ bool WsTransport::send(message_ptr message) {
 		return false;
 
 	PLOG_VERBOSE << "Send size=" << message->size();
+	updateActivity();
+
+	bool compressed = false;
+#if RTC_ENABLE_DEFLATE
+	compressed = mDeflate && mDeflate->canCompress() &&
+	             message->size() >= WS_DEFLATE_MIN_MESSAGE_SIZE;
+#endif
+
 	return sendFrame({message->type == Message::String ? TEXT_FRAME : BINARY_FRAME, message->data(),
-	                  message->size(), true, mIsClient});
+	                  message->size(), true, mIsClient, compressed},
+	                 message);
+}
+
+bool WsTransport::sendShared(message_ptr message, SharedFrames &frames) {
+	if (state() != State::Connected)
+		throw std::runtime_error("WebSocket is not open");
+
+	// Client frames are masked with a random key so they can't be shared
+	if (mIsClient || !message)
+		return send(std::move(message));
+
+	updateActivity();
+
+	int key = 0; // uncompressed
+#if RTC_ENABLE_DEFLATE
+	if (mDeflate && mDeflate->canCompress() && message->size() >= WS_DEFLATE_MIN_MESSAGE_SIZE) {
+		// With context takeover, the output depends on previous messages on the connection
+		if (!mDeflate->isStateless())
+			return send(std::move(message));
+
+		key = mDeflate->compressWindowBits();
+	}
+#endif
+
+	std::lock_guard lock(mSendMutex);
+	auto &shared = frames[key];
+	if (!shared) {
+		Frame frame{message->type == Message::String ? TEXT_FRAME : BINARY_FRAME,
+		            message->data(), message->size(), true, false, key != 0};
+		binary compressed;
+#if RTC_ENABLE_DEFLATE
+		if (frame.compressed) {
+			compressed = mDeflate->compress(frame.payload, frame.length);
+			frame.payload = compressed.data();
+			frame.length = compressed.size();
+		}
+#endif
+		shared = makeFrameMessage(frame, frame.payload, frame.length);
+	}
+
+	PLOG_VERBOSE << "Send shared frame size=" << shared->size();
+	return outgoing(shared);
 }
 
-void WsTransport::close() {
+void WsTransport::close(optional<uint16_t> code) {
 	if (state() != State::Connected)
 		return;
 
@@ -94,7 +171,10 @@ void WsTransport::close() {
 
 	PLOG_INFO << "WebSocket closing";
 	try {
-		sendFrame({CLOSE, NULL, 0, true, mIsClient});
+		// The close frame body starts with the status code in network byte order
+		uint16_t payload = code ? htons(*code) : 0;
+		sendFrame({CLOSE, reinterpret_cast<byte *>(&payload), code ? sizeof(payload) : 0, true,
+		           mIsClient});
 	} catch (const std::exception &e) {
 		// The connection might not be open anymore
 		PLOG_DEBUG << "Unable to send WebSocket close frame: " << e.what();
@@ -120,13 +200,16 @@ void WsTransport::incoming(message_ptr message) {
 		PLOG_VERBOSE << "Incoming size=" << message->size();
 
 		try {
-			mBuffer.insert(mBuffer.end(), message->begin(), message->end());
-
+			bool buffered = false;
 			if (state() == State::Connecting) {
+				mBuffer.insert(mBuffer.end(), message->begin(), message->end());
+				buffered = true;
+
 				if (mIsClient) {
 					if (size_t len =
 					        mHandshake->parseHttpResponse(mBuffer.data(), mBuffer.size())) {
 						PLOG_INFO << "WebSocket client-side open";
+						initDeflate();
 						changeState(State::Connected);
 						mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
 					}
@@ -134,6 +217,7 @@ void WsTransport::incoming(message_ptr message) {
 					if (size_t len = mHandshake->parseHttpRequest(mBuffer.data(), mBuffer.size())) {
 						PLOG_INFO << "WebSocket server-side open";
 						sendHttpResponse();
+						initDeflate();
 						changeState(State::Connected);
 						mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
 					}
@@ -142,29 +226,53 @@ void WsTransport::incoming(message_ptr message) {
 
 			if (state() == State::Connected) {
 				if (message->size() == 0) {
-					// TCP is idle, send a ping
-					PLOG_DEBUG << "WebSocket sending ping";
-					uint32_t dummy = 0;
-					sendFrame({PING, reinterpret_cast<byte *>(&dummy), 4, true, mIsClient});
-					addOutstandingPing();
+					// TCP is idle, hibernate if no message was exchanged recently and send a ping
+					if (mHibernationTimeout && !mHibernating &&
+					    steady_clock::now() - mLastActivity.load() >= *mHibernationTimeout)
+						hibernate();
+
+					if (mPingEnabled) {
+						PLOG_DEBUG << "WebSocket sending ping";
+						uint32_t dummy = 0;
+						sendFrame({PING, reinterpret_cast<byte *>(&dummy), 4, true, mIsClient});
+						addOutstandingPing();
+					}
 				} else {
-					if (mIgnoreLength > 0) {
-						size_t len = std::min(mIgnoreLength, mBuffer.size());
-						mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
-						mIgnoreLength -= len;
+					// Frames are parsed in place, directly in the incoming message if nothing is
+					// pending, and the remaining partial frame is kept for the next call
+					if (!buffered && !mBuffer.empty()) {
+						mBuffer.insert(mBuffer.end(), message->begin(), message->end());
+						buffered = true;
 					}
+
+					byte *data = buffered ? mBuffer.data() : message->data();
+					const size_t size = buffered ? mBuffer.size() : message->size();
+
+					size_t offset = std::min(mIgnoreLength, size);
+					mIgnoreLength -= offset;
 					if (mIgnoreLength == 0) {
 						Frame frame;
-						while (size_t len = parseFrame(mBuffer.data(), mBuffer.size(), frame)) {
-							recvFrame(frame);
-							if (len > mBuffer.size()) {
-								mIgnoreLength = len - mBuffer.size();
-								mBuffer.clear();
+						while (size_t len = parseFrame(data + offset, size - offset, frame)) {
+							// A frame ending the incoming message may take it over to avoid a copy
+							const bool last = !buffered && len == size - offset;
+							recvFrame(frame, last ? message : nullptr);
+							if (last) {
+								offset = size;
+								break; // the message might have been taken over
+							}
+							if (len > size - offset) {
+								mIgnoreLength = len - (size - offset);
+								offset = size;
 								break;
 							}
-							mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
+							offset += len;
 						}
 					}
+
+					if (buffered)
+						mBuffer.erase(mBuffer.begin(), mBuffer.begin() + offset);
+					else if (offset < size)
+						mBuffer.assign(data + offset, data + size);
 				}
 			}
 
@@ -197,6 +305,33 @@ void WsTransport::incoming(message_ptr message) {
 	}
 }
 
+void WsTransport::hibernate() {
+	PLOG_DEBUG << "WebSocket hibernating";
+	mHibernating = true;
+
+	// Pending data is kept, but empty buffers are released
+	if (mBuffer.empty())
+		binary().swap(mBuffer);
+
+	if (mPartial.empty())
+		binary().swap(mPartial);
+
+#if RTC_ENABLE_DEFLATE
+	if (mDeflate) {
+		std::lock_guard lock(mSendMutex);
+		mDeflate->release();
+	}
+#endif
+
+	Transport::hibernate();
+}
+
+void WsTransport::updateActivity() {
+	mLastActivity = steady_clock::now();
+	if (mHibernating && mHibernating.exchange(false))
+		PLOG_DEBUG << "WebSocket resuming from hibernation";
+}
+
 bool WsTransport::sendHttpRequest() {
 	PLOG_DEBUG << "Sending WebSocket HTTP request";
 
@@ -253,6 +388,7 @@ size_t WsTransport::parseFrame(byte *buffer, size_t size, Frame &frame) {
 	auto b2 = to_integer<uint8_t>(*cur++);
 
 	frame.fin = (b1 & 0x80) != 0;
+	frame.compressed = (b1 & 0x40) != 0;
 	frame.mask = (b2 & 0x80) != 0;
 	frame.opcode = static_cast<Opcode>(b1 & 0x0F);
 	frame.length = b2 & 0x7F;
@@ -283,7 +419,8 @@ size_t WsTransport::parseFrame(byte *buffer, size_t size, Frame &frame) {
 		return 0;
 
 	size_t length = frame.length;
-	if (frame.length > maxFrameLength) {
+	frame.truncated = frame.length > maxFrameLength;
+	if (frame.truncated) {
 		PLOG_WARNING << "WebSocket frame is too large (length=" << frame.length
 		             << "), truncating it";
 		frame.length = maxFrameLength;
@@ -292,19 +429,37 @@ size_t WsTransport::parseFrame(byte *buffer, size_t size, Frame &frame) {
 	frame.payload = cur;
 
 	if (maskingKey)
-		for (size_t i = 0; i < frame.length; ++i)
-			frame.payload[i] ^= maskingKey[i % 4];
+		WsMask(frame.payload, frame.length, maskingKey);
 
 	return frame.payload + length - buffer; // can be more than buffer size
 }
 
-void WsTransport::recvFrame(const Frame &frame) {
+void WsTransport::recvFrame(const Frame &frame, message_ptr container) {
+	// If set, container is the incoming message, which ends with the frame and may be reused
 	PLOG_DEBUG << "WebSocket received frame: opcode=" << int(frame.opcode)
 	           << ", length=" << frame.length;
 
+	// RFC 7692 6. permessage-deflate: RSV1 is only valid on the first frame of a data message
+	// See https://www.rfc-editor.org/rfc/rfc7692.html#section-6
+	bool compressionAllowed = false;
+#if RTC_ENABLE_DEFLATE
+	compressionAllowed = mDeflate && (frame.opcode == TEXT_FRAME || frame.opcode == BINARY_FRAME);
+#endif
+	if (frame.compressed && !compressionAllowed) {
+		PLOG_ERROR << "Unexpected compressed WebSocket frame, closing";
+		close();
+		return;
+	}
+
 	switch (frame.opcode) {
 	case TEXT_FRAME:
 	case BINARY_FRAME: {
+		// Truncated compressed data can't be inflated, and the message would be too large anyway
+		if (frame.compressed && (frame.truncated || frame.length > mMaxMessageSize)) {
+			PLOG_WARNING << "WebSocket compressed message is too large, closing";
+			close(CLOSE_MESSAGE_TOO_BIG);
+			return;
+		}
 		size_t size = frame.length;
 		if (size > mMaxMessageSize) {
 			PLOG_WARNING << "WebSocket message is too large, truncating it";
@@ -314,33 +469,43 @@ void WsTransport::recvFrame(const Frame &frame) {
 			PLOG_WARNING << "WebSocket unfinished message: type="
 			             << (mPartialOpcode == TEXT_FRAME ? "text" : "binary")
 			             << ", size=" << mPartial.size();
-			auto type = mPartialOpcode == TEXT_FRAME ? Message::String : Message::Binary;
-			recv(make_message(mPartial.begin(), mPartial.end(), type));
+			recvMessage(make_message(std::move(mPartial)), mPartialOpcode, mPartialCompressed);
 			mPartial.clear();
 		}
 		mPartialOpcode = frame.opcode;
+		mPartialCompressed = frame.compressed;
 		if (frame.fin) {
-			PLOG_DEBUG << "WebSocket finished message: type="
-			           << (frame.opcode == TEXT_FRAME ? "text" : "binary") << ", size=" << size;
-			auto type = frame.opcode == TEXT_FRAME ? Message::String : Message::Binary;
-			recv(make_message(frame.payload, frame.payload + size, type));
+			if (container) {
+				// The payload is moved over the frame header, so the incoming buffer is passed up
+				// as the message instead of being copied into a new one
+				std::copy(frame.payload, frame.payload + size, container->begin());
+				container->resize(size);
+				recvMessage(std::move(container), frame.opcode, frame.compressed);
+			} else {
+				recvMessage(make_message(frame.payload, frame.payload + size), frame.opcode,
+				            frame.compressed);
+			}
 		} else {
 			mPartial.insert(mPartial.end(), frame.payload, frame.payload + size);
 		}
 		break;
 	}
 	case CONTINUATION: {
+		if (mPartialCompressed &&
+		    (frame.truncated || mPartial.size() + frame.length > mMaxMessageSize)) {
+			PLOG_WARNING << "WebSocket compressed message is too large, closing";
+			mPartial.clear();
+			close(CLOSE_MESSAGE_TOO_BIG);
+			return;
+		}
 		mPartial.insert(mPartial.end(), frame.payload, frame.payload + frame.length);
 		if (mPartial.size() > mMaxMessageSize) {
 			PLOG_WARNING << "WebSocket message is too large, truncating it";
 			mPartial.resize(mMaxMessageSize);
 		}
 		if (frame.fin) {
-			PLOG_DEBUG << "WebSocket finished message: type="
-			           << (frame.opcode == TEXT_FRAME ? "text" : "binary")
-			           << ", size=" << mPartial.size();
-			auto type = mPartialOpcode == TEXT_FRAME ? Message::String : Message::Binary;
-			recv(make_message(mPartial.begin(), mPartial.end(), type));
+			// The assembled buffer is moved into the message
+			recvMessage(make_message(std::move(mPartial)), mPartialOpcode, mPartialCompressed);
 			mPartial.clear();
 		}
 		break;
@@ -369,47 +534,155 @@ void WsTransport::recvFrame(const Frame &frame) {
 	}
 }
 
-bool WsTransport::sendFrame(const Frame &frame) {
+void WsTransport::recvMessage(message_ptr payload, Opcode opcode, bool compressed) {
+#if RTC_ENABLE_DEFLATE
+	if (compressed) {
+		auto result = mDeflate->decompress(payload->data(), payload->size());
+		if (!result) {
+			PLOG_WARNING << "WebSocket decompressed message is too large, closing";
+			close(CLOSE_MESSAGE_TOO_BIG);
+			return;
+		}
+		payload = make_message(std::move(*result));
+	}
+#endif
+
+	PLOG_DEBUG << "WebSocket finished message: type=" << (opcode == TEXT_FRAME ? "text" : "binary")
+	           << ", size=" << payload->size() << (compressed ? " (decompressed)" : "");
+
+	if (opcode == TEXT_FRAME && !checkUtf8(payload->data(), payload->size()))
+		return;
+
+	updateActivity();
+	payload->type = opcode == TEXT_FRAME ? Message::String : Message::Binary;
+	recv(std::move(payload));
+}
+
+bool WsTransport::sendFrame(const Frame &frame, message_ptr message) {
+	// If set, message holds the payload so it can be written after the header without copy
 	std::lock_guard lock(mSendMutex);
 
+	const byte *payload = frame.payload;
+	size_t payloadLength = frame.length;
+	bool owned = false; // true if the payload message can be modified
+#if RTC_ENABLE_DEFLATE
+	// Compress under the lock as the context is shared between consecutive messages
+	if (frame.compressed) {
+		message = make_message(mDeflate->compress(frame.payload, frame.length));
+		payload = message->data();
+		payloadLength = message->size();
+		owned = true;
+	}
+#endif
+
 	PLOG_DEBUG << "WebSocket sending frame: opcode=" << int(frame.opcode)
-	           << ", length=" << frame.length;
+	           << ", length=" << payloadLength;
+
+	byte header[MaxFrameHeaderSize];
+	const size_t headerLength = makeFrameHeader(frame, payloadLength, header);
+	const byte *maskingKey = frame.mask ? header + headerLength - 4 : nullptr;
+
+	// Send large payloads as a separate segment, masking requires a copy unless it is owned
+	if (message && payloadLength >= WS_SEGMENT_MIN_SIZE && (!maskingKey || owned)) {
+		if (maskingKey)
+			WsMask(message->data(), payloadLength, maskingKey);
+
+		std::vector<message_ptr> segments;
+		segments.reserve(2);
+		segments.push_back(make_message(header, header + headerLength));
+		segments.push_back(std::move(message));
+		return outgoingSegments(std::move(segments));
+	}
+
+	auto out = make_message(headerLength + payloadLength);
+	std::copy(header, header + headerLength, out->begin());
+	std::copy(payload, payload + payloadLength, out->begin() + headerLength);
+
+	// Mask the copy so the original payload is left untouched
+	if (maskingKey)
+		WsMask(out->data() + headerLength, payloadLength, maskingKey);
+
+	return outgoing(std::move(out));
+}
 
-	byte buffer[14];
+size_t WsTransport::makeFrameHeader(const Frame &frame, size_t payloadLength, byte *buffer) const {
 	byte *cur = buffer;
 
-	*cur++ = byte((frame.opcode & 0x0F) | (frame.fin ? 0x80 : 0));
+	*cur++ = byte((frame.opcode & 0x0F) | (frame.fin ? 0x80 : 0) | (frame.compressed ? 0x40 : 0));
 
-	if (frame.length < 0x7E) {
-		*cur++ = byte((frame.length & 0x7F) | (frame.mask ? 0x80 : 0));
-	} else if (frame.length <= 0xFFFF) {
+	if (payloadLength < 0x7E) {
+		*cur++ = byte((payloadLength & 0x7F) | (frame.mask ? 0x80 : 0));
+	} else if (payloadLength <= 0xFFFF) {
 		*cur++ = byte(0x7E | (frame.mask ? 0x80 : 0));
-		*reinterpret_cast<uint16_t *>(cur) = htons(uint16_t(frame.length));
+		*reinterpret_cast<uint16_t *>(cur) = htons(uint16_t(payloadLength));
 		cur += 2;
 	} else {
 		*cur++ = byte(0x7F | (frame.mask ? 0x80 : 0));
-		*reinterpret_cast<uint64_t *>(cur) = htonll(uint64_t(frame.length));
+		*reinterpret_cast<uint64_t *>(cur) = htonll(uint64_t(payloadLength));
 		cur += 8;
 	}
 
 	if (frame.mask) {
-		byte *maskingKey = reinterpret_cast<byte *>(cur);
-
-		auto u = reinterpret_cast<uint8_t *>(maskingKey);
+		// Masking key
+		auto u = reinterpret_cast<uint8_t *>(cur);
 		std::generate(u, u + 4, utils::random_bytes_engine());
 		cur += 4;
-
-		for (size_t i = 0; i < frame.length; ++i)
-			frame.payload[i] ^= maskingKey[i % 4];
 	}
 
-	const size_t length = cur - buffer; // header length
-	auto message = make_message(length + frame.length);
-	std::copy(buffer, buffer + length, message->begin()); // header
-	std::copy(frame.payload, frame.payload + frame.length,
-	          message->begin() + length); // payload
+	return cur - buffer;
+}
+
+message_ptr WsTransport::makeFrameMessage(const Frame &frame, const byte *payload,
+                                          size_t payloadLength) const {
+	byte header[MaxFrameHeaderSize];
+	const size_t headerLength = makeFrameHeader(frame, payloadLength, header);
+
+	auto message = make_message(headerLength + payloadLength);
+	std::copy(header, header + headerLength, message->begin());
+	std::copy(payload, payload + payloadLength, message->begin() + headerLength);
 
-	return outgoing(std::move(message));
+	if (frame.mask)
+		WsMask(message->data() + headerLength, payloadLength, header + headerLength - 4);
+
+	return message;
+}
+
+bool WsTransport::checkUtf8(const byte *data, size_t size) {
+	if (!mValidateUtf8 || WsValidateUtf8(data, size))
+		return true;
+
+	// RFC 6455 8.1. Handling Errors in UTF-8-Encoded Data
+	// When an endpoint is to interpret a byte stream as UTF-8 but finds that the byte stream is
+	// not, in fact, a valid UTF-8 stream, that endpoint MUST _Fail the WebSocket Connection_.
+	// See https://www.rfc-editor.org/rfc/rfc6455.html#section-8.1
+	PLOG_WARNING << "WebSocket text message is not valid UTF-8, closing";
+	close(CLOSE_INVALID_DATA);
+	return false;
+}
+
+void WsTransport::initDeflate() {
+#if RTC_ENABLE_DEFLATE
+	auto negotiated = mHandshake->deflateParams();
+	if (!negotiated)
+		return;
+
+	// Each side compresses with its own parameters and decompresses with the remote ones
+	WsDeflate::Params params;
+	if (mIsClient) {
+		params.compressWindowBits = negotiated->clientMaxWindowBits;
+		params.compressNoContextTakeover = negotiated->clientNoContextTakeover;
+		params.decompressWindowBits = negotiated->serverMaxWindowBits;
+		params.decompressNoContextTakeover = negotiated->serverNoContextTakeover;
+	} else {
+		params.compressWindowBits = negotiated->serverMaxWindowBits;
+		params.compressNoContextTakeover = negotiated->serverNoContextTakeover;
+		params.decompressWindowBits = negotiated->clientMaxWindowBits;
+		params.decompressNoContextTakeover = negotiated->clientNoContextTakeover;
+	}
+
+	PLOG_INFO << "WebSocket compression enabled";
+	mDeflate = std::make_unique<WsDeflate>(std::move(params), mMaxMessageSize);
+#endif
 }
 
 void WsTransport::addOutstandingPing() {
@@ -17,12 +17,15 @@
 #if RTC_ENABLE_WEBSOCKET
 
 #include <atomic>
+#include <chrono>
+#include <map>
 
 namespace rtc::impl {
 
 class HttpProxyTransport;
 class TcpTransport;
 class TlsTransport;
+class WsDeflate;
 
 class WsTransport final : public Transport, public std::enable_shared_from_this<WsTransport> {
 public:
@@ -37,8 +40,15 @@ public:
 	void start() override;
 	void stop() override;
 	bool send(message_ptr message) override;
-	void close();
+
+	// Send a message that is broadcast to several transports: identical frames are built once and
+	// shared through the frames map, which is keyed by encoding
+	using SharedFrames = std::map<int, message_ptr>;
+	bool sendShared(message_ptr message, SharedFrames &frames);
+
+	void close(optional<uint16_t> code = nullopt); // status code sent in the close frame, if set
 	void incoming(message_ptr message) override;
+	void hibernate() override;
 
 	bool isClient() const { return mIsClient; }
 
@@ -52,12 +62,21 @@ private:
 		PONG = 10,
 	};
 
+	// RFC 6455 7.4.1. Defined Status Codes
+	// See https://www.rfc-editor.org/rfc/rfc6455.html#section-7.4.1
+	enum CloseCode : uint16_t {
+		CLOSE_INVALID_DATA = 1007,
+		CLOSE_MESSAGE_TOO_BIG = 1009,
+	};
+
 	struct Frame {
 		Opcode opcode = BINARY_FRAME;
 		byte *payload = nullptr;
 		size_t length = 0;
 		bool fin = true;
 		bool mask = true;
+		bool compressed = false; // RSV1, for permessage-deflate
+		bool truncated = false;  // on reception, the payload exceeded the max length
 	};
 
 	bool sendHttpRequest();
@@ -65,23 +84,41 @@ private:
 	bool sendHttpResponse();
 
 	size_t parseFrame(byte *buffer, size_t size, Frame &frame);
-	void recvFrame(const Frame &frame);
-	bool sendFrame(const Frame &frame);
+	void recvFrame(const Frame &frame, message_ptr container = nullptr);
+	void recvMessage(message_ptr payload, Opcode opcode, bool compressed);
+	static const size_t MaxFrameHeaderSize = 14;
+
+	bool sendFrame(const Frame &frame, message_ptr message = nullptr);
+	size_t makeFrameHeader(const Frame &frame, size_t payloadLength, byte *buffer) const;
+	message_ptr makeFrameMessage(const Frame &frame, const byte *payload, size_t length) const;
+	bool checkUtf8(const byte *data, size_t size);
+	void initDeflate();
 
 	void addOutstandingPing();
+	void updateActivity();
 
 	const shared_ptr<WsHandshake> mHandshake;
 	const bool mIsClient;
 	const size_t mMaxMessageSize;
 	const int mMaxOutstandingPings;
+	const bool mValidateUtf8;
+	const bool mPingEnabled;
+	const optional<std::chrono::milliseconds> mHibernationTimeout;
 
 	binary mBuffer;
 	binary mPartial;
 	Opcode mPartialOpcode;
+	bool mPartialCompressed = false;
 	size_t mIgnoreLength = 0;
 	std::mutex mSendMutex;
 	int mOutstandingPings = 0;
 	std::atomic<bool> mCloseSent = false;
+	std::atomic<std::chrono::steady_clock::time_point> mLastActivity; // last application message
+	std::atomic<bool> mHibernating = false;
+
+#if RTC_ENABLE_DEFLATE
+	unique_ptr<WsDeflate> mDeflate; // set once open, then only used under the send mutex or on recv
+#endif
 };
 
 } // namespace rtc::impl
@@ -19,9 +19,29 @@ MediaHandler::~MediaHandler() {}
 void MediaHandler::addToChain(shared_ptr<MediaHandler> handler) { last()->setNext(handler); }
 
 void MediaHandler::setNext(shared_ptr<MediaHandler> handler) {
+	if (handler)
+		handler->propagatePollCallback(std::atomic_load(&mPollCallback));
+
 	return std::atomic_store(&mNext, handler);
 }
 
+void MediaHandler::pollIncoming() {
+	if (auto callback = std::atomic_load(&mPollCallback))
+		(*callback)();
+}
+
+void MediaHandler::setPollCallback(std::function<void()> callback) {
+	propagatePollCallback(
+	    callback ? std::make_shared<std::function<void()>>(std::move(callback)) : nullptr);
+}
+
+void MediaHandler::propagatePollCallback(shared_ptr<std::function<void()>> callback) {
+	std::atomic_store(&mPollCallback, callback);
+
+	if (auto handler = next())
+		handler->propagatePollCallback(std::move(callback));
+}
+
 shared_ptr<MediaHandler> MediaHandler::next() { return std::atomic_load(&mNext); }
 
 shared_ptr<const MediaHandler> MediaHandler::next() const { return std::atomic_load(&mNext); }
@@ -56,6 +76,15 @@ bool MediaHandler::requestBitrate(unsigned int bitrate, const message_callback &
 		return false;
 }
 
+bool MediaHandler::requestRetransmission(uint32_t ssrc, const std::vector<uint16_t> &seqNumbers,
+                                         const message_callback &send) {
+	// Default implementation is to call next handler
+	if (auto handler = next())
+		return handler->requestRetransmission(ssrc, seqNumbers, send);
+	else
+		return false;
+}
+
 void MediaHandler::mediaChain(const Description::Media &desc) {
 	media(desc);
 
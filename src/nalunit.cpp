@@ -11,6 +11,7 @@
 #include "nalunit.hpp"
 
 #include "impl/internals.hpp"
+#include "impl/startsequence.hpp"
 
 #include <cmath>
 
@@ -109,6 +110,12 @@ NalUnitStartSequenceMatch NalUnit::StartSequenceMatchSucc(NalUnitStartSequenceMa
 	return NUSM_noMatch;
 }
 
+size_t NalUnit::FindStartSequence(const std::byte *data, size_t size, Separator separator,
+                                  size_t &length) {
+	assert(separator != Separator::Length);
+	return impl::FindStartSequence(data, size, separator, length);
+}
+
 NalUnitFragmentA::NalUnitFragmentA(FragmentType type, bool forbiddenBit, uint8_t nri,
                                    uint8_t unitType, binary data)
     : NalUnit(data.size() + 2) {
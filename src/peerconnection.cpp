@@ -408,6 +408,26 @@ optional<std::chrono::milliseconds> PeerConnection::rtt() {
 	return sctpTransport ? sctpTransport->rtt() : nullopt;
 }
 
+size_t PeerConnection::srtpStreamsCount() {
+#if RTC_ENABLE_MEDIA
+	auto srtpTransport =
+	    std::dynamic_pointer_cast<impl::DtlsSrtpTransport>(impl()->getDtlsTransport());
+	return srtpTransport ? srtpTransport->srtpStreamsCount() : 0;
+#else
+	return 0;
+#endif
+}
+
+size_t PeerConnection::srtpMemoryUsage() {
+#if RTC_ENABLE_MEDIA
+	auto srtpTransport =
+	    std::dynamic_pointer_cast<impl::DtlsSrtpTransport>(impl()->getDtlsTransport());
+	return srtpTransport ? srtpTransport->srtpMemoryUsage() : 0;
+#else
+	return 0;
+#endif
+}
+
 CertificateFingerprint PeerConnection::remoteFingerprint() {
 	return impl()->remoteFingerprint();
 }
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtcpnackrequester.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+
+namespace rtc {
+
+namespace {
+
+// Sequence numbers per NACK, so the NACK fits in a packet even if they are sparse
+const size_t MaxNackSeqNumbers = 256;
+
+} // namespace
+
+RtcpNackRequester::RtcpNackRequester(std::chrono::milliseconds deadline) : mDeadline(deadline) {}
+
+void RtcpNackRequester::incoming(message_vector &messages, const message_callback &send) {
+	incoming(messages, send, clock::now());
+}
+
+void RtcpNackRequester::incoming(message_vector &messages, const message_callback &send,
+                                 clock::time_point now) {
+	message_vector nacks;
+	{
+		std::lock_guard lock(mMutex);
+		for (const auto &message : messages) {
+			if (message->type == Message::Control || message->size() < sizeof(RtpHeader))
+				continue;
+
+			auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+			auto [it, inserted] = mStreams.try_emplace(rtp->ssrc());
+			if (inserted)
+				it->second.highestSeqNumber = rtp->seqNumber();
+			else
+				receive(it->second, rtp->seqNumber(), now);
+		}
+
+		for (auto &[ssrc, stream] : mStreams) {
+			if (stream.missingCount == 0)
+				continue;
+
+			if (auto seqNumbers = collect(stream, now); !seqNumbers.empty()) {
+				auto requests = makeNacks(ssrc, seqNumbers);
+				mSentNacks += requests.size();
+				nacks.insert(nacks.end(), requests.begin(), requests.end());
+			}
+		}
+	}
+
+	for (auto &nack : nacks)
+		send(std::move(nack));
+}
+
+bool RtcpNackRequester::requestRetransmission(
+    [[maybe_unused]] SSRC ssrc, [[maybe_unused]] const std::vector<uint16_t> &seqNumbers,
+    [[maybe_unused]] const message_callback &send) {
+	// Missing packets are already tracked and requested by incoming()
+	return true;
+}
+
+void RtcpNackRequester::setRtt(std::chrono::milliseconds rtt) {
+	std::lock_guard lock(mMutex);
+	mRtt = rtt;
+}
+
+void RtcpNackRequester::setReorderDelay(std::chrono::milliseconds delay) {
+	std::lock_guard lock(mMutex);
+	mReorderDelay = delay;
+}
+
+size_t RtcpNackRequester::requestedPackets() const {
+	std::lock_guard lock(mMutex);
+	return mRequestedPackets;
+}
+
+size_t RtcpNackRequester::recoveredPackets() const {
+	std::lock_guard lock(mMutex);
+	return mRecoveredPackets;
+}
+
+size_t RtcpNackRequester::abandonedPackets() const {
+	std::lock_guard lock(mMutex);
+	return mAbandonedPackets;
+}
+
+size_t RtcpNackRequester::sentNacks() const {
+	std::lock_guard lock(mMutex);
+	return mSentNacks;
+}
+
+void RtcpNackRequester::receive(Stream &stream, uint16_t seqNumber, clock::time_point now) {
+	const int delta = int16_t(uint16_t(seqNumber - stream.highestSeqNumber));
+	if (delta <= 0) {
+		// Reordered or retransmitted packet
+		if (size_t(-delta) < WindowSize && isMissing(stream, seqNumber) &&
+		    clearMissing(stream, seqNumber))
+			++mRecoveredPackets;
+
+		return;
+	}
+
+	if (size_t(delta) >= WindowSize) {
+		// Discontinuity, missing packets are not tracked anymore
+		mAbandonedPackets += stream.missingCount;
+		stream.missing.fill(0);
+		stream.missingCount = 0;
+	} else {
+		for (uint16_t s = uint16_t(stream.highestSeqNumber + 1);; ++s) {
+			// The slot might hold a missing packet which falls out of the window
+			if (const uint16_t old = uint16_t(s - WindowSize); isMissing(stream, old)) {
+				clearMissing(stream, old);
+				++mAbandonedPackets;
+			}
+
+			if (s == seqNumber)
+				break;
+
+			setMissing(stream, s, now);
+		}
+	}
+
+	stream.highestSeqNumber = seqNumber;
+}
+
+void RtcpNackRequester::setMissing(Stream &stream, uint16_t seqNumber, clock::time_point now) {
+	const size_t index = seqNumber % WindowSize;
+	stream.missing[index / 64] |= uint64_t(1) << (index % 64);
+	stream.detected[index] = now;
+	stream.requested[index] = clock::time_point();
+	++stream.missingCount;
+}
+
+bool RtcpNackRequester::isMissing(const Stream &stream, uint16_t seqNumber) const {
+	const size_t index = seqNumber % WindowSize;
+	return stream.missing[index / 64] & (uint64_t(1) << (index % 64));
+}
+
+bool RtcpNackRequester::clearMissing(Stream &stream, uint16_t seqNumber) {
+	if (!isMissing(stream, seqNumber))
+		return false;
+
+	const size_t index = seqNumber % WindowSize;
+	stream.missing[index / 64] &= ~(uint64_t(1) << (index % 64));
+	--stream.missingCount;
+	return stream.requested[index] != clock::time_point();
+}
+
+std::vector<uint16_t> RtcpNackRequester::collect(Stream &stream, clock::time_point now) {
+	std::vector<uint16_t> seqNumbers;
+	const uint16_t oldest = uint16_t(stream.highestSeqNumber - WindowSize + 1);
+	size_t remaining = stream.missingCount;
+	size_t i = 0;
+	while (i < WindowSize && remaining > 0) {
+		const uint16_t seqNumber = uint16_t(oldest + i);
+		const size_t index = seqNumber % WindowSize;
+		const uint64_t word = stream.missing[index / 64] >> (index % 64);
+		if (word == 0) {
+			i += 64 - index % 64; // skip to the next word
+			continue;
+		}
+		++i;
+		if (!(word & 1))
+			continue;
+
+		--remaining;
+		if (now - stream.detected[index] >= mDeadline) {
+			clearMissing(stream, seqNumber);
+			++mAbandonedPackets;
+			continue;
+		}
+
+		auto &requested = stream.requested[index];
+		if (requested == clock::time_point()) {
+			if (now - stream.detected[index] < mReorderDelay)
+				continue; // might be reordered
+
+			++mRequestedPackets;
+		} else if (now - requested < mRtt) {
+			continue;
+		}
+
+		requested = now;
+		seqNumbers.push_back(seqNumber);
+	}
+	return seqNumbers;
+}
+
+message_vector RtcpNackRequester::makeNacks(SSRC ssrc,
+                                            const std::vector<uint16_t> &seqNumbers) const {
+	message_vector messages;
+	for (size_t i = 0; i < seqNumbers.size(); i += MaxNackSeqNumbers) {
+		const size_t count = std::min(seqNumbers.size() - i, MaxNackSeqNumbers);
+		auto message = make_message(RtcpNack::Size(unsigned(count)), Message::Control);
+		auto nack = reinterpret_cast<RtcpNack *>(message->data());
+		unsigned int fciCount = 0;
+		uint16_t fciPID = 0;
+		for (size_t j = i; j < i + count; ++j)
+			nack->addMissingPacket(&fciCount, &fciPID, seqNumbers[j]);
+
+		nack->preparePacket(ssrc, fciCount);
+		message->resize(RtcpNack::Size(fciCount));
+		messages.push_back(std::move(message));
+	}
+	return messages;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -12,13 +12,43 @@
 #include "rtp.hpp"
 
 #include "impl/internals.hpp"
+#include "impl/utils.hpp"
 
-#include <cassert>
+#include <algorithm>
+#include <functional>
+#include <random>
 
 namespace rtc {
 
-RtcpNackResponder::RtcpNackResponder(size_t maxSize)
-    : mStorage(std::make_shared<Storage>(maxSize)) {}
+namespace {
+
+const size_t MaxStorageSize = 32768; // half of the sequence number space
+
+// Maximum burst of retransmissions when the bitrate is limited
+const auto MaxBurstDuration = std::chrono::milliseconds(200);
+
+size_t RingCapacity(size_t size) {
+	size_t capacity = 1;
+	while (capacity < size)
+		capacity *= 2;
+
+	return capacity;
+}
+
+bool Holds(const message_ptr &packet, uint16_t sequenceNumber) {
+	return packet && reinterpret_cast<const RtpHeader *>(packet->data())->seqNumber() ==
+	                     sequenceNumber;
+}
+
+} // namespace
+
+RtcpNackResponder::RtcpNackResponder(size_t maxSize, size_t maxBytes)
+    : mStorage(std::make_shared<Storage>(maxSize, maxBytes)) {
+	// The initial RTX sequence number is random as for the original stream
+	auto uniform =
+	    std::bind(std::uniform_int_distribution<uint32_t>(), impl::utils::random_engine());
+	mRtxSequenceNumber = static_cast<uint16_t>(uniform());
+}
 
 void RtcpNackResponder::incoming(message_vector &messages, const message_callback &send) {
 	for (const auto &message : messages) {
@@ -46,9 +76,40 @@ void RtcpNackResponder::incoming(message_vector &messages, const message_callbac
 				                              newMissingSeqenceNumbers.end());
 			}
 
-			for (auto sequenceNumber : missingSequenceNumbers)
-				if (auto packet = mStorage->get(sequenceNumber))
-					send(packet);
+			const auto now = clock::now();
+			message_vector packets;
+			{
+				std::lock_guard lock(mMutex);
+				for (auto sequenceNumber : missingSequenceNumbers) {
+					auto packet = mStorage->get(sequenceNumber);
+					if (!packet)
+						continue;
+
+					bool isRtx = false;
+					if (mRtxSsrc)
+						if (auto rtx = makeRtx(packet)) {
+							packet = std::move(rtx);
+							isRtx = true;
+						}
+
+					if (!consumeBudget(packet->size(), now)) {
+						PLOG_VERBOSE << "Retransmission bitrate exceeded, dropping packet";
+						++mDroppedRetransmissions;
+						continue;
+					}
+
+					// Sequence numbers are only taken by sent packets so the RTX stream has no gaps
+					if (isRtx)
+						reinterpret_cast<RtpHeader *>(packet->data())
+						    ->setSeqNumber(mRtxSequenceNumber++);
+
+					++mRetransmittedPackets;
+					packets.push_back(std::move(packet));
+				}
+			}
+
+			for (auto &packet : packets)
+				send(std::move(packet));
 		}
 	}
 }
@@ -60,51 +121,192 @@ void RtcpNackResponder::outgoing(message_vector &messages,
 			mStorage->store(message);
 }
 
-RtcpNackResponder::Storage::Element::Element(message_ptr packet, uint16_t sequenceNumber,
-                                             shared_ptr<Element> next)
-    : packet(packet), sequenceNumber(sequenceNumber), next(next) {}
+void RtcpNackResponder::enableRtx(SSRC rtxSsrc, std::map<uint8_t, uint8_t> payloadTypes) {
+	std::lock_guard lock(mMutex);
+	mRtxSsrc = rtxSsrc;
+	mRtxPayloadTypes = std::move(payloadTypes);
+}
+
+void RtcpNackResponder::enableRtx(SSRC rtxSsrc, const Description::Media &media) {
+	std::map<uint8_t, uint8_t> payloadTypes;
+	for (auto [payloadType, origPayloadType] : media.rtxPayloadTypes())
+		payloadTypes.emplace(uint8_t(origPayloadType), uint8_t(payloadType));
+
+	enableRtx(rtxSsrc, std::move(payloadTypes));
+}
+
+void RtcpNackResponder::setMaxBitrate(unsigned int bitrate) {
+	std::lock_guard lock(mMutex);
+	mMaxBitrate = bitrate;
+	mBudget = double(bitrate) / 8 * std::chrono::duration<double>(MaxBurstDuration).count();
+	mBudgetTime = clock::now();
+}
+
+size_t RtcpNackResponder::storedPackets() const { return mStorage->size(); }
+
+size_t RtcpNackResponder::storedBytes() const { return mStorage->bytes(); }
+
+std::chrono::milliseconds RtcpNackResponder::storedDuration() const {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(mStorage->duration());
+}
+
+size_t RtcpNackResponder::retransmittedPackets() const {
+	std::lock_guard lock(mMutex);
+	return mRetransmittedPackets;
+}
+
+size_t RtcpNackResponder::droppedRetransmissions() const {
+	std::lock_guard lock(mMutex);
+	return mDroppedRetransmissions;
+}
+
+message_ptr RtcpNackResponder::makeRtx(const message_ptr &packet) const {
+	auto rtp = reinterpret_cast<const RtpHeader *>(packet->data());
+	auto it = mRtxPayloadTypes.find(rtp->payloadType());
+	if (it == mRtxPayloadTypes.end())
+		return nullptr; // no RTX for this payload type, the packet is resent as is
+
+	size_t headerSize = rtp->getSize();
+	if (rtp->extension()) {
+		if (headerSize + sizeof(RtpExtensionHeader) > packet->size())
+			return nullptr;
+
+		headerSize += rtp->getExtensionHeaderSize();
+	}
+	if (headerSize > packet->size())
+		return nullptr;
+
+	// See https://www.rfc-editor.org/rfc/rfc4588.html#section-4
+	auto rtx = make_message(packet->size() + 2, packet); // copies the header
+	const uint16_t osn = rtp->seqNumber();
+	rtx->at(headerSize) = std::byte(osn >> 8);
+	rtx->at(headerSize + 1) = std::byte(osn & 0xFF);
+	std::copy(packet->begin() + headerSize, packet->end(), rtx->begin() + headerSize + 2);
+
+	auto rtxRtp = reinterpret_cast<RtpHeader *>(rtx->data());
+	rtxRtp->setSsrc(*mRtxSsrc);
+	rtxRtp->setPayloadType(it->second);
+	return rtx;
+}
+
+bool RtcpNackResponder::consumeBudget(size_t size, clock::time_point now) {
+	if (mMaxBitrate == 0)
+		return true;
 
-size_t RtcpNackResponder::Storage::size() { return storage.size(); }
+	// Token bucket refilled at the maximum bitrate, which may go in debt by one packet
+	const double rate = double(mMaxBitrate) / 8;
+	const double maxBudget = rate * std::chrono::duration<double>(MaxBurstDuration).count();
+	mBudget = std::min(mBudget + rate * std::chrono::duration<double>(now - mBudgetTime).count(),
+	                   maxBudget);
+	mBudgetTime = now;
+	if (mBudget <= 0)
+		return false;
 
-RtcpNackResponder::Storage::Storage(size_t _maxSize) : maxSize(_maxSize) {
-	assert(maxSize > 0);
-	storage.reserve(maxSize);
+	mBudget -= double(size);
+	return true;
 }
 
-message_ptr RtcpNackResponder::Storage::get(uint16_t sequenceNumber) {
-	std::lock_guard lock(mutex);
-	auto position = storage.find(sequenceNumber);
-	return position != storage.end() ? storage.at(sequenceNumber)->packet
-	                                 : nullptr;
+RtcpNackResponder::Storage::Storage(size_t maxSize, size_t maxBytes)
+    : mMaxSize(std::clamp(maxSize, size_t(1), MaxStorageSize)), mMaxBytes(maxBytes),
+      mSlots(RingCapacity(mMaxSize)), mMask(uint16_t(mSlots.size() - 1)) {}
+
+message_ptr RtcpNackResponder::Storage::get(uint16_t sequenceNumber) const {
+	// The slot might have been reused for a newer packet
+	auto packet = std::atomic_load(&slot(sequenceNumber).packet);
+	return Holds(packet, sequenceNumber) ? packet : nullptr;
 }
 
-void RtcpNackResponder::Storage::store(message_ptr packet) {
+void RtcpNackResponder::Storage::store(message_ptr packet, clock::time_point now) {
 	if (!packet || packet->size() < sizeof(RtpHeader))
 		return;
 
 	auto rtp = reinterpret_cast<RtpHeader *>(packet->data());
 	auto sequenceNumber = rtp->seqNumber();
 
-	std::lock_guard lock(mutex);
-	assert((storage.empty() && !oldest && !newest) || (!storage.empty() && oldest && newest));
-
-	if (size() == 0) {
-		newest = std::make_shared<Element>(packet, sequenceNumber);
-		oldest = newest;
+	std::lock_guard lock(mMutex);
+	if (mCount == 0) {
+		mOldest = sequenceNumber;
+		mCount = 1;
 	} else {
-		auto current = std::make_shared<Element>(packet, sequenceNumber);
-		newest->next = current;
-		newest = current;
+		const uint16_t newest = uint16_t(mOldest + mCount - 1);
+		const int delta = int16_t(uint16_t(sequenceNumber - newest));
+		if (delta > 0) {
+			if (size_t(delta) >= mSlots.size()) {
+				// Discontinuity, all packets are evicted
+				while (mCount > 0)
+					evictOldest();
+
+				mOldest = sequenceNumber;
+				mCount = 1;
+			} else {
+				mCount += size_t(delta);
+			}
+		} else if (size_t(-delta) >= mCount) {
+			return; // older than the oldest packet
+		}
 	}
 
-	storage.emplace(sequenceNumber, newest);
+	// If the window exceeds the capacity, the slot of a packet to evict is overwritten
+	auto &s = slot(sequenceNumber);
+	s.time = now;
+	put(s, std::move(packet));
 
-	if (size() > maxSize) {
-		assert(oldest);
-		if (oldest) {
-			storage.erase(oldest->sequenceNumber);
-			oldest = oldest->next;
-		}
+	while (mCount > mMaxSize || (mBytes > mMaxBytes && mSize > 1))
+		evictOldest();
+}
+
+size_t RtcpNackResponder::Storage::size() const {
+	std::lock_guard lock(mMutex);
+	return mSize;
+}
+
+size_t RtcpNackResponder::Storage::bytes() const {
+	std::lock_guard lock(mMutex);
+	return mBytes;
+}
+
+RtcpNackResponder::Storage::clock::duration RtcpNackResponder::Storage::duration() const {
+	std::lock_guard lock(mMutex);
+	if (mCount == 0)
+		return clock::duration::zero();
+
+	return slot(uint16_t(mOldest + mCount - 1)).time - slot(mOldest).time;
+}
+
+RtcpNackResponder::Storage::Slot &RtcpNackResponder::Storage::slot(uint16_t sequenceNumber) {
+	return mSlots[sequenceNumber & mMask];
+}
+
+const RtcpNackResponder::Storage::Slot &
+RtcpNackResponder::Storage::slot(uint16_t sequenceNumber) const {
+	return mSlots[sequenceNumber & mMask];
+}
+
+void RtcpNackResponder::Storage::put(Slot &slot, message_ptr packet) {
+	// Only writers modify slots, so the packet may be read directly
+	if (slot.packet) {
+		mBytes -= slot.packet->size();
+		--mSize;
+	}
+	if (packet) {
+		mBytes += packet->size();
+		++mSize;
+	}
+
+	std::atomic_store(&slot.packet, std::move(packet));
+}
+
+void RtcpNackResponder::Storage::evictOldest() {
+	if (auto &s = slot(mOldest); Holds(s.packet, mOldest))
+		put(s, nullptr);
+
+	++mOldest;
+	--mCount;
+
+	// Skip missing packets so the oldest one is stored
+	while (mCount > 0 && !Holds(slot(mOldest).packet, mOldest)) {
+		++mOldest;
+		--mCount;
 	}
 }
 
@@ -128,6 +128,31 @@ void RtcpReceivingSession::pushPLI(const message_callback &send) {
 	send(message);
 }
 
+bool RtcpReceivingSession::requestRetransmission(SSRC ssrc,
+                                                 const std::vector<uint16_t> &seqNumbers,
+                                                 const message_callback &send) {
+	if (seqNumbers.empty())
+		return false;
+
+	PLOG_VERBOSE << "Requesting retransmission of " << seqNumbers.size() << " packets";
+	pushNACK(send, ssrc, seqNumbers);
+	return true;
+}
+
+void RtcpReceivingSession::pushNACK(const message_callback &send, SSRC ssrc,
+                                    const std::vector<uint16_t> &seqNumbers) {
+	auto message = make_message(RtcpNack::Size(unsigned(seqNumbers.size())), Message::Control);
+	auto *nack = reinterpret_cast<RtcpNack *>(message->data());
+	unsigned int fciCount = 0;
+	uint16_t fciPID = 0;
+	for (uint16_t seqNumber : seqNumbers)
+		nack->addMissingPacket(&fciCount, &fciPID, seqNumber);
+
+	nack->preparePacket(ssrc, fciCount);
+	message->resize(RtcpNack::Size(fciCount));
+	send(message);
+}
+
 } // namespace rtc
 
 #endif // RTC_ENABLE_MEDIA
@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtpextensionmap.hpp"
+
+namespace rtc {
+
+namespace {
+
+const char *const Uris[RtpExtensionMap::ExtensionCount] = {
+    "urn:3gpp:video-orientation",
+    "urn:ietf:params:rtp-hdrext:sdes:mid",
+    "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id",
+    "http://www.webrtc.org/experiments/rtp-hdrext/playout-delay",
+    "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time",
+    "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01",
+    "http://www.webrtc.org/experiments/rtp-hdrext/abs-capture-time",
+};
+
+const uint16_t OneByteProfile = 0xBEDE;
+const uint16_t TwoByteProfile = 0x1000; // the 4 lower bits are application-dependent
+
+} // namespace
+
+const char *RtpExtensionMap::Uri(Extension extension) { return Uris[size_t(extension)]; }
+
+optional<RtpExtensionMap::Extension> RtpExtensionMap::FromUri(string_view uri) {
+	for (size_t i = 0; i < ExtensionCount; ++i)
+		if (uri == Uris[i])
+			return Extension(i);
+
+	return nullopt;
+}
+
+const byte *RtpExtensionMap::Find(const RtpHeader *rtp, size_t size, uint8_t id, size_t &length) {
+	if (id == 0 || size < sizeof(RtpHeader) || !rtp->extension())
+		return nullptr;
+
+	const size_t headerSize = rtp->getSize();
+	if (size < headerSize + sizeof(RtpExtensionHeader))
+		return nullptr;
+
+	auto extHeader = rtp->getExtensionHeader();
+	if (size < headerSize + sizeof(RtpExtensionHeader) + extHeader->getSize())
+		return nullptr;
+
+	const uint16_t profile = extHeader->profileSpecificId();
+	const bool twoByte = (profile & 0xFFF0) == TwoByteProfile;
+	if (profile != OneByteProfile && !twoByte)
+		return nullptr;
+
+	auto p = reinterpret_cast<const byte *>(extHeader->getBody());
+	auto end = p + extHeader->getSize();
+	while (p < end) {
+		const uint8_t first = std::to_integer<uint8_t>(*p);
+		if (first == 0) { // padding
+			++p;
+			continue;
+		}
+
+		uint8_t elementId;
+		size_t elementSize;
+		if (twoByte) {
+			if (end - p < 2)
+				break;
+
+			elementId = first;
+			elementSize = std::to_integer<uint8_t>(p[1]);
+			p += 2;
+		} else {
+			elementId = first >> 4;
+			if (elementId == 15) // reserved, processing must stop
+				break;
+
+			elementSize = (first & 0x0F) + 1;
+			p += 1;
+		}
+
+		if (size_t(end - p) < elementSize)
+			break;
+
+		if (elementId == id) {
+			length = elementSize;
+			return p;
+		}
+
+		p += elementSize;
+	}
+	return nullptr;
+}
+
+RtpExtensionMap::RtpExtensionMap(const Description::Media &desc) {
+	for (int id : desc.extIds()) {
+		auto extMap = desc.extMap(id);
+		if (id <= 0 || id > 255 || !extMap)
+			continue;
+
+		if (auto extension = FromUri(extMap->uri))
+			set(*extension, uint8_t(id));
+	}
+}
+
+void RtpExtensionMap::set(Extension extension, uint8_t id) { mIds[size_t(extension)] = id; }
+
+uint8_t RtpExtensionMap::id(Extension extension) const { return mIds[size_t(extension)]; }
+
+optional<RtpExtensionMap::Extension> RtpExtensionMap::find(uint8_t id) const {
+	if (id == 0)
+		return nullopt;
+
+	for (size_t i = 0; i < ExtensionCount; ++i)
+		if (mIds[i] == id)
+			return Extension(i);
+
+	return nullopt;
+}
+
+bool RtpExtensionMap::operator==(const RtpExtensionMap &other) const { return mIds == other.mIds; }
+
+bool RtpExtensionMap::operator!=(const RtpExtensionMap &other) const { return !(*this == other); }
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
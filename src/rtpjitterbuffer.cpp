@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtpjitterbuffer.hpp"
+
+#include "impl/internals.hpp"
+#include "impl/threadpool.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace rtc {
+
+namespace {
+
+// Minimum interval between keyframe requests, as a single loss drops consecutive frames
+const auto KeyframeRequestInterval = std::chrono::milliseconds(200);
+
+const RtpHeader *Header(const message_ptr &packet) {
+	return reinterpret_cast<const RtpHeader *>(packet->data());
+}
+
+} // namespace
+
+RtpJitterBuffer::RtpJitterBuffer(std::chrono::milliseconds latency, size_t maxPackets)
+    : mLatency(latency), mMaxPackets(std::max(maxPackets, size_t(1))) {}
+
+void RtpJitterBuffer::insert(message_ptr packet, clock::time_point now) {
+	auto rtp = Header(packet);
+	if (mSsrc && *mSsrc != rtp->ssrc()) {
+		// Another stream is followed only once the current one stops, so that interleaved streams
+		// don't reset the buffer on every packet
+		if (now - mLastArrival < SsrcSwitchDelay) {
+			PLOG_VERBOSE << "Ignoring RTP packet from another SSRC, ssrc=" << rtp->ssrc();
+			return;
+		}
+
+		PLOG_DEBUG << "RTP stream SSRC changed, resetting jitter buffer";
+		reset();
+	}
+
+	const uint16_t seqNumber = rtp->seqNumber();
+	uint64_t extended;
+	if (!mSsrc) {
+		// Start far from zero so the sequence can go backwards
+		mSsrc = rtp->ssrc();
+		extended = (uint64_t(1) << 32) + seqNumber;
+		mHighestSeqNumber = mNextSeqNumber = extended;
+	} else {
+		const int16_t delta = int16_t(uint16_t(seqNumber - uint16_t(mHighestSeqNumber)));
+		extended = uint64_t(int64_t(mHighestSeqNumber) + delta);
+	}
+	mLastArrival = now;
+
+	if (extended + mMaxPackets < mNextSeqNumber || extended > mHighestSeqNumber + mMaxPackets) {
+		// The sequence jumped, which is confirmed by a packet close to this one
+		auto previous = std::exchange(mResyncPacket, std::move(packet));
+		if (!previous)
+			return;
+
+		const int16_t delta = int16_t(uint16_t(seqNumber - Header(previous)->seqNumber()));
+		if (delta == 0 || size_t(std::abs(delta)) > mMaxPackets)
+			return;
+
+		PLOG_DEBUG << "RTP sequence number jumped, resetting jitter buffer";
+		auto resyncPacket = std::move(mResyncPacket);
+		reset();
+		insert(std::move(previous), now);
+		insert(std::move(resyncPacket), now);
+		return;
+	}
+	mResyncPacket.reset();
+
+	if (extended < mNextSeqNumber) {
+		if (mStarted) {
+			PLOG_VERBOSE << "RTP packet arrived too late, seq=" << seqNumber;
+			++mLatePackets;
+			return;
+		}
+
+		mNextSeqNumber = extended; // reordered before anything was output
+	}
+
+	if (extended > mHighestSeqNumber) {
+		// Newly missing packets
+		for (uint64_t s = mHighestSeqNumber + 1; s < extended; ++s)
+			if (mMissing.size() < mMaxPackets)
+				mMissing.push_back(Missing{s, now});
+
+		mHighestSeqNumber = extended;
+	}
+
+	mPackets.emplace(extended, Entry{std::move(packet), now}); // duplicates are ignored
+}
+
+bool RtpJitterBuffer::pop(message_vector &packets, clock::time_point now) {
+	packets.clear();
+	while (!mPackets.empty()) {
+		auto it = mPackets.cbegin();
+		if (it->first == mNextSeqNumber) {
+			if (!isFrameStart(it)) {
+				// Remaining packets of a dropped frame
+				drop(it);
+				continue;
+			}
+
+			if (auto last = findFrameEnd(it); last != mPackets.cend()) {
+				auto end = std::next(last);
+				for (auto jt = it; jt != end; ++jt)
+					packets.push_back(jt->second.packet);
+
+				mNextSeqNumber = last->first + 1;
+				mFrameStart = Header(last->second.packet)->marker();
+				mPreviousTimestamp = Header(last->second.packet)->timestamp();
+				mPackets.erase(it, end);
+				mDroppedTimestamp.reset();
+				mStarted = true;
+				return true;
+			}
+		}
+
+		// The next frame is incomplete, missing packets are awaited for the latency
+		if (mPackets.size() <= mMaxPackets && now - it->second.arrival < mLatency)
+			return false;
+
+		dropHead();
+	}
+	return false;
+}
+
+void RtpJitterBuffer::signalLosses(MediaHandler &handler, const message_callback &send,
+                                   clock::time_point now) {
+	// Missing packets are requested after the reorder delay, unless they arrived in the meantime
+	std::vector<uint16_t> seqNumbers;
+	while (!mMissing.empty() && now - mMissing.front().detected >= ReorderDelay) {
+		const uint64_t seqNumber = mMissing.front().seqNumber;
+		if (seqNumber >= mNextSeqNumber && mPackets.find(seqNumber) == mPackets.end())
+			seqNumbers.push_back(uint16_t(seqNumber));
+
+		mMissing.pop_front();
+	}
+	if (!seqNumbers.empty() && mSsrc)
+		handler.requestRetransmission(*mSsrc, seqNumbers, send);
+
+	if (mKeyframeNeeded &&
+	    (!mLastKeyframeRequest || now - *mLastKeyframeRequest >= KeyframeRequestInterval)) {
+		PLOG_DEBUG << "Requesting keyframe after frame loss";
+		handler.requestKeyframe(send);
+		mLastKeyframeRequest = now;
+		mKeyframeNeeded = false;
+	}
+}
+
+void RtpJitterBuffer::schedulePoll(MediaHandler &handler, clock::time_point now) {
+	if (mNextPoll && *mNextPoll <= now)
+		mNextPoll.reset(); // the scheduled poll is due
+
+	auto deadline = nextDeadline();
+	if (!deadline || (mNextPoll && *mNextPoll <= *deadline))
+		return;
+
+	mNextPoll = std::max(*deadline, now);
+	impl::ThreadPool::Instance().schedule(*mNextPoll, [weak_handler = handler.weak_from_this()]() {
+		if (auto locked = weak_handler.lock())
+			locked->pollIncoming();
+	});
+}
+
+void RtpJitterBuffer::skipTo(const message_ptr &packet) {
+	auto rtp = Header(packet);
+	if (!mSsrc || *mSsrc != rtp->ssrc())
+		return;
+
+	const int16_t delta = int16_t(uint16_t(rtp->seqNumber() - uint16_t(mHighestSeqNumber)));
+	const uint64_t extended = uint64_t(int64_t(mHighestSeqNumber) + delta);
+	auto it = mPackets.find(extended);
+	if (it == mPackets.end())
+		return; // late or not inserted
+
+	if (it != mPackets.begin())
+		PLOG_VERBOSE << "Skipping RTP packets before a new sequence, count="
+		             << std::distance(mPackets.begin(), it);
+
+	mPackets.erase(mPackets.begin(), it);
+	mNextSeqNumber = extended;
+	mStarted = true;
+	mFrameStart = true;
+	mPreviousTimestamp.reset();
+	mDroppedTimestamp.reset();
+	mKeyframeNeeded = false;
+}
+
+void RtpJitterBuffer::reset() {
+	mPackets.clear();
+	mSsrc.reset();
+	mResyncPacket.reset();
+	mStarted = false;
+	mFrameStart = true;
+	mPreviousTimestamp.reset();
+	mDroppedTimestamp.reset();
+	mMissing.clear();
+}
+
+size_t RtpJitterBuffer::droppedFrames() const { return mDroppedFrames; }
+
+size_t RtpJitterBuffer::lostPackets() const { return mLostPackets; }
+
+size_t RtpJitterBuffer::latePackets() const { return mLatePackets; }
+
+optional<RtpJitterBuffer::clock::time_point> RtpJitterBuffer::nextDeadline() const {
+	optional<clock::time_point> deadline;
+	auto update = [&deadline](clock::time_point t) {
+		if (!deadline || t < *deadline)
+			deadline = t;
+	};
+
+	if (!mPackets.empty())
+		update(mPackets.cbegin()->second.arrival + mLatency);
+
+	if (!mMissing.empty())
+		update(mMissing.front().detected + ReorderDelay);
+
+	if (mKeyframeNeeded)
+		update(mLastKeyframeRequest ? *mLastKeyframeRequest + KeyframeRequestInterval
+		                            : clock::time_point());
+
+	return deadline;
+}
+
+bool RtpJitterBuffer::isFrameStart(Map::const_iterator it) const {
+	// After a packet with the marker bit, or a change of timestamp
+	return mFrameStart ||
+	       (mPreviousTimestamp && Header(it->second.packet)->timestamp() != *mPreviousTimestamp);
+}
+
+RtpJitterBuffer::Map::const_iterator RtpJitterBuffer::findFrameEnd(Map::const_iterator it) const {
+	// The frame is complete if packets are contiguous up to the marker bit or a change of timestamp
+	const uint32_t timestamp = Header(it->second.packet)->timestamp();
+	while (!Header(it->second.packet)->marker()) {
+		auto next = std::next(it);
+		if (next == mPackets.cend() || next->first != it->first + 1)
+			return mPackets.cend();
+
+		if (Header(next->second.packet)->timestamp() != timestamp)
+			break;
+
+		it = next;
+	}
+	return it;
+}
+
+void RtpJitterBuffer::drop(Map::const_iterator it) {
+	const uint32_t timestamp = Header(it->second.packet)->timestamp();
+	if (!mDroppedTimestamp || *mDroppedTimestamp != timestamp) {
+		++mDroppedFrames;
+		mDroppedTimestamp = timestamp;
+	}
+
+	mNextSeqNumber = it->first + 1;
+	mFrameStart = Header(it->second.packet)->marker();
+	mPreviousTimestamp = timestamp;
+	mPackets.erase(it);
+	mStarted = true;
+}
+
+void RtpJitterBuffer::dropHead() {
+	auto it = mPackets.cbegin();
+	if (it->first != mNextSeqNumber) {
+		// Missing packets are lost, and the next packet can't be known to start a frame
+		PLOG_VERBOSE << "RTP packets lost, count=" << (it->first - mNextSeqNumber);
+		mLostPackets += size_t(it->first - mNextSeqNumber);
+		mNextSeqNumber = it->first;
+		mFrameStart = false;
+		mPreviousTimestamp.reset();
+		mKeyframeNeeded = true;
+		mStarted = true;
+		return;
+	}
+
+	// Drop the packets of the incomplete frame
+	PLOG_VERBOSE << "Dropping incomplete frame";
+	const uint32_t timestamp = Header(it->second.packet)->timestamp();
+	while (it != mPackets.cend() && it->first == mNextSeqNumber &&
+	       Header(it->second.packet)->timestamp() == timestamp) {
+		const bool marker = Header(it->second.packet)->marker();
+		drop(it);
+		if (marker)
+			break;
+
+		it = mPackets.cbegin();
+	}
+	mKeyframeNeeded = true;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -35,6 +35,30 @@ RtpPacketizationConfig::RtpPacketizationConfig(SSRC ssrc, string cname, uint8_t
 	timestamp = startTimestamp = uniform();
 }
 
+RtpExtensionMap RtpPacketizationConfig::extensionMap() const {
+	using Extension = RtpExtensionMap::Extension;
+	RtpExtensionMap map;
+	map.set(Extension::VideoOrientation, videoOrientationId);
+	map.set(Extension::Mid, midId);
+	map.set(Extension::Rid, ridId);
+	map.set(Extension::PlayoutDelay, playoutDelayId);
+	map.set(Extension::AbsSendTime, absSendTimeId);
+	map.set(Extension::TransportSequenceNumber, transportSequenceNumberId);
+	map.set(Extension::AbsCaptureTime, absCaptureTimeId);
+	return map;
+}
+
+void RtpPacketizationConfig::setExtensionMap(const RtpExtensionMap &map) {
+	using Extension = RtpExtensionMap::Extension;
+	videoOrientationId = map.id(Extension::VideoOrientation);
+	midId = map.id(Extension::Mid);
+	ridId = map.id(Extension::Rid);
+	playoutDelayId = map.id(Extension::PlayoutDelay);
+	absSendTimeId = map.id(Extension::AbsSendTime);
+	transportSequenceNumberId = map.id(Extension::TransportSequenceNumber);
+	absCaptureTimeId = map.id(Extension::AbsCaptureTime);
+}
+
 double RtpPacketizationConfig::getSecondsFromTimestamp(uint32_t timestamp, uint32_t clockRate) {
 	return double(timestamp) / double(clockRate);
 }
@@ -10,122 +10,223 @@
 
 #include "rtppacketizer.hpp"
 
+#include "impl/utils.hpp"
+
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
 namespace rtc {
 
+namespace utils = impl::utils;
+
+namespace {
+
+void WriteBigEndian(byte *out, uint64_t value, size_t size) {
+	for (size_t i = 0; i < size; ++i)
+		out[i] = byte((value >> (8 * (size - 1 - i))) & 0xFF);
+}
+
+} // namespace
+
 RtpPacketizer::RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig) : rtpConfig(rtpConfig) {}
 
 RtpPacketizer::~RtpPacketizer() {}
 
+bool RtpPacketizer::fragmentViews([[maybe_unused]] const binary &data,
+                                  [[maybe_unused]] std::vector<PayloadView> &views) {
+	// Default implementation
+	return false;
+}
+
 std::vector<binary> RtpPacketizer::fragment(binary data) {
 	// Default implementation
 	return {std::move(data)};
 }
 
 message_ptr RtpPacketizer::packetize(const binary &payload, bool mark) {
-	size_t rtpExtHeaderSize = 0;
-
-	const bool setVideoRotation = (rtpConfig->videoOrientationId != 0) &&
-	                              (rtpConfig->videoOrientationId <
-	                               15) && // needs fixing if longer extension headers are supported
-	                              mark &&
-	                              (rtpConfig->videoOrientation != 0);
-
-	if (setVideoRotation)
-		rtpExtHeaderSize += 2;
-
-	const bool setPlayoutDelay = (rtpConfig->playoutDelayId > 0 && rtpConfig->playoutDelayId < 15);
-
-	if (setPlayoutDelay)
-		rtpExtHeaderSize += 4;
-
-	if (rtpConfig->mid.has_value())
-		rtpExtHeaderSize += (1 + rtpConfig->mid->length());
-
-	if (rtpConfig->rid.has_value())
-		rtpExtHeaderSize += (1 + rtpConfig->rid->length());
-
-	if (rtpExtHeaderSize != 0)
-		rtpExtHeaderSize += 4;
+	PayloadView view;
+	view.parts[0] = {payload.data(), payload.size()};
+	return packetize(view, mark);
+}
 
-	rtpExtHeaderSize = (rtpExtHeaderSize + 3) & ~3;
+message_ptr RtpPacketizer::packetize(const PayloadView &payload, bool mark) {
+	const auto &header = headerTemplate(mark, mCaptureTime != 0);
+	const size_t headerSize = header.header.size();
+	auto message = make_message(headerSize + payload.size());
+	std::memcpy(message->data(), header.header.data(), headerSize);
 
-	auto message = make_message(RtpHeaderSize + rtpExtHeaderSize + payload.size());
-	auto *rtp = (RtpHeader *)message->data();
-	rtp->setPayloadType(rtpConfig->payloadType);
+	auto *rtp = reinterpret_cast<RtpHeader *>(message->data());
 	rtp->setSeqNumber(rtpConfig->sequenceNumber++); // increase sequence number
 	rtp->setTimestamp(rtpConfig->timestamp);
-	rtp->setSsrc(rtpConfig->ssrc);
 
-	if (mark) {
-		rtp->setMarker(true);
+	if (header.absSendTimeOffset) {
+		// 6.18 fixed-point seconds, which are the middle 24 bits of the NTP timestamp
+		const uint64_t ntpTime = utils::ntp_time();
+		WriteBigEndian(message->data() + header.absSendTimeOffset, ntpTime >> 14, 3);
 	}
 
-	if (rtpExtHeaderSize) {
-		rtp->setExtension(true);
+	if (header.absCaptureTimeOffset)
+		WriteBigEndian(message->data() + header.absCaptureTimeOffset, mCaptureTime, 8);
+
+	// The payload is written once, directly from the frame
+	byte *out = message->data() + headerSize;
+	std::memcpy(out, payload.header.data(), payload.headerSize);
+	out += payload.headerSize;
+	for (const auto &part : payload.parts) {
+		if (part.sizePrefixed) {
+			*out++ = byte(part.size >> 8);
+			*out++ = byte(part.size & 0xFF);
+		}
+		if (part.size > 0) {
+			std::memcpy(out, part.data, part.size);
+			out += part.size;
+		}
+	}
 
-		auto extHeader = rtp->getExtensionHeader();
-		extHeader->setProfileSpecificId(0xbede);
+	return message;
+}
 
-		auto headerLength = static_cast<uint16_t>(rtpExtHeaderSize / 4) - 1;
+RtpPacketizer::HeaderParams::HeaderParams(const RtpPacketizationConfig &config)
+    : ssrc(config.ssrc), payloadType(config.payloadType), extensions(config.extensionMap()),
+      videoOrientation(config.videoOrientation), mid(config.mid), rid(config.rid),
+      playoutDelayMin(config.playoutDelayMin), playoutDelayMax(config.playoutDelayMax) {}
 
-		extHeader->setHeaderLength(headerLength);
-		extHeader->clearBody();
+bool RtpPacketizer::HeaderParams::matches(const RtpPacketizationConfig &config) const {
+	return ssrc == config.ssrc && payloadType == config.payloadType &&
+	       videoOrientation == config.videoOrientation && mid == config.mid &&
+	       rid == config.rid && playoutDelayMin == config.playoutDelayMin &&
+	       playoutDelayMax == config.playoutDelayMax && extensions == config.extensionMap();
+}
 
-		size_t offset = 0;
-		if (setVideoRotation) {
-			extHeader->writeCurrentVideoOrientation(offset, rtpConfig->videoOrientationId,
-			                                        rtpConfig->videoOrientation);
-			offset += 2;
-		}
+const RtpPacketizer::HeaderTemplate &RtpPacketizer::headerTemplate(bool mark, bool captureTime) {
+	// Header templates are rebuilt only when the configuration changes
+	if (!mHeaderParams.matches(*rtpConfig)) {
+		mHeaderParams = HeaderParams(*rtpConfig);
+		mHeaderTemplates = {};
+	}
 
-		if (rtpConfig->mid.has_value()) {
-			extHeader->writeOneByteHeader(
-			    offset, rtpConfig->midId,
-			    reinterpret_cast<const std::byte *>(rtpConfig->mid->c_str()),
-			    rtpConfig->mid->length());
-			offset += (1 + rtpConfig->mid->length());
-		}
+	auto &header = mHeaderTemplates[(mark ? 1 : 0) | (captureTime ? 2 : 0)];
+	if (!header)
+		header.emplace(buildHeaderTemplate(mark, captureTime));
 
-		if (rtpConfig->rid.has_value()) {
-			extHeader->writeOneByteHeader(
-			    offset, rtpConfig->ridId,
-			    reinterpret_cast<const std::byte *>(rtpConfig->rid->c_str()),
-			    rtpConfig->rid->length());
-		}
+	return *header;
+}
 
-		if (setPlayoutDelay) {
-			uint16_t min = rtpConfig->playoutDelayMin & 0xFFF;
-			uint16_t max = rtpConfig->playoutDelayMax & 0xFFF;
+RtpPacketizer::HeaderTemplate RtpPacketizer::buildHeaderTemplate(bool mark,
+                                                                 bool captureTime) const {
+	using Extension = RtpExtensionMap::Extension;
+	const auto &params = mHeaderParams;
+	HeaderTemplate result;
+
+	struct Element {
+		uint8_t id;
+		const byte *data;
+		size_t size;
+		size_t *offset; // set to the offset of the value if not null
+	};
+
+	std::vector<Element> elements;
+	auto add = [&](Extension extension, const byte *data, size_t size, size_t *offset = nullptr) {
+		if (uint8_t id = params.extensions.id(extension); id != 0 && size > 0 && size <= 255)
+			elements.push_back({id, data, size, offset});
+	};
+
+	const byte orientation = byte(params.videoOrientation);
+	if (mark && params.videoOrientation != 0)
+		add(Extension::VideoOrientation, &orientation, 1);
+
+	if (params.mid)
+		add(Extension::Mid, reinterpret_cast<const byte *>(params.mid->data()), params.mid->size());
+
+	if (params.rid)
+		add(Extension::Rid, reinterpret_cast<const byte *>(params.rid->data()), params.rid->size());
+
+	// 12 bits for min + 12 bits for max
+	const uint16_t min = params.playoutDelayMin & 0xFFF;
+	const uint16_t max = params.playoutDelayMax & 0xFFF;
+	const byte playoutDelay[3] = {byte((min >> 4) & 0xFF),
+	                              byte(((min & 0xF) << 4) | ((max >> 8) & 0xF)), byte(max & 0xFF)};
+	add(Extension::PlayoutDelay, playoutDelay, 3);
+
+	// Values written for each packet, the transport-wide sequence number by the transport
+	const byte zeros[8] = {};
+	add(Extension::AbsSendTime, zeros, 3, &result.absSendTimeOffset);
+	add(Extension::TransportSequenceNumber, zeros, 2);
+	if (captureTime)
+		add(Extension::AbsCaptureTime, zeros, 8, &result.absCaptureTimeOffset);
+
+	// The two-byte header is only used if an element does not fit in a one-byte header
+	const bool twoByte = std::any_of(elements.begin(), elements.end(), [](const Element &e) {
+		return e.id > RtpExtensionMap::MaxOneByteId || e.size > RtpExtensionMap::MaxOneByteSize;
+	});
+
+	size_t extSize = 0;
+	for (const auto &e : elements)
+		extSize += (twoByte ? 2 : 1) + e.size;
+
+	extSize = (extSize + 3) & ~size_t(3);
+
+	result.header.resize(RtpHeaderSize + (extSize > 0 ? sizeof(RtpExtensionHeader) + extSize : 0));
+	auto *rtp = reinterpret_cast<RtpHeader *>(result.header.data());
+	rtp->preparePacket();
+	rtp->setPayloadType(params.payloadType);
+	rtp->setSsrc(params.ssrc);
+	rtp->setMarker(mark);
 
-			// 12 bits for min + 12 bits for max
-			byte data[] = {byte((min >> 4) & 0xFF), byte(((min & 0xF) << 4) | ((max >> 8) & 0xF)),
-			               byte(max & 0xFF)};
+	if (extSize > 0) {
+		rtp->setExtension(true);
 
-			extHeader->writeOneByteHeader(offset, rtpConfig->playoutDelayId, data, 3);
-			offset += 4;
+		auto extHeader = rtp->getExtensionHeader();
+		extHeader->setProfileSpecificId(twoByte ? 0x1000 : 0xBEDE);
+		extHeader->setHeaderLength(uint16_t(extSize / 4));
+
+		auto out = reinterpret_cast<byte *>(extHeader->getBody());
+		for (const auto &e : elements) {
+			if (twoByte) {
+				*out++ = byte(e.id);
+				*out++ = byte(e.size);
+			} else {
+				*out++ = byte(e.id << 4 | (e.size - 1));
+			}
+
+			if (e.offset)
+				*e.offset = size_t(out - result.header.data());
+
+			std::memcpy(out, e.data, e.size);
+			out += e.size;
 		}
 	}
 
-	rtp->preparePacket();
-
-	std::memcpy(message->data() + RtpHeaderSize + rtpExtHeaderSize, payload.data(), payload.size());
-
-	return message;
+	return result;
 }
 
 message_ptr RtpPacketizer::packetize(shared_ptr<binary> payload, bool mark) {
 	return packetize(*payload, mark);
 }
 
-void RtpPacketizer::media([[maybe_unused]] const Description::Media &desc) {}
+void RtpPacketizer::media(const Description::Media &desc) {
+	if (!rtpConfig->registerNegotiatedExtensions)
+		return;
+
+	// Negotiated header extensions are registered unless already set or their ID is taken
+	const RtpExtensionMap negotiated(desc);
+	auto map = rtpConfig->extensionMap();
+	for (size_t i = 0; i < RtpExtensionMap::ExtensionCount; ++i) {
+		const auto extension = RtpExtensionMap::Extension(i);
+		const uint8_t id = negotiated.id(extension);
+		if (id != 0 && map.id(extension) == 0 && !map.find(id))
+			map.set(extension, id);
+	}
+	rtpConfig->setExtensionMap(map);
+}
 
 void RtpPacketizer::outgoing(message_vector &messages,
                              [[maybe_unused]] const message_callback &send) {
 	message_vector result;
+	std::vector<PayloadView> views;
 	for (const auto &message : messages) {
+		mCaptureTime = 0;
 		if (const auto &frameInfo = message->frameInfo) {
 			if (frameInfo->payloadType && frameInfo->payloadType != rtpConfig->payloadType)
 				continue;
@@ -137,6 +238,17 @@ void RtpPacketizer::outgoing(message_vector &messages,
 				        std::chrono::duration<double>(*frameInfo->timestampSeconds).count());
 			else
 				rtpConfig->timestamp = frameInfo->timestamp;
+
+			if (frameInfo->captureTime && rtpConfig->absCaptureTimeId != 0)
+				mCaptureTime = utils::ntp_time(*frameInfo->captureTime);
+		}
+
+		views.clear();
+		if (fragmentViews(*message, views)) {
+			for (size_t i = 0; i < views.size(); ++i)
+				result.push_back(packetize(views[i], i + 1 == views.size()));
+
+			continue;
 		}
 
 		auto payloads = fragment(std::move(*message));
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtxunwrapper.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+
+namespace rtc {
+
+RtxUnwrapper::RtxUnwrapper(SSRC ssrc, SSRC rtxSsrc, std::map<uint8_t, uint8_t> payloadTypes)
+    : mSsrcs{{rtxSsrc, ssrc}}, mPayloadTypes(std::move(payloadTypes)) {}
+
+RtxUnwrapper::RtxUnwrapper(const Description::Media &media) {
+	for (auto [rtxSsrc, ssrc] : media.getRtxSSRCs())
+		mSsrcs.emplace(rtxSsrc, ssrc);
+
+	for (auto [payloadType, origPayloadType] : media.rtxPayloadTypes())
+		mPayloadTypes.emplace(uint8_t(payloadType), uint8_t(origPayloadType));
+}
+
+void RtxUnwrapper::incoming(message_vector &messages,
+                            [[maybe_unused]] const message_callback &send) {
+	message_vector result;
+	for (auto &message : messages) {
+		if (message->type == Message::Control || message->size() < sizeof(RtpHeader)) {
+			result.push_back(std::move(message));
+			continue;
+		}
+
+		auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+		auto it = mSsrcs.find(rtp->ssrc());
+		if (it == mSsrcs.end()) {
+			result.push_back(std::move(message));
+			continue;
+		}
+
+		if (auto packet = unwrap(message, it->second))
+			result.push_back(std::move(packet));
+	}
+
+	messages.swap(result);
+}
+
+message_ptr RtxUnwrapper::unwrap(const message_ptr &message, SSRC ssrc) const {
+	auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+	auto it = mPayloadTypes.find(rtp->payloadType());
+	if (it == mPayloadTypes.end()) {
+		PLOG_VERBOSE << "Unknown RTX payload type " << int(rtp->payloadType()) << ", dropping";
+		return nullptr;
+	}
+
+	// Check bounds before reading CSRCs and the extension header
+	size_t headerSize = rtp->getSize();
+	if (rtp->extension()) {
+		if (headerSize + sizeof(RtpExtensionHeader) > message->size())
+			return nullptr;
+
+		headerSize += rtp->getExtensionHeaderSize();
+	}
+	if (headerSize > message->size())
+		return nullptr;
+
+	// See https://www.rfc-editor.org/rfc/rfc4588.html#section-4
+	const size_t paddingSize = rtp->padding() && message->size() > headerSize
+	                               ? std::to_integer<size_t>(message->back())
+	                               : 0;
+	if (headerSize + paddingSize + 2 > message->size())
+		return nullptr; // padding-only packet, used for probing
+
+	const uint16_t osn = uint16_t(std::to_integer<uint16_t>(message->at(headerSize)) << 8 |
+	                              std::to_integer<uint16_t>(message->at(headerSize + 1)));
+
+	auto packet = make_message(message->size() - 2, message); // copies the header
+	std::copy(message->begin() + headerSize + 2, message->end(), packet->begin() + headerSize);
+
+	auto packetRtp = reinterpret_cast<RtpHeader *>(packet->data());
+	packetRtp->setSsrc(ssrc);
+	packetRtp->setPayloadType(it->second);
+	packetRtp->setSeqNumber(osn);
+	packet->stream = ssrc;
+	return packet;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "vp8rtpdepacketizer.hpp"
+
+#include "impl/internals.hpp"
+
+#include <chrono>
+
+namespace rtc {
+
+namespace {
+
+// Parse the payload descriptor and return its size, or 0 if it is invalid
+// See https://www.rfc-editor.org/rfc/rfc7741.html#section-4.2
+size_t ParseDescriptor(const byte *payload, size_t size, bool &start) {
+	if (size < 1)
+		return 0;
+
+	const uint8_t first = uint8_t(payload[0]);
+	start = (first & 0x10) != 0 && (first & 0x07) == 0; // S bit and partition index 0
+	size_t offset = 1;
+	if (first & 0x80) { // X
+		if (size < 2)
+			return 0;
+
+		const uint8_t extension = uint8_t(payload[1]);
+		offset = 2;
+		if (extension & 0x80) { // I
+			if (size < offset + 1)
+				return 0;
+
+			offset += (uint8_t(payload[offset]) & 0x80) ? 2 : 1; // M
+		}
+		if (extension & 0x40) // L
+			offset += 1;
+
+		if (extension & 0x30) // T or K
+			offset += 1;
+	}
+	return offset <= size ? offset : 0;
+}
+
+} // namespace
+
+VP8RtpDepacketizer::VP8RtpDepacketizer(std::chrono::milliseconds latency)
+    : mJitterBuffer(latency) {}
+
+message_ptr VP8RtpDepacketizer::buildFrame(const message_vector &packets) {
+	binary frame;
+	for (size_t i = 0; i < packets.size(); ++i) {
+		const auto &pkt = packets[i];
+		auto header = reinterpret_cast<const RtpHeader *>(pkt->data());
+		size_t headerSize = header->getSize() + header->getExtensionHeaderSize();
+		size_t paddingSize = header->padding() ? std::to_integer<uint8_t>(pkt->back()) : 0;
+		if (pkt->size() < headerSize + paddingSize) {
+			PLOG_VERBOSE << "VP8 RTP packet is truncated";
+			return nullptr;
+		}
+
+		const size_t payloadSize = pkt->size() - headerSize - paddingSize;
+		bool start = false;
+		const size_t descriptorSize = ParseDescriptor(pkt->data() + headerSize, payloadSize, start);
+		if (descriptorSize == 0) {
+			PLOG_VERBOSE << "VP8 RTP packet has an invalid payload descriptor";
+			return nullptr;
+		}
+		if (start != (i == 0)) {
+			PLOG_VERBOSE << "VP8 frame does not start with its first packet, dropping it";
+			return nullptr;
+		}
+
+		auto begin = pkt->begin() + headerSize + descriptorSize;
+		frame.insert(frame.end(), begin, begin + (payloadSize - descriptorSize));
+	}
+
+	auto header = reinterpret_cast<const RtpHeader *>(packets.front()->data());
+	auto frameInfo = std::make_shared<FrameInfo>(header->timestamp());
+	frameInfo->timestampSeconds =
+	    std::chrono::duration<double>(double(header->timestamp()) / double(ClockRate));
+	frameInfo->payloadType = header->payloadType();
+	return make_message(std::move(frame), frameInfo);
+}
+
+void VP8RtpDepacketizer::incoming(message_vector &messages, const message_callback &send) {
+	message_vector result;
+	for (auto &message : messages) {
+		if (message->type == Message::Control) {
+			result.push_back(std::move(message));
+			continue;
+		}
+
+		if (message->size() < sizeof(RtpHeader)) {
+			PLOG_VERBOSE << "RTP packet is too small, size=" << message->size();
+			continue;
+		}
+
+		mJitterBuffer.insert(std::move(message));
+	}
+
+	message_vector packets;
+	while (mJitterBuffer.pop(packets))
+		if (auto frame = buildFrame(packets))
+			result.push_back(std::move(frame));
+
+	mJitterBuffer.signalLosses(*this, send);
+	mJitterBuffer.schedulePoll(*this);
+	messages.swap(result);
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "vp8rtppacketizer.hpp"
+
+#include "impl/utils.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+namespace rtc {
+
+namespace {
+
+// X bit, extended control bits, and 15-bit picture ID
+const size_t DescriptorSize = 4;
+
+const uint8_t ExtendedBit = 0x80;      // X
+const uint8_t StartBit = 0x10;         // S
+const uint8_t PictureIdBit = 0x80;     // I
+const uint8_t LongPictureIdBit = 0x80; // M
+
+} // namespace
+
+VP8RtpPacketizer::VP8RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig,
+                                   size_t maxFragmentSize)
+    : RtpPacketizer(std::move(rtpConfig)), mMaxFragmentSize(maxFragmentSize) {
+	if (mMaxFragmentSize <= DescriptorSize)
+		throw std::invalid_argument("Max fragment size is too small for VP8");
+
+	auto uniform =
+	    std::bind(std::uniform_int_distribution<uint32_t>(), impl::utils::random_engine());
+	mPictureId = uint16_t(uniform() & 0x7FFF);
+}
+
+bool VP8RtpPacketizer::fragmentViews(const binary &data, std::vector<PayloadView> &views) {
+	if (data.empty())
+		return true;
+
+	// The frame is split in fragments of even size, without looking for partition boundaries, so
+	// the partition index is always 0
+	const size_t maxPayloadSize = mMaxFragmentSize - DescriptorSize;
+	const size_t count = (data.size() + maxPayloadSize - 1) / maxPayloadSize;
+	const size_t fragmentSize = (data.size() + count - 1) / count;
+	for (size_t offset = 0; offset < data.size(); offset += fragmentSize) {
+		PayloadView view;
+		view.header = {byte(ExtendedBit | (offset == 0 ? StartBit : 0)), byte(PictureIdBit),
+		               byte(LongPictureIdBit | mPictureId >> 8), byte(mPictureId & 0xFF)};
+		view.headerSize = DescriptorSize;
+		view.parts[0] = {data.data() + offset, std::min(fragmentSize, data.size() - offset)};
+		views.push_back(view);
+	}
+
+	mPictureId = (mPictureId + 1) & 0x7FFF;
+	return true;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "vp9rtpdepacketizer.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rtc {
+
+namespace {
+
+struct Descriptor {
+	size_t size = 0;
+	bool start = false; // B
+	bool end = false;   // E
+};
+
+// Parse the payload descriptor, in flexible or non-flexible mode, and return a size of 0 if it is
+// invalid
+// See https://www.rfc-editor.org/rfc/rfc9628.html#section-4.2
+Descriptor ParseDescriptor(const byte *payload, size_t size) {
+	Descriptor descriptor;
+	if (size < 1)
+		return descriptor;
+
+	auto at = [&](size_t offset) { return offset < size ? uint8_t(payload[offset]) : 0; };
+
+	const uint8_t first = at(0);
+	const bool flexible = first & 0x10;
+	descriptor.start = first & 0x08;
+	descriptor.end = first & 0x04;
+
+	size_t offset = 1;
+	if (first & 0x80) // I
+		offset += (at(offset) & 0x80) ? 2 : 1; // M
+
+	if (first & 0x20) // L
+		offset += flexible ? 1 : 2;            // TID, U, SID, D, and TL0PICIDX if non-flexible
+
+	if (flexible && (first & 0x40)) { // P
+		// Up to 3 reference indices, each with N set if another one follows
+		int count = 0;
+		while (at(offset++) & 0x01)
+			if (++count == 3)
+				return descriptor;
+	}
+
+	if (first & 0x02) { // V
+		// Scalability structure
+		const uint8_t ss = at(offset++);
+		const size_t spatialLayers = (ss >> 5) + 1;
+		if (ss & 0x10) // Y
+			offset += 4 * spatialLayers;
+
+		if (ss & 0x08) { // G
+			const size_t groupSize = at(offset++);
+			for (size_t i = 0; i < groupSize; ++i)
+				offset += 1 + ((at(offset) >> 2) & 0x03); // TID, U, R, and R reference indices
+		}
+	}
+
+	if (offset <= size)
+		descriptor.size = offset;
+
+	return descriptor;
+}
+
+// Append the superframe index for the given frame sizes
+// See VP9 Bitstream Specification, Annex B
+void AppendSuperframeIndex(binary &frame, const std::vector<size_t> &sizes) {
+	size_t maxSize = 0;
+	for (size_t size : sizes)
+		maxSize = std::max(maxSize, size);
+
+	size_t magnitude = 1;
+	while (magnitude < 4 && maxSize >> (8 * magnitude))
+		++magnitude;
+
+	const byte marker = byte(0xC0 | (magnitude - 1) << 3 | (sizes.size() - 1));
+	frame.push_back(marker);
+	for (size_t size : sizes)
+		for (size_t j = 0; j < magnitude; ++j)
+			frame.push_back(byte(size >> (8 * j) & 0xFF));
+
+	frame.push_back(marker);
+}
+
+} // namespace
+
+VP9RtpDepacketizer::VP9RtpDepacketizer(std::chrono::milliseconds latency)
+    : mJitterBuffer(latency) {}
+
+message_ptr VP9RtpDepacketizer::buildFrame(const message_vector &packets) {
+	// Layer frames of the picture are concatenated in a superframe
+	binary frame;
+	std::vector<size_t> layerSizes;
+	bool inLayerFrame = false;
+	for (size_t i = 0; i < packets.size(); ++i) {
+		const auto &pkt = packets[i];
+		auto header = reinterpret_cast<const RtpHeader *>(pkt->data());
+		size_t headerSize = header->getSize() + header->getExtensionHeaderSize();
+		size_t paddingSize = header->padding() ? std::to_integer<uint8_t>(pkt->back()) : 0;
+		if (pkt->size() < headerSize + paddingSize) {
+			PLOG_VERBOSE << "VP9 RTP packet is truncated";
+			return nullptr;
+		}
+
+		const size_t payloadSize = pkt->size() - headerSize - paddingSize;
+		const auto descriptor = ParseDescriptor(pkt->data() + headerSize, payloadSize);
+		if (descriptor.size == 0) {
+			PLOG_VERBOSE << "VP9 RTP packet has an invalid payload descriptor";
+			return nullptr;
+		}
+		if (descriptor.start == inLayerFrame) {
+			PLOG_VERBOSE << "VP9 layer frame boundaries are inconsistent, dropping frame";
+			return nullptr;
+		}
+		if (descriptor.start)
+			layerSizes.push_back(0);
+
+		auto begin = pkt->begin() + headerSize + descriptor.size;
+		frame.insert(frame.end(), begin, begin + (payloadSize - descriptor.size));
+		layerSizes.back() += payloadSize - descriptor.size;
+		inLayerFrame = !descriptor.end;
+	}
+
+	if (inLayerFrame) {
+		PLOG_VERBOSE << "VP9 layer frame is incomplete, dropping frame";
+		return nullptr;
+	}
+
+	if (layerSizes.size() > 8) {
+		PLOG_VERBOSE << "VP9 picture has too many layer frames, dropping it";
+		return nullptr;
+	}
+
+	if (layerSizes.size() > 1)
+		AppendSuperframeIndex(frame, layerSizes);
+
+	auto header = reinterpret_cast<const RtpHeader *>(packets.front()->data());
+	auto frameInfo = std::make_shared<FrameInfo>(header->timestamp());
+	frameInfo->timestampSeconds =
+	    std::chrono::duration<double>(double(header->timestamp()) / double(ClockRate));
+	frameInfo->payloadType = header->payloadType();
+	return make_message(std::move(frame), frameInfo);
+}
+
+void VP9RtpDepacketizer::incoming(message_vector &messages, const message_callback &send) {
+	message_vector result;
+	for (auto &message : messages) {
+		if (message->type == Message::Control) {
+			result.push_back(std::move(message));
+			continue;
+		}
+
+		if (message->size() < sizeof(RtpHeader)) {
+			PLOG_VERBOSE << "RTP packet is too small, size=" << message->size();
+			continue;
+		}
+
+		mJitterBuffer.insert(std::move(message));
+	}
+
+	message_vector packets;
+	while (mJitterBuffer.pop(packets))
+		if (auto frame = buildFrame(packets))
+			result.push_back(std::move(frame));
+
+	mJitterBuffer.signalLosses(*this, send);
+	mJitterBuffer.schedulePoll(*this);
+	messages.swap(result);
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
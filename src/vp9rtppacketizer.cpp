@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "vp9rtppacketizer.hpp"
+
+#include "impl/internals.hpp"
+#include "impl/utils.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+namespace rtc {
+
+namespace {
+
+// Flags, 15-bit picture ID, and up to 3 reference indices
+const size_t MaxDescriptorSize = 6;
+
+const uint8_t PictureIdBit = 0x80;     // I
+const uint8_t InterPictureBit = 0x40;  // P
+const uint8_t FlexibleModeBit = 0x10;  // F
+const uint8_t StartBit = 0x08;         // B
+const uint8_t EndBit = 0x04;           // E
+const uint8_t LongPictureIdBit = 0x80; // M
+const uint8_t NextReferenceBit = 0x01; // N
+
+const uint64_t MaxReferenceDiff = 127; // 7-bit P_DIFF
+
+// Reference slots used and refreshed by a frame
+struct FrameReferences {
+	std::array<uint8_t, 3> slots = {}; // LAST, GOLDEN, and ALTREF slots if inter
+	size_t count = 0;
+	uint8_t refreshFlags = 0;
+};
+
+// Read the reference slots from the start of the uncompressed header, return false if invalid
+// See VP9 Bitstream Specification, section 6.2
+bool ParseFrameReferences(const byte *frame, size_t size, FrameReferences &refs) {
+	size_t bit = 0;
+	auto read = [&](size_t count) {
+		uint32_t value = 0;
+		for (size_t i = 0; i < count; ++i, ++bit)
+			value = value << 1 |
+			        (bit / 8 < size ? uint32_t(frame[bit / 8]) >> (7 - bit % 8) & 0x1 : 0);
+		return value;
+	};
+
+	refs = FrameReferences();
+	if (read(2) != 0x2) // frame_marker
+		return false;
+
+	const uint32_t profileLowBit = read(1);
+	const uint32_t profile = profileLowBit | read(1) << 1;
+	if (profile == 3)
+		read(1); // reserved_zero
+
+	if (read(1)) { // show_existing_frame
+		refs.slots[refs.count++] = uint8_t(read(3));
+		return bit <= size * 8;
+	}
+
+	const bool keyFrame = read(1) == 0;
+	const bool showFrame = read(1);
+	const bool errorResilientMode = read(1);
+	if (keyFrame) {
+		refs.refreshFlags = 0xFF;
+		return bit <= size * 8;
+	}
+
+	const bool intraOnly = !showFrame && read(1);
+	if (!errorResilientMode)
+		read(2); // reset_frame_context
+
+	if (intraOnly) {
+		read(24); // frame_sync_code
+		if (profile > 0) {
+			// color_config
+			if (profile >= 2)
+				read(1); // ten_or_twelve_bit
+
+			const bool rgb = read(3) == 7; // color_space
+			if (!rgb)
+				read(1); // color_range
+
+			if (profile == 1 || profile == 3)
+				read(rgb ? 1 : 3); // subsampling_x, subsampling_y, and reserved_zero
+		}
+		refs.refreshFlags = uint8_t(read(8));
+		return bit <= size * 8;
+	}
+
+	refs.refreshFlags = uint8_t(read(8));
+	for (size_t i = 0; i < 3; ++i) {
+		const auto slot = uint8_t(read(3)); // ref_frame_idx
+		read(1);                            // ref_frame_sign_bias
+		if (std::find(refs.slots.begin(), refs.slots.begin() + refs.count, slot) ==
+		    refs.slots.begin() + refs.count)
+			refs.slots[refs.count++] = slot;
+	}
+	return bit <= size * 8;
+}
+
+} // namespace
+
+VP9RtpPacketizer::VP9RtpPacketizer(shared_ptr<RtpPacketizationConfig> rtpConfig,
+                                   size_t maxFragmentSize)
+    : RtpPacketizer(std::move(rtpConfig)), mMaxFragmentSize(maxFragmentSize) {
+	if (mMaxFragmentSize <= MaxDescriptorSize)
+		throw std::invalid_argument("Max fragment size is too small for VP9");
+
+	auto uniform =
+	    std::bind(std::uniform_int_distribution<uint32_t>(), impl::utils::random_engine());
+	mPictureId = uint16_t(uniform() & 0x7FFF);
+}
+
+std::vector<RtpPacketizer::PayloadView::Part>
+VP9RtpPacketizer::splitSuperframe(const binary &data) {
+	// See VP9 Bitstream Specification, Annex B
+	const uint8_t marker = uint8_t(data.back());
+	if ((marker & 0xE0) == 0xC0) {
+		const size_t frames = (marker & 0x07) + 1;
+		const size_t magnitude = (marker >> 3 & 0x03) + 1;
+		const size_t indexSize = 2 + magnitude * frames;
+		if (data.size() > indexSize && uint8_t(data[data.size() - indexSize]) == marker) {
+			std::vector<PayloadView::Part> result;
+			const byte *index = data.data() + data.size() - indexSize + 1;
+			size_t offset = 0;
+			for (size_t i = 0; i < frames; ++i) {
+				size_t size = 0;
+				for (size_t j = 0; j < magnitude; ++j)
+					size |= size_t(index[i * magnitude + j]) << (8 * j);
+
+				if (size == 0 || offset + size > data.size() - indexSize) {
+					PLOG_WARNING << "Invalid VP9 superframe index, sending it as a single frame";
+					return {{data.data(), data.size()}};
+				}
+
+				result.push_back({data.data() + offset, size});
+				offset += size;
+			}
+			return result;
+		}
+	}
+	return {{data.data(), data.size()}};
+}
+
+bool VP9RtpPacketizer::fragmentViews(const binary &data, std::vector<PayloadView> &views) {
+	if (data.empty())
+		return true;
+
+	// The picture references the slots used by its frames before any frame of the superframe
+	// refreshes them, then it is the picture held by the slots its frames refresh
+	std::array<byte, 8> header = {};
+	size_t headerSize = 3;
+	uint8_t refreshFlags = 0;
+	bool unknownReference = false;
+	for (const auto &frame : splitSuperframe(data)) {
+		FrameReferences refs;
+		if (!ParseFrameReferences(frame.data, frame.size, refs)) {
+			PLOG_WARNING << "Invalid VP9 frame header, dropping frame";
+			return true;
+		}
+
+		for (size_t i = 0; i < refs.count; ++i) {
+			const uint8_t slot = refs.slots[i];
+			if (refreshFlags & (1 << slot))
+				continue;
+
+			const auto &picture = mSlotPictures[slot];
+			const uint64_t diff = picture ? mPictureCount - *picture : 0;
+			if (diff == 0 || diff > MaxReferenceDiff) {
+				unknownReference = true;
+				continue;
+			}
+
+			const auto pdiff = byte(diff << 1);
+			const auto end = header.begin() + headerSize;
+			if (std::find(header.begin() + 3, end, pdiff) == end)
+				header[headerSize++] = pdiff;
+		}
+		refreshFlags |= refs.refreshFlags;
+	}
+
+	// An inter-picture predicted picture must signal its reference indices in flexible mode
+	if (unknownReference && headerSize == 3) {
+		PLOG_WARNING << "VP9 frame references unknown pictures, dropping frame";
+		return true;
+	}
+
+	const bool inter = headerSize > 3;
+	header[0] = byte(PictureIdBit | FlexibleModeBit | (inter ? InterPictureBit : 0));
+	header[1] = byte(LongPictureIdBit | mPictureId >> 8);
+	header[2] = byte(mPictureId & 0xFF);
+	for (size_t i = 3; i + 1 < headerSize; ++i)
+		header[i] |= byte(NextReferenceBit);
+
+	const size_t maxPayloadSize = mMaxFragmentSize - headerSize;
+	const size_t count = (data.size() + maxPayloadSize - 1) / maxPayloadSize;
+	const size_t fragmentSize = (data.size() + count - 1) / count;
+	for (size_t offset = 0; offset < data.size(); offset += fragmentSize) {
+		const size_t size = std::min(fragmentSize, data.size() - offset);
+		PayloadView view;
+		view.header = header;
+		view.header[0] |=
+		    byte((offset == 0 ? StartBit : 0) | (offset + size == data.size() ? EndBit : 0));
+		view.headerSize = headerSize;
+		view.parts[0] = {data.data() + offset, size};
+		views.push_back(view);
+	}
+
+	for (size_t slot = 0; slot < mSlotPictures.size(); ++slot)
+		if (refreshFlags & (1 << slot))
+			mSlotPictures[slot] = mPictureCount;
+
+	++mPictureCount;
+	mPictureId = (mPictureId + 1) & 0x7FFF;
+	return true;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
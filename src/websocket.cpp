@@ -68,6 +68,12 @@ optional<string> WebSocket::path() const {
 	return state != State::Connecting && handshake ? make_optional(handshake->path()) : nullopt;
 }
 
+size_t WebSocket::bytesSent() const { return impl()->bytesSent(); }
+
+size_t WebSocket::bytesDropped() const { return impl()->bytesDropped(); }
+
+size_t WebSocket::messagesDropped() const { return impl()->messagesDropped(); }
+
 std::ostream &operator<<(std::ostream &out, WebSocket::State state) {
 	using State = WebSocket::State;
 	const char *str;
@@ -25,12 +25,23 @@ WebSocketServer::~WebSocketServer() { impl()->stop(); }
 
 void WebSocketServer::stop() { impl()->stop(); }
 
-uint16_t WebSocketServer::port() const { return impl()->tcpServer->port(); }
+uint16_t WebSocketServer::port() const { return impl()->tcpServers.front()->port(); }
 
 void WebSocketServer::onClient(std::function<void(shared_ptr<WebSocket>)> callback) {
 	impl()->clientCallback = callback;
 }
 
+size_t WebSocketServer::broadcast(const std::vector<shared_ptr<WebSocket>> &clients,
+                                  message_variant data) {
+	std::vector<shared_ptr<impl::WebSocket>> impls;
+	impls.reserve(clients.size());
+	for (const auto &client : clients)
+		if (client)
+			impls.push_back(client->impl());
+
+	return impl()->broadcast(impls, make_message(std::move(data)));
+}
+
 } // namespace rtc
 
 #endif
@@ -162,17 +162,97 @@ size_t benchmark(milliseconds duration) {
 }
 
 #ifdef BENCHMARK_MAIN
+void benchmark_fastopen();
+#if RTC_ENABLE_MEDIA
+void benchmark_startsequence();
+void benchmark_packetizer();
+#endif
+#if RTC_ENABLE_WEBSOCKET
+void benchmark_websocket();
+void benchmark_wscodec();
+void benchmark_wshttp();
+void benchmark_wsaccept();
+void benchmark_wsidle();
+#endif
+
 int main(int argc, char **argv) {
 	try {
 		size_t goodput = benchmark(30s);
 		if (goodput == 0)
 			throw runtime_error("No data received");
 
-		return 0;
-
 	} catch (const std::exception &e) {
 		cerr << "Benchmark failed: " << e.what() << endl;
 		return -1;
 	}
+	try {
+		cout << endl << "*** Running SCTP fast-open benchmark..." << endl;
+		benchmark_fastopen();
+		cout << "*** Finished SCTP fast-open benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "SCTP fast-open benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+#if RTC_ENABLE_MEDIA
+	try {
+		cout << endl << "*** Running NAL unit start sequence benchmark..." << endl;
+		benchmark_startsequence();
+		cout << "*** Finished NAL unit start sequence benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "NAL unit start sequence benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running RTP packetizer benchmark..." << endl;
+		benchmark_packetizer();
+		cout << "*** Finished RTP packetizer benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "RTP packetizer benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+#endif
+#if RTC_ENABLE_WEBSOCKET
+	try {
+		cout << endl << "*** Running WebSocket benchmark..." << endl;
+		benchmark_websocket();
+		cout << "*** Finished WebSocket benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "WebSocket benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket codec benchmark..." << endl;
+		benchmark_wscodec();
+		cout << "*** Finished WebSocket codec benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "WebSocket codec benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket HTTP parsing benchmark..." << endl;
+		benchmark_wshttp();
+		cout << "*** Finished WebSocket HTTP parsing benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "WebSocket HTTP parsing benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocketServer accept benchmark..." << endl;
+		benchmark_wsaccept();
+		cout << "*** Finished WebSocketServer accept benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "WebSocketServer accept benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket idle memory benchmark..." << endl;
+		benchmark_wsidle();
+		cout << "*** Finished WebSocket idle memory benchmark" << endl;
+	} catch (const std::exception &e) {
+		cerr << "WebSocket idle memory benchmark failed: " << e.what() << endl;
+		return -1;
+	}
+#endif
+	return 0;
 }
 #endif
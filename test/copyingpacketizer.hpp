@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+// Copying packetizers and sample frames shared by the packetizer test and benchmark
+
+#ifndef RTC_TEST_COPYING_PACKETIZER_H
+#define RTC_TEST_COPYING_PACKETIZER_H
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef RTC_SAMPLES_DIR
+#define RTC_SAMPLES_DIR "examples/streamer/samples"
+#endif
+
+namespace copying {
+
+using namespace rtc;
+using std::make_unique;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+const size_t MaxFragmentSize = RtpPacketizer::DefaultMaxFragmentSize;
+
+// Copying packetization, as previously implemented by the packetizers, for comparison
+class CopyingNalPacketizer final : public RtpPacketizer {
+public:
+	CopyingNalPacketizer(bool h265, shared_ptr<RtpPacketizationConfig> rtpConfig)
+	    : RtpPacketizer(std::move(rtpConfig)), mH265(h265) {}
+
+private:
+	template <typename T> vector<T> split(const binary &frame) {
+		vector<T> nalus;
+		size_t index = 0;
+		while (index + 4 < frame.size()) {
+			size_t length = 0;
+			for (size_t i = 0; i < 4; ++i)
+				length = length << 8 | size_t(frame[index + i]);
+
+			index += 4;
+			nalus.emplace_back(frame.begin() + index, frame.begin() + index + length);
+			index += length;
+		}
+		return nalus;
+	}
+
+	vector<binary> fragment(binary data) override {
+		if (mH265)
+			return H265NalUnit::GenerateFragments(split<H265NalUnit>(data), MaxFragmentSize);
+		else
+			return NalUnit::GenerateFragments(split<NalUnit>(data), MaxFragmentSize);
+	}
+
+	const bool mH265;
+};
+
+class CopyingAV1Packetizer final : public RtpPacketizer {
+public:
+	CopyingAV1Packetizer(shared_ptr<RtpPacketizationConfig> rtpConfig)
+	    : RtpPacketizer(std::move(rtpConfig)) {}
+
+private:
+	vector<binary> fragment(binary data) override {
+		vector<binary> result;
+		size_t index = 2; // temporal unit delimiter
+		while (index < data.size()) {
+			const size_t headerSize = (data[index] & byte(0x04)) != byte(0) ? 2 : 1;
+			size_t length = 0, lebSize = 0;
+			uint8_t b;
+			do {
+				b = uint8_t(data[index + headerSize + lebSize]);
+				length |= size_t(b & 0x7F) << (7 * lebSize++);
+			} while (b & 0x80);
+
+			const size_t size = headerSize + lebSize + length;
+			auto fragments = fragmentObu(binary(data.begin() + index, data.begin() + index + size));
+			for (auto &fragment : fragments)
+				result.push_back(std::move(fragment));
+
+			index += size;
+		}
+		return result;
+	}
+
+	vector<binary> fragmentObu(const binary &obu) {
+		if ((uint8_t(obu[0]) >> 3 & 0x0F) == 1) {
+			mSequenceHeader = make_unique<binary>(obu);
+			return {};
+		}
+
+		vector<binary> payloads;
+		size_t index = 0;
+		while (index < obu.size()) {
+			size_t metadataSize = 1;
+			if (mSequenceHeader)
+				metadataSize += 1 + mSequenceHeader->size();
+
+			binary payload(std::min(MaxFragmentSize, obu.size() - index + metadataSize));
+			payload[0] = byte((mSequenceHeader ? 2 : 1) << 4);
+			size_t offset = 1;
+			if (mSequenceHeader) {
+				payload[0] |= byte(0x08);
+				payload[1] = byte(mSequenceHeader->size() & 0x7F);
+				std::memcpy(payload.data() + 2, mSequenceHeader->data(), mSequenceHeader->size());
+				offset += 1 + mSequenceHeader->size();
+				mSequenceHeader.reset();
+			}
+
+			const size_t size = payload.size() - offset;
+			std::memcpy(payload.data() + offset, obu.data() + index, size);
+			if (index > 0)
+				payload[0] |= byte(0x80);
+
+			index += size;
+			if (index < obu.size())
+				payload[0] |= byte(0x40);
+
+			payloads.push_back(std::move(payload));
+		}
+		return payloads;
+	}
+
+	unique_ptr<binary> mSequenceHeader;
+};
+
+// Load the sample frames, which are stored with length prefixes
+inline vector<binary> load_samples() {
+	vector<binary> frames;
+	for (int i = 0;; ++i) {
+		std::ifstream file(string(RTC_SAMPLES_DIR) + "/h264/sample-" + std::to_string(i) + ".h264",
+		              std::ios::binary);
+		if (!file)
+			break;
+
+		const string content(std::istreambuf_iterator<char>(file), {});
+		const auto data = reinterpret_cast<const byte *>(content.data());
+		frames.emplace_back(data, data + content.size());
+	}
+	return frames;
+}
+
+// Wrap each frame in an AV1 temporal unit, with a sequence header every 30 frames
+inline vector<binary> make_av1_frames(const vector<binary> &frames) {
+	vector<binary> result;
+	std::mt19937 generator(42);
+	for (size_t i = 0; i < frames.size(); ++i) {
+		binary tu = {byte(0x12), byte(0x00)}; // temporal unit delimiter
+		if (i % 30 == 0) {
+			tu.insert(tu.end(), {byte(0x0A), byte(10)}); // sequence header with size
+			for (int j = 0; j < 10; ++j)
+				tu.push_back(byte(generator()));
+		}
+
+		tu.push_back(byte(0x32)); // frame with size
+		size_t size = frames[i].size();
+		do {
+			tu.push_back(byte((size & 0x7F) | (size > 0x7F ? 0x80 : 0)));
+			size >>= 7;
+		} while (size > 0);
+
+		tu.insert(tu.end(), frames[i].begin(), frames[i].end());
+		result.push_back(std::move(tu));
+	}
+	return result;
+}
+
+} // namespace copying
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_TEST_COPYING_PACKETIZER_H */
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "relay.hpp"
+#include "rtc/rtc.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+#ifndef _WIN32
+
+namespace {
+
+const auto OneWayDelay = 25ms;
+const int Iterations = 10;
+
+// Median time from setRemoteDescription to the first DataChannel message, with a simulated
+// network delay so that round trips dominate processing times
+double median_seconds(const Configuration &config, bool negotiated) {
+	vector<double> samples;
+	for (int i = 0; i < Iterations; ++i) {
+		relay::Relay relay(false, OneWayDelay);
+		samples.push_back(relay::connect(config, negotiated, relay).seconds);
+	}
+
+	sort(samples.begin(), samples.end());
+	return samples[samples.size() / 2];
+}
+
+void run(const string &name, bool negotiated) {
+	Configuration config;
+	const double baseline = median_seconds(config, negotiated);
+
+	Configuration fastOpen = config;
+	fastOpen.enableSctpFastOpen = true;
+	const double result = median_seconds(fastOpen, negotiated);
+
+	cout << name << ": first message after " << size_t(baseline * 1000) << " ms, "
+	     << size_t(result * 1000) << " ms with SCTP fast-open (RTT "
+	     << 2 * OneWayDelay.count() << " ms)" << endl;
+}
+
+} // namespace
+
+void benchmark_fastopen() {
+	InitLogger(LogLevel::Warning);
+
+	run("Negotiated DataChannel", true);
+	run("In-band DataChannel", false);
+}
+
+#else
+
+void benchmark_fastopen() { cout << "Skipped, the relay requires POSIX sockets" << endl; }
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "relay.hpp"
+#include "rtc/rtc.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+#ifndef _WIN32
+
+namespace {
+
+using relay::Relay;
+using relay::Result;
+
+Result measure(const string &name, const Configuration &config, bool negotiated) {
+	Relay lockStep(true), passThrough(false);
+	Result result = relay::connect(config, negotiated, lockStep);
+	result.seconds = relay::connect(config, negotiated, passThrough).seconds;
+	cout << name << ": " << result.rounds << " flights, first message after "
+	     << size_t(result.seconds * 1000) << " ms" << endl;
+	return result;
+}
+
+// Options unsupported by the TLS backend must be rejected instead of silently ignored
+bool is_supported(const string &name, const Configuration &config) {
+	try {
+		PeerConnection pc(config);
+		return true;
+	} catch (const invalid_argument &e) {
+		cout << name << " is not supported: " << e.what() << endl;
+		return false;
+	}
+}
+
+} // namespace
+
+void test_handshake() {
+	InitLogger(LogLevel::Warning);
+
+	Configuration config;
+	auto baseline = measure("DTLS 1.2", config, true);
+	if (baseline.rounds < 4)
+		throw runtime_error("Too few flights counted");
+
+	// In-band DataChannel opening goes through the DCEP handshake on top
+	auto inband = measure("DTLS 1.2 with in-band DataChannel", config, false);
+	if (inband.rounds < baseline.rounds)
+		throw runtime_error("In-band DataChannel takes fewer flights than negotiated");
+
+	Configuration dtls13 = config;
+	dtls13.enableDtls13 = true;
+	if (is_supported("DTLS 1.3", dtls13)) {
+		// RFC 9147: The DTLS 1.3 handshake saves a round trip
+		if (measure("DTLS 1.3", dtls13, true).rounds > baseline.rounds - 2)
+			throw runtime_error("DTLS 1.3 does not save a round trip");
+	}
+
+	Configuration cid = config;
+	cid.enableDtlsConnectionId = true;
+	if (is_supported("DTLS Connection ID", cid)) {
+		// RFC 9146: Connection IDs are negotiated in the existing flights
+		if (measure("DTLS 1.2 with Connection ID", cid, true).rounds != baseline.rounds)
+			throw runtime_error("Connection ID changes the flights count");
+	}
+
+	Configuration fastOpen = config;
+	fastOpen.enableSctpFastOpen = true;
+	if (measure("SCTP fast-open", fastOpen, true).rounds >= baseline.rounds)
+		throw runtime_error("SCTP fast-open does not save a flight");
+
+	cout << "Success" << endl;
+}
+
+#else
+
+void test_handshake() { cout << "Skipped, the relay requires POSIX sockets" << endl; }
+
+#endif
@@ -0,0 +1,306 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtppackets.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include "impl/init.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using clock_type = RtpJitterBuffer::clock;
+
+using rtppackets::make_packet;
+using rtppackets::seq_number;
+using rtppackets::Ssrc;
+
+namespace {
+
+// Packets of frames with the given number of packets each, starting at a sequence number
+message_vector make_frames(uint16_t seqNumber, const vector<size_t> &sizes) {
+	message_vector packets;
+	for (size_t i = 0; i < sizes.size(); ++i)
+		for (size_t j = 0; j < sizes[i]; ++j)
+			packets.push_back(
+			    make_packet(seqNumber++, uint32_t(1000 + i * 3000), j + 1 == sizes[i]));
+
+	return packets;
+}
+
+// Pop all ready frames and return the sequence numbers of their packets
+vector<vector<uint16_t>> pop_frames(RtpJitterBuffer &buffer, clock_type::time_point now) {
+	vector<vector<uint16_t>> frames;
+	message_vector packets;
+	while (buffer.pop(packets, now)) {
+		vector<uint16_t> frame;
+		for (const auto &packet : packets)
+			frame.push_back(seq_number(packet));
+
+		frames.push_back(std::move(frame));
+	}
+	return frames;
+}
+
+// Handler at the end of the chain which records loss signals
+class LossRecorder final : public MediaHandler {
+public:
+	bool requestKeyframe(const message_callback &) override {
+		++keyframeRequests;
+		return true;
+	}
+
+	bool requestRetransmission(uint32_t ssrc, const std::vector<uint16_t> &seqNumbers,
+	                           const message_callback &) override {
+		if (ssrc != Ssrc)
+			throw runtime_error("Retransmission requested for the wrong SSRC");
+
+		requested.insert(requested.end(), seqNumbers.begin(), seqNumbers.end());
+		return true;
+	}
+
+	vector<uint16_t> requested;
+	size_t keyframeRequests = 0;
+};
+
+void test_reordering() {
+	// Frames straddle the sequence number wrap-around
+	auto packets = make_frames(65530, {3, 4, 1, 5});
+	mt19937 generator(42);
+	shuffle(packets.begin(), packets.end(), generator);
+
+	RtpJitterBuffer buffer;
+	const auto now = clock_type::now();
+	for (const auto &packet : packets)
+		buffer.insert(packet, now);
+
+	buffer.insert(packets.front(), now); // duplicate
+	const vector<vector<uint16_t>> expected = {
+	    {65530, 65531, 65532}, {65533, 65534, 65535, 0}, {1}, {2, 3, 4, 5, 6}};
+	if (pop_frames(buffer, now) != expected)
+		throw runtime_error("Reordered frames not output in order");
+
+	// Reordered packets are not requested for retransmission
+	LossRecorder recorder;
+	buffer.signalLosses(recorder, nullptr, now + RtpJitterBuffer::ReorderDelay);
+	if (!recorder.requested.empty())
+		throw runtime_error("Reordered packets requested for retransmission");
+
+	if (buffer.droppedFrames() != 0 || buffer.lostPackets() != 0)
+		throw runtime_error("Unexpected loss with reordering");
+}
+
+void test_loss() {
+	auto packets = make_frames(1000, {2, 3, 2});
+	auto lost = packets[3];
+	packets.erase(packets.begin() + 3);
+
+	auto recorder = make_shared<LossRecorder>();
+	RtpJitterBuffer buffer(100ms);
+	auto now = clock_type::now();
+	for (const auto &packet : packets)
+		buffer.insert(packet, now);
+
+	// The incomplete frame is awaited, and the next one must wait behind it
+	if (pop_frames(buffer, now) != vector<vector<uint16_t>>{{1000, 1001}})
+		throw runtime_error("Incomplete frame not awaited");
+
+	// The missing packet is requested after the reorder delay
+	buffer.signalLosses(*recorder, nullptr, now);
+	if (!recorder->requested.empty())
+		throw runtime_error("Missing packet signaled before the reorder delay");
+
+	buffer.signalLosses(*recorder, nullptr, now + RtpJitterBuffer::ReorderDelay);
+	if (recorder->requested != vector<uint16_t>{1003} || recorder->keyframeRequests != 0)
+		throw runtime_error("Missing packet not signaled");
+
+	// The retransmission completes the frame before the latency
+	now += 50ms;
+	buffer.insert(lost, now);
+	const vector<vector<uint16_t>> expected = {{1002, 1003, 1004}, {1005, 1006}};
+	if (pop_frames(buffer, now) != expected)
+		throw runtime_error("Frame not completed by retransmission");
+
+	// Without retransmission, the frame is dropped after the latency
+	for (const auto &packet : make_frames(1007, {3, 2}))
+		if (seq_number(packet) != 1008)
+			buffer.insert(packet, now);
+
+	if (!pop_frames(buffer, now + 99ms).empty())
+		throw runtime_error("Incomplete frame dropped before the latency");
+
+	if (pop_frames(buffer, now + 100ms) != vector<vector<uint16_t>>{{1010, 1011}})
+		throw runtime_error("Incomplete frame not dropped after the latency");
+
+	buffer.insert(make_packet(1008, 1000, false), now + 100ms);
+	if (buffer.droppedFrames() != 1 || buffer.lostPackets() != 1 || buffer.latePackets() != 1)
+		throw runtime_error("Unexpected loss counters");
+
+	buffer.signalLosses(*recorder, nullptr, now + 100ms);
+	buffer.signalLosses(*recorder, nullptr, now + 100ms);
+	if (recorder->keyframeRequests != 1)
+		throw runtime_error("Keyframe not requested once after frame loss");
+}
+
+void test_bounded() {
+	// A gap which is never filled is skipped when the buffer is full
+	const size_t maxPackets = 64;
+	RtpJitterBuffer buffer(10s, maxPackets);
+	const auto now = clock_type::now();
+	auto packets = make_frames(0, vector<size_t>(40, 2));
+	packets.erase(packets.begin() + 1); // frame 0 is incomplete
+
+	size_t count = 0;
+	for (const auto &packet : packets) {
+		buffer.insert(packet, now);
+		count += pop_frames(buffer, now).size();
+	}
+
+	// Frames are released as soon as the limit is exceeded, only the first two are dropped
+	if (count != 38 || buffer.droppedFrames() != 2 || buffer.lostPackets() != 1)
+		throw runtime_error("Jitter buffer is not bounded");
+}
+
+void test_resync() {
+	RtpJitterBuffer buffer;
+	const auto now = clock_type::now();
+	for (const auto &packet : make_frames(30000, {2, 2}))
+		buffer.insert(packet, now);
+
+	if (pop_frames(buffer, now).size() != 2)
+		throw runtime_error("Frames not output before sequence jump");
+
+	// A single packet far from the sequence is ignored
+	buffer.insert(make_packet(10, 1000, true), now);
+	buffer.insert(make_packet(30004, 7000, true), now);
+	if (pop_frames(buffer, now) != vector<vector<uint16_t>>{{30004}})
+		throw runtime_error("Stray packet disrupted the sequence");
+
+	// The sender restarts with a lower sequence number, which is followed once confirmed
+	auto packets = make_frames(100, {2, 1});
+	buffer.insert(packets[0], now);
+	if (!pop_frames(buffer, now).empty())
+		throw runtime_error("Sequence jump followed before confirmation");
+
+	for (size_t i = 1; i < packets.size(); ++i)
+		buffer.insert(packets[i], now);
+
+	const vector<vector<uint16_t>> expected = {{100, 101}, {102}};
+	if (pop_frames(buffer, now) != expected)
+		throw runtime_error("Jitter buffer not resynchronized after sequence jump");
+
+	if (buffer.droppedFrames() != 0 || buffer.lostPackets() != 0 || buffer.latePackets() != 0)
+		throw runtime_error("Unexpected loss with sequence jump");
+}
+
+void test_interleaved_ssrc() {
+	const SSRC otherSsrc = Ssrc + 1;
+	RtpJitterBuffer buffer;
+	auto now = clock_type::now();
+	auto packets = make_frames(0, {2, 2, 2});
+	for (size_t i = 0; i < packets.size(); ++i) {
+		buffer.insert(packets[i], now);
+		buffer.insert(make_packet(uint16_t(5000 + i), 1000, true, otherSsrc), now);
+	}
+
+	const vector<vector<uint16_t>> expected = {{0, 1}, {2, 3}, {4, 5}};
+	if (pop_frames(buffer, now) != expected)
+		throw runtime_error("Interleaved SSRC disrupted the stream");
+
+	// Another SSRC is followed once the current one stopped
+	now += RtpJitterBuffer::SsrcSwitchDelay;
+	buffer.insert(make_packet(6000, 1000, true, otherSsrc), now);
+	if (pop_frames(buffer, now) != vector<vector<uint16_t>>{{6000}})
+		throw runtime_error("SSRC change not followed");
+}
+
+void test_stopped_stream() {
+	// The last incomplete frame of a stream which stops is dropped on a timer
+	auto token = impl::Init::Instance().token();
+	auto recorder = make_shared<LossRecorder>();
+	auto depacketizer = make_shared<VP8RtpDepacketizer>(20ms);
+	depacketizer->addToChain(recorder);
+
+	// Like a track, the poll callback runs the incoming chain without new messages
+	struct State {
+		mutex chainMutex;
+		size_t polls = 0;
+	};
+	auto state = make_shared<State>();
+	depacketizer->setPollCallback(
+	    [state, weak_depacketizer = weak_ptr<MediaHandler>(depacketizer)]() {
+		    if (auto locked = weak_depacketizer.lock()) {
+			    lock_guard lock(state->chainMutex);
+			    message_vector messages;
+			    locked->incomingChain(messages, nullptr);
+			    ++state->polls;
+		    }
+	    });
+
+	{
+		lock_guard lock(state->chainMutex);
+		message_vector messages = {make_packet(0, 1000, false)};
+		depacketizer->incomingChain(messages, nullptr);
+	}
+	this_thread::sleep_for(100ms);
+
+	lock_guard lock(state->chainMutex);
+	if (state->polls == 0 || recorder->keyframeRequests != 1)
+		throw runtime_error("Incomplete frame of a stopped stream not dropped");
+
+	depacketizer->setPollCallback(nullptr);
+}
+
+void test_nack() {
+	RtcpReceivingSession session;
+	message_vector sent;
+	auto send = [&sent](message_ptr message) { sent.push_back(std::move(message)); };
+
+	if (!session.requestRetransmission(Ssrc, {10, 11, 13, 40}, send) || sent.size() != 1)
+		throw runtime_error("NACK not sent");
+
+	auto nack = reinterpret_cast<RtcpNack *>(sent[0]->data());
+	if (sent[0]->size() != RtcpNack::Size(2) || nack->getSeqNoCount() != 2 ||
+	    nack->header.mediaSourceSSRC() != Ssrc)
+		throw runtime_error("Unexpected NACK");
+
+	vector<uint16_t> seqNumbers;
+	for (unsigned int i = 0; i < nack->getSeqNoCount(); ++i) {
+		auto part = nack->parts[i].getSequenceNumbers();
+		seqNumbers.insert(seqNumbers.end(), part.begin(), part.end());
+	}
+	if (seqNumbers != vector<uint16_t>{10, 11, 13, 40})
+		throw runtime_error("Unexpected NACK sequence numbers");
+}
+
+} // namespace
+
+void test_jitterbuffer() {
+	test_reordering();
+	test_loss();
+	test_bounded();
+	test_resync();
+	test_interleaved_ssrc();
+	test_stopped_stream();
+	test_nack();
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -19,12 +19,28 @@ void test_connectivity(bool signal_wrong_fingerprint);
 void test_pem();
 void test_negotiated();
 void test_reliability();
+void test_handshake();
 void test_turn_connectivity();
 void test_track();
+void test_startsequence();
+void test_packetizer();
+void test_vpx();
+void test_jitterbuffer();
+void test_nackresponder();
+void test_nackrequester();
+void test_srtpstreams();
 void test_capi_connectivity();
 void test_capi_track();
 void test_websocket();
 void test_websocketserver();
+void test_wscodec();
+void test_wsrecv();
+void test_wshttp();
+void test_wsdeflate();
+void test_wsbroadcast();
+void test_wshibernate();
+void test_wsbackpressure();
+void test_wsktls();
 void test_capi_websocketserver();
 size_t benchmark(chrono::milliseconds duration);
 
@@ -92,6 +108,14 @@ int main(int argc, char **argv) {
 		cerr << "WebRTC reliability test failed: " << e.what() << endl;
 		return -1;
 	}
+	try {
+		cout << endl << "*** Running WebRTC handshake test..." << endl;
+		test_handshake();
+		cout << "*** Finished WebRTC handshake test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebRTC handshake test failed: " << e.what() << endl;
+		return -1;
+	}
 #if RTC_ENABLE_MEDIA
 	try {
 		cout << endl << "*** Running WebRTC Track test..." << endl;
@@ -101,6 +125,62 @@ int main(int argc, char **argv) {
 		cerr << "WebRTC Track test failed: " << e.what() << endl;
 		return -1;
 	}
+	try {
+		cout << endl << "*** Running NAL unit start sequence test..." << endl;
+		test_startsequence();
+		cout << "*** Finished NAL unit start sequence test" << endl;
+	} catch (const exception &e) {
+		cerr << "NAL unit start sequence test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running RTP packetizer test..." << endl;
+		test_packetizer();
+		cout << "*** Finished RTP packetizer test" << endl;
+	} catch (const exception &e) {
+		cerr << "RTP packetizer test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running VP8/VP9 RTP packetization test..." << endl;
+		test_vpx();
+		cout << "*** Finished VP8/VP9 RTP packetization test" << endl;
+	} catch (const exception &e) {
+		cerr << "VP8/VP9 RTP packetization test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running RTP jitter buffer test..." << endl;
+		test_jitterbuffer();
+		cout << "*** Finished RTP jitter buffer test" << endl;
+	} catch (const exception &e) {
+		cerr << "RTP jitter buffer test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running RTCP NACK responder test..." << endl;
+		test_nackresponder();
+		cout << "*** Finished RTCP NACK responder test" << endl;
+	} catch (const exception &e) {
+		cerr << "RTCP NACK responder test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running RTCP NACK requester test..." << endl;
+		test_nackrequester();
+		cout << "*** Finished RTCP NACK requester test" << endl;
+	} catch (const exception &e) {
+		cerr << "RTCP NACK requester test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running SRTP streams test..." << endl;
+		test_srtpstreams();
+		cout << "*** Finished SRTP streams test" << endl;
+	} catch (const exception &e) {
+		cerr << "SRTP streams test failed: " << e.what() << endl;
+		return -1;
+	}
 #endif
 #if RTC_ENABLE_WEBSOCKET
 // TODO: Temporarily disabled as the echo service is unreliable
@@ -122,6 +202,72 @@ int main(int argc, char **argv) {
 		cerr << "WebSocketServer test failed: " << e.what() << endl;
 		return -1;
 	}
+	try {
+		cout << endl << "*** Running WebSocket codec test..." << endl;
+		test_wscodec();
+		cout << "*** Finished WebSocket codec test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket codec test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket receive test..." << endl;
+		test_wsrecv();
+		cout << "*** Finished WebSocket receive test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket receive test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket HTTP parsing test..." << endl;
+		test_wshttp();
+		cout << "*** Finished WebSocket HTTP parsing test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket HTTP parsing test failed: " << e.what() << endl;
+		return -1;
+	}
+#if RTC_ENABLE_DEFLATE
+	try {
+		cout << endl << "*** Running WebSocket deflate test..." << endl;
+		test_wsdeflate();
+		cout << "*** Finished WebSocket deflate test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket deflate test failed: " << e.what() << endl;
+		return -1;
+	}
+#endif
+	try {
+		cout << endl << "*** Running WebSocketServer broadcast test..." << endl;
+		test_wsbroadcast();
+		cout << "*** Finished WebSocketServer broadcast test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocketServer broadcast test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket hibernation test..." << endl;
+		test_wshibernate();
+		cout << "*** Finished WebSocket hibernation test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket hibernation test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket backpressure test..." << endl;
+		test_wsbackpressure();
+		cout << "*** Finished WebSocket backpressure test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket backpressure test failed: " << e.what() << endl;
+		return -1;
+	}
+	try {
+		cout << endl << "*** Running WebSocket kernel TLS test..." << endl;
+		test_wsktls();
+		cout << "*** Finished WebSocket kernel TLS test" << endl;
+	} catch (const exception &e) {
+		cerr << "WebSocket kernel TLS test failed: " << e.what() << endl;
+		return -1;
+	}
 #endif
 	try {
 		// Every created object must have been destroyed, otherwise the wait will block
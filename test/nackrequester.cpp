@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtppackets.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using clock_type = RtcpNackRequester::clock;
+
+using rtppackets::make_packet;
+using rtppackets::seq_number;
+using rtppackets::Ssrc;
+
+namespace {
+
+// Packets from first to last included, except the lost ones
+message_vector make_packets(uint16_t first, uint16_t last, const vector<uint16_t> &lost = {},
+                            SSRC ssrc = Ssrc) {
+	message_vector packets;
+	for (uint16_t s = first;; ++s) {
+		if (find(lost.begin(), lost.end(), s) == lost.end())
+			packets.push_back(make_packet(s, 0, false, ssrc));
+
+		if (s == last)
+			break;
+	}
+	return packets;
+}
+
+// Receive packets and return the requested sequence numbers by SSRC
+map<SSRC, vector<uint16_t>> receive(RtcpNackRequester &requester, message_vector packets,
+                                    clock_type::time_point now) {
+	map<SSRC, vector<uint16_t>> requested;
+	requester.incoming(
+	    packets,
+	    [&requested](message_ptr message) {
+		    auto nack = reinterpret_cast<RtcpNack *>(message->data());
+		    if (message->type != Message::Control || nack->header.header.payloadType() != 205 ||
+		        message->size() != nack->header.header.lengthInBytes())
+			    throw runtime_error("Unexpected NACK");
+
+		    auto &seqNumbers = requested[nack->header.mediaSourceSSRC()];
+		    for (unsigned int i = 0; i < nack->getSeqNoCount(); ++i) {
+			    auto part = nack->parts[i].getSequenceNumbers();
+			    seqNumbers.insert(seqNumbers.end(), part.begin(), part.end());
+		    }
+	    },
+	    now);
+	return requested;
+}
+
+vector<uint16_t> range(uint16_t first, uint16_t last) {
+	vector<uint16_t> result;
+	for (uint16_t s = first;; ++s) {
+		result.push_back(s);
+		if (s == last)
+			break;
+	}
+	return result;
+}
+
+void test_retries() {
+	RtcpNackRequester requester(1000ms);
+	requester.setRtt(100ms);
+	requester.setReorderDelay(10ms);
+	auto now = clock_type::now();
+
+	// Gaps are requested in a single NACK after the reorder delay
+	auto lost = range(10, 14);
+	lost.push_back(50);
+	auto lostRange = range(60, 79);
+	lost.insert(lost.end(), lostRange.begin(), lostRange.end());
+	if (!receive(requester, make_packets(0, 99, lost), now).empty())
+		throw runtime_error("Missing packets requested before the reorder delay");
+
+	const map<SSRC, vector<uint16_t>> expected = {{Ssrc, lost}};
+	if (receive(requester, make_packets(100, 100), now + 10ms) != expected ||
+	    requester.sentNacks() != 1 || requester.requestedPackets() != lost.size())
+		throw runtime_error("Missing packets not requested");
+
+	// Retries are spaced by the round-trip time
+	if (!receive(requester, make_packets(101, 101), now + 60ms).empty())
+		throw runtime_error("Missing packets requested again before the round-trip time");
+
+	if (receive(requester, make_packets(102, 102), now + 110ms)[Ssrc] != lost ||
+	    requester.requestedPackets() != lost.size())
+		throw runtime_error("Missing packets not requested again after the round-trip time");
+
+	// Retransmissions are counted as recovered
+	if (!receive(requester, make_packets(10, 14), now + 130ms).empty() ||
+	    requester.recoveredPackets() != 5)
+		throw runtime_error("Retransmitted packets not recovered");
+
+	// Missing packets are given up after the deadline
+	if (!receive(requester, make_packets(103, 103), now + 1000ms).empty() ||
+	    requester.abandonedPackets() != lost.size() - 5)
+		throw runtime_error("Missing packets not given up after the deadline");
+
+	// Requests from depacketizers are absorbed
+	size_t sent = 0;
+	if (!requester.requestRetransmission(Ssrc, {104}, [&sent](message_ptr) { ++sent; }) ||
+	    sent != 0)
+		throw runtime_error("Retransmission request not absorbed");
+}
+
+void test_reordering() {
+	// A packet reordered within the delay is not requested
+	RtcpNackRequester requester;
+	const auto now = clock_type::now();
+	receive(requester, make_packets(0, 10, {5}), now);
+	receive(requester, make_packets(5, 5), now + 5ms);
+	if (!receive(requester, make_packets(11, 11), now + 50ms).empty() ||
+	    requester.requestedPackets() != 0 || requester.recoveredPackets() != 0)
+		throw runtime_error("Reordered packet requested for retransmission");
+}
+
+void test_streams() {
+	RtcpNackRequester requester;
+	const auto now = clock_type::now();
+
+	// Each SSRC is tracked separately, including across the wrap-around
+	message_vector packets = make_packets(65530, 3, {65535, 0}, 1);
+	auto other = make_packets(100, 110, {105}, 2);
+	packets.insert(packets.end(), other.begin(), other.end());
+	const map<SSRC, vector<uint16_t>> expected = {{1, {65535, 0}}, {2, {105}}};
+	const auto delay = RtcpNackRequester::DefaultReorderDelay;
+	receive(requester, packets, now);
+	if (receive(requester, {}, now + delay) != expected || requester.sentNacks() != 2)
+		throw runtime_error("Unexpected requests for multiple streams");
+
+	// Large losses are split into multiple NACKs
+	auto lost = range(200, 799);
+	receive(requester, make_packets(111, 900, lost, 2), now + delay);
+	if (receive(requester, {}, now + 2 * delay)[2] != lost || requester.sentNacks() != 5)
+		throw runtime_error("Unexpected requests for a large loss");
+
+	// Missing packets falling out of the window are given up
+	receive(requester, make_packets(2000, 2000, {}, 2), now + 2 * delay);
+	if (requester.abandonedPackets() != 1 + lost.size())
+		throw runtime_error("Missing packets out of the window not given up");
+}
+
+void test_recovery() {
+	// Retransmissions from a responder recover all losses
+	RtcpNackResponder responder;
+	RtcpNackRequester requester;
+	auto now = clock_type::now();
+	const vector<uint16_t> lost = {3, 4, 17, 18, 19, 40};
+	for (uint16_t s = 0; s < 60; s += 10) {
+		auto packets = make_packets(s, uint16_t(s + 9));
+		responder.outgoing(packets, nullptr);
+
+		message_vector received;
+		for (auto &packet : packets)
+			if (find(lost.begin(), lost.end(), seq_number(packet)) == lost.end())
+				received.push_back(packet);
+
+		message_vector nacks;
+		requester.incoming(received, [&nacks](message_ptr nack) { nacks.push_back(nack); }, now);
+
+		message_vector retransmitted;
+		responder.incoming(nacks, [&](message_ptr packet) { retransmitted.push_back(packet); });
+		requester.incoming(retransmitted, [](message_ptr) {}, now);
+		now += 20ms;
+	}
+
+	if (requester.requestedPackets() != lost.size() ||
+	    requester.recoveredPackets() != lost.size() || requester.abandonedPackets() != 0)
+		throw runtime_error("Losses not recovered");
+}
+
+} // namespace
+
+void test_nackrequester() {
+	test_retries();
+	test_reordering();
+	test_streams();
+	test_recovery();
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtppackets.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using rtppackets::make_packet;
+using rtppackets::seq_number;
+using rtppackets::Ssrc;
+
+namespace {
+
+const SSRC RtxSsrc = 43;
+
+void store(RtcpNackResponder &responder, uint16_t first, size_t count, size_t payloadSize = 100) {
+	message_vector packets;
+	for (size_t i = 0; i < count; ++i)
+		packets.push_back(make_packet(uint16_t(first + i), 1000, false, Ssrc, payloadSize));
+
+	responder.outgoing(packets, nullptr);
+}
+
+// Send a NACK to the responder and return the retransmitted packets
+message_vector nack_packets(RtcpNackResponder &responder, const vector<uint16_t> &seqNumbers) {
+	RtcpReceivingSession session;
+	message_vector messages;
+	session.requestRetransmission(Ssrc, seqNumbers, [&messages](message_ptr message) {
+		message->type = Message::Control;
+		messages.push_back(std::move(message));
+	});
+
+	message_vector retransmitted;
+	responder.incoming(messages, [&retransmitted](message_ptr packet) {
+		retransmitted.push_back(std::move(packet));
+	});
+	return retransmitted;
+}
+
+// Same, but return the sequence numbers of retransmitted packets
+vector<uint16_t> nack(RtcpNackResponder &responder, const vector<uint16_t> &seqNumbers) {
+	vector<uint16_t> retransmitted;
+	for (const auto &packet : nack_packets(responder, seqNumbers))
+		retransmitted.push_back(seq_number(packet));
+
+	return retransmitted;
+}
+
+void test_wrap_around() {
+	RtcpNackResponder responder(64);
+	store(responder, 65500, 100); // 65500 to 63
+
+	if (responder.storedPackets() != 64 || responder.storedBytes() != 64 * make_packet(0)->size())
+		throw runtime_error("Unexpected storage size");
+
+	if (nack(responder, {65535, 0, 63, 64}) != vector<uint16_t>{0, 63})
+		throw runtime_error("Unexpected retransmission across the wrap-around");
+
+	// Packets older than the history or too far ahead are not returned
+	if (!nack(responder, {65500, 65535, 100, 32000}).empty())
+		throw runtime_error("Evicted packets retransmitted");
+
+	// Reordered outgoing packets within the history are kept
+	store(responder, 10, 1, 10);
+	if (nack(responder, {10}) != vector<uint16_t>{10} || responder.storedPackets() != 64)
+		throw runtime_error("Replaced packet not retransmitted");
+}
+
+void test_gaps() {
+	RtcpNackResponder responder(8);
+	store(responder, 100, 2);
+	store(responder, 105, 3); // 102 to 104 are never stored
+
+	if (responder.storedPackets() != 5)
+		throw runtime_error("Unexpected storage size with gaps");
+
+	// The window spans 8 sequence numbers, so 100 falls out of it
+	store(responder, 108, 1);
+	if (nack(responder, {100, 101, 102, 105, 108}) != vector<uint16_t>{101, 105, 108})
+		throw runtime_error("Unexpected retransmission with gaps");
+
+	// Missing packets are skipped when the oldest one is evicted
+	store(responder, 110, 1);
+	if (responder.storedPackets() != 5 || nack(responder, {101}).size() != 0)
+		throw runtime_error("Unexpected eviction with gaps");
+
+	// A jump over the whole ring evicts everything else
+	store(responder, 20000, 1);
+	if (responder.storedPackets() != 1 || nack(responder, {108, 20000}) != vector<uint16_t>{20000})
+		throw runtime_error("Storage not reset after a jump");
+}
+
+void test_byte_budget() {
+	const size_t packetSize = make_packet(0, 1000, false, Ssrc, 1000)->size();
+	RtcpNackResponder responder(512, 10 * packetSize);
+	store(responder, 0, 100, 1000);
+
+	if (responder.storedPackets() != 10 || responder.storedBytes() != 10 * packetSize)
+		throw runtime_error("Byte budget not enforced");
+
+	if (nack(responder, {89, 90, 99}) != vector<uint16_t>{90, 99})
+		throw runtime_error("Unexpected retransmission with byte budget");
+
+	// A single packet over the budget is still kept
+	store(responder, 100, 1, 20 * 1000);
+	if (responder.storedPackets() != 1 || nack(responder, {99, 100}) != vector<uint16_t>{100})
+		throw runtime_error("Large packet not kept");
+}
+
+void test_duration() {
+	RtcpNackResponder responder;
+	store(responder, 0, 1);
+	if (responder.storedDuration() != 0ms)
+		throw runtime_error("Unexpected duration of a single packet");
+
+	this_thread::sleep_for(50ms);
+	store(responder, 1, 1);
+	if (responder.storedDuration() < 50ms)
+		throw runtime_error("Unexpected storage duration");
+}
+
+void test_concurrent() {
+	// NACKs are handled while packets are stored
+	RtcpNackResponder responder(128);
+	const size_t count = 20000;
+	atomic<bool> done = false;
+	atomic<size_t> retransmitted = 0;
+	atomic<bool> mismatch = false;
+	thread reader([&]() {
+		uint16_t seqNumber = 0;
+		while (!done) {
+			vector<uint16_t> seqNumbers;
+			for (int i = 0; i < 16; ++i)
+				seqNumbers.push_back(seqNumber++);
+
+			for (auto s : nack(responder, seqNumbers)) {
+				if (find(seqNumbers.begin(), seqNumbers.end(), s) == seqNumbers.end())
+					mismatch = true;
+
+				++retransmitted;
+			}
+		}
+	});
+
+	for (size_t i = 0; i < count; ++i)
+		store(responder, uint16_t(i), 1);
+
+	done = true;
+	reader.join();
+
+	if (mismatch)
+		throw runtime_error("Wrong packet retransmitted");
+
+	if (responder.storedPackets() != 128)
+		throw runtime_error("Unexpected storage size after concurrent access");
+
+	cout << retransmitted << " packets retransmitted during concurrent storage" << endl;
+}
+
+void test_rtx() {
+	Description::Video media("video", Description::Direction::SendRecv);
+	media.addVP8Codec(96);
+	media.addRtxCodec(97, 96, 90000);
+	media.addSSRC(Ssrc, "cname");
+	media.addRtxSSRC(Ssrc, RtxSsrc);
+
+	// The RTX parameters must be found in the remote description
+	const Description::Media remote(media.generateSdp());
+	if (remote.rtxPayloadTypes() != map<int, int>{{97, 96}} ||
+	    remote.getRtxSSRCs() != map<uint32_t, uint32_t>{{RtxSsrc, Ssrc}} ||
+	    !remote.hasSSRC(RtxSsrc))
+		throw runtime_error("RTX parameters not negotiated");
+
+	RtcpNackResponder responder;
+	responder.enableRtx(RtxSsrc, media);
+	store(responder, 65534, 4);
+
+	auto packets = nack_packets(responder, {65535, 1});
+	if (packets.size() != 2)
+		throw runtime_error("RTX packets not sent");
+
+	for (const auto &packet : packets) {
+		auto rtp = reinterpret_cast<const RtpHeader *>(packet->data());
+		if (rtp->ssrc() != RtxSsrc || rtp->payloadType() != 97 ||
+		    packet->size() != make_packet(0)->size() + 2)
+			throw runtime_error("Unexpected RTX packet");
+	}
+	if (seq_number(packets[1]) != uint16_t(seq_number(packets[0]) + 1))
+		throw runtime_error("RTX sequence numbers not consecutive");
+
+	// The receiver restores the original packets
+	RtxUnwrapper unwrapper(remote);
+	auto padding = make_message(packets[0]->begin(), packets[0]->end());
+	padding->resize(sizeof(RtpHeader) + 4);
+	padding->back() = byte(4);
+	reinterpret_cast<RtpHeader *>(padding->data())->_first |= 0x20;
+	auto truncated = make_message(packets[0]->begin(), packets[0]->begin() + sizeof(RtpHeader));
+	reinterpret_cast<RtpHeader *>(truncated->data())->_first |= 0x1F; // extension and 15 CSRCs
+	auto original = make_packet(0);
+	message_vector messages = {packets[0], original, padding, truncated, packets[1]};
+	unwrapper.incoming(messages, nullptr);
+
+	if (messages.size() != 3 || *messages[0] != *make_packet(65535) ||
+	    messages[0]->stream != Ssrc || *messages[1] != *original ||
+	    *messages[2] != *make_packet(1))
+		throw runtime_error("RTX packets not restored");
+}
+
+void test_rate_limit() {
+	const size_t packetSize = make_packet(0, 1000, false, Ssrc, 1000)->size();
+	RtcpNackResponder responder;
+	responder.enableRtx(RtxSsrc, map<uint8_t, uint8_t>{{96, 97}});
+	responder.setMaxBitrate(80000); // 10 kB/s, so 2 kB for a burst
+	store(responder, 0, 20, 1000);
+
+	vector<uint16_t> seqNumbers;
+	for (uint16_t i = 0; i < 20; ++i)
+		seqNumbers.push_back(i);
+
+	// The budget may go in debt by one packet
+	auto packets = nack_packets(responder, seqNumbers);
+	if (packets.size() != 2000 / (packetSize + 2) + 1 || responder.retransmittedPackets() != 2 ||
+	    responder.droppedRetransmissions() != 18)
+		throw runtime_error("Retransmissions not limited");
+
+	// The budget is refilled at the maximum bitrate
+	this_thread::sleep_for(300ms);
+	auto refilled = nack_packets(responder, seqNumbers);
+	if (refilled.size() != 2)
+		throw runtime_error("Retransmission budget not refilled");
+
+	// Dropped retransmissions must not leave gaps in the RTX stream
+	packets.insert(packets.end(), refilled.begin(), refilled.end());
+	for (size_t i = 1; i < packets.size(); ++i)
+		if (seq_number(packets[i]) != uint16_t(seq_number(packets[i - 1]) + 1))
+			throw runtime_error("Gap in RTX sequence numbers with rate limiting");
+}
+
+} // namespace
+
+void test_nackresponder() {
+	test_wrap_around();
+	test_gaps();
+	test_byte_budget();
+	test_duration();
+	test_concurrent();
+	test_rtx();
+	test_rate_limit();
+
+	cout << "Success" << endl;
+}
+
+#endif
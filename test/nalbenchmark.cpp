@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "nalsamples.hpp"
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+using nalsamples::find_bytewise;
+using nalsamples::load_samples;
+using nalsamples::Separator;
+
+namespace {
+
+// Measures the scanning throughput of both implementations in MB/s over the samples
+void measure_scanning(const binary &stream) {
+	const size_t iterations = std::max(size_t(256 * 1024 * 1024) / stream.size(), size_t(4));
+
+	size_t bytewiseCount = 0;
+	auto start = steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		size_t offset = 0, length = 0;
+		while (offset < stream.size()) {
+			offset += find_bytewise(stream, offset, Separator::StartSequence, length) + length;
+			++bytewiseCount;
+		}
+	}
+	const double bytewiseSeconds = duration<double>(steady_clock::now() - start).count();
+
+	size_t count = 0;
+	start = steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		size_t offset = 0, length = 0;
+		while (offset < stream.size()) {
+			offset += NalUnit::FindStartSequence(stream.data() + offset, stream.size() - offset,
+			                                     Separator::StartSequence, length) +
+			          length;
+			++count;
+		}
+	}
+	const double seconds = duration<double>(steady_clock::now() - start).count();
+
+	if (count != bytewiseCount)
+		throw runtime_error("Different start sequence counts on samples");
+
+	const double megabytes = double(stream.size() * iterations) / 1e6;
+	cout << "Scanned " << stream.size() << " bytes of samples with " << count / iterations
+	     << " NAL units: byte-wise " << size_t(megabytes / bytewiseSeconds) << " MB/s, vectorized "
+	     << size_t(megabytes / seconds) << " MB/s" << endl;
+}
+
+} // namespace
+
+void benchmark_startsequence() {
+	binary stream;
+	load_samples(stream);
+	if (stream.empty()) {
+		cout << "Samples not found in " << RTC_SAMPLES_DIR << ", skipping" << endl;
+		return;
+	}
+
+	measure_scanning(stream);
+}
+
+#endif
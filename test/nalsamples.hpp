@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+// Sample NAL units and reference start sequence scanning shared by the start sequence test and
+// benchmark
+
+#ifndef RTC_TEST_NAL_SAMPLES_H
+#define RTC_TEST_NAL_SAMPLES_H
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifndef RTC_SAMPLES_DIR
+#define RTC_SAMPLES_DIR "examples/streamer/samples"
+#endif
+
+namespace nalsamples {
+
+using namespace rtc;
+using std::string;
+
+using Separator = NalUnit::Separator;
+
+// Reference implementation with the byte-wise state machine
+inline size_t find_bytewise(const binary &data, size_t offset, Separator separator,
+                            size_t &length) {
+	NalUnitStartSequenceMatch match = NUSM_noMatch;
+	for (size_t i = offset; i < data.size(); ++i) {
+		match = NalUnit::StartSequenceMatchSucc(match, data[i], separator);
+		if (match == NUSM_longMatch || match == NUSM_shortMatch) {
+			length = match == NUSM_longMatch ? 4 : 3;
+			return i + 1 - length - offset;
+		}
+	}
+	return data.size() - offset;
+}
+
+// Load the sample frames, which are stored with length prefixes, and convert them to Annex-B
+// If prefixed is set, the NAL units are also appended to it with their length prefixes
+inline void load_samples(binary &stream, binary *prefixed = nullptr) {
+	const byte startSequence[4] = {byte(0), byte(0), byte(0), byte(1)};
+	for (int i = 0;; ++i) {
+		std::ifstream file(string(RTC_SAMPLES_DIR) + "/h264/sample-" + std::to_string(i) + ".h264",
+		                   std::ios::binary);
+		if (!file)
+			break;
+
+		const string content(std::istreambuf_iterator<char>(file), {});
+		const auto data = reinterpret_cast<const byte *>(content.data());
+		const binary frame(data, data + content.size());
+		size_t index = 0;
+		while (index + 4 <= frame.size()) {
+			uint32_t length = 0;
+			for (size_t j = 0; j < 4; ++j)
+				length = length << 8 | uint32_t(frame[index + j]);
+
+			index += 4;
+			if (index + length > frame.size())
+				break;
+
+			stream.insert(stream.end(), startSequence, startSequence + 4);
+			stream.insert(stream.end(), frame.begin() + index, frame.begin() + index + length);
+			if (prefixed)
+				prefixed->insert(prefixed->end(), frame.begin() + index - 4,
+				                 frame.begin() + index + length);
+
+			index += length;
+		}
+	}
+}
+
+} // namespace nalsamples
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_TEST_NAL_SAMPLES_H */
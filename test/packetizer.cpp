@@ -0,0 +1,363 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "copyingpacketizer.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <iostream>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+using namespace copying;
+
+namespace {
+
+// Packetize the frames and return the RTP payloads
+vector<binary> packetize_all(MediaHandler &packetizer, const vector<binary> &frames) {
+	vector<binary> payloads;
+	for (const auto &frame : frames) {
+		message_vector messages = {make_message(frame.begin(), frame.end())};
+		packetizer.outgoing(messages, nullptr);
+		for (const auto &message : messages)
+			payloads.emplace_back(message->begin() + sizeof(RtpHeader), message->end());
+	}
+	return payloads;
+}
+
+void check_equivalence(const string &name, MediaHandler &copying, MediaHandler &packetizer,
+                       const vector<binary> &frames) {
+	if (packetize_all(packetizer, frames) != packetize_all(copying, frames))
+		throw runtime_error(name + " payloads differ from copying packetization");
+}
+
+// Convert length-prefixed frames to Annex-B, optionally rewriting NAL unit headers for H.265
+vector<binary> to_annexb(const vector<binary> &frames, bool h265) {
+	vector<binary> result;
+	for (const auto &frame : frames) {
+		binary out;
+		size_t index = 0;
+		while (index + 4 < frame.size()) {
+			size_t length = 0;
+			for (size_t i = 0; i < 4; ++i)
+				length = length << 8 | size_t(frame[index + i]);
+
+			index += 4;
+			out.insert(out.end(), {byte(0), byte(0), byte(0), byte(1)});
+			const size_t begin = out.size();
+			out.insert(out.end(), frame.begin() + index, frame.begin() + index + length);
+			if (h265 && length >= 2) {
+				out[begin] = byte(1 << 1); // TRAIL_R
+				out[begin + 1] = byte(1);  // TID 0
+			}
+			index += length;
+		}
+		result.push_back(std::move(out));
+	}
+	return result;
+}
+
+// Packetize Annex-B frames with the given packetizer and depacketize them back
+template <typename Depacketizer>
+size_t round_trip(const string &name, RtpPacketizer &packetizer, const vector<binary> &frames) {
+	Depacketizer depacketizer(NalUnit::Separator::LongStartSequence);
+	message_vector packets;
+	for (size_t i = 0; i < frames.size(); ++i) {
+		packetizer.rtpConfig->timestamp = uint32_t(1 + i * 3000);
+		message_vector messages = {make_message(frames[i].begin(), frames[i].end())};
+		packetizer.outgoing(messages, nullptr);
+		for (const auto &message : messages) {
+			if (message->size() > sizeof(RtpHeader) + MaxFragmentSize)
+				throw runtime_error(name + " packet is larger than the max fragment size");
+
+			packets.push_back(message);
+		}
+	}
+
+	const size_t count = packets.size();
+	depacketizer.incoming(packets, nullptr);
+	if (packets.size() != frames.size())
+		throw runtime_error(name + " depacketization gives " + to_string(packets.size()) +
+		                    " frames instead of " + to_string(frames.size()));
+
+	for (size_t i = 0; i < frames.size(); ++i)
+		if (binary(packets[i]->begin(), packets[i]->end()) != frames[i])
+			throw runtime_error(name + " frame " + to_string(i) + " differs after round trip");
+
+	return count;
+}
+
+template <typename Packetizer, typename Depacketizer>
+void test_aggregation(const string &name, const vector<binary> &frames) {
+	auto makeConfig = []() {
+		return make_shared<RtpPacketizationConfig>(1, "video", 96, RtpPacketizer::VideoClockRate);
+	};
+
+	Packetizer single(NalUnit::Separator::LongStartSequence, makeConfig(), MaxFragmentSize);
+	Packetizer aggregating(NalUnit::Separator::LongStartSequence, makeConfig(), MaxFragmentSize,
+	                       true);
+	const size_t singleCount = round_trip<Depacketizer>(name, single, frames);
+	const size_t aggregatedCount = round_trip<Depacketizer>(name, aggregating, frames);
+	if (aggregatedCount >= singleCount)
+		throw runtime_error(name + " aggregation does not reduce the packet count");
+
+	cout << name << " aggregation: " << aggregatedCount << " packets instead of " << singleCount
+	     << endl;
+}
+
+// Packetize AV1 temporal units and depacketize them back
+void test_av1_round_trip(const vector<binary> &frames) {
+	auto rtpConfig =
+	    make_shared<RtpPacketizationConfig>(1, "video", 96, RtpPacketizer::VideoClockRate);
+	AV1RtpPacketizer packetizer(AV1RtpPacketizer::Packetization::TemporalUnit, rtpConfig,
+	                            MaxFragmentSize);
+	message_vector packets;
+	for (size_t i = 0; i < frames.size(); ++i) {
+		rtpConfig->timestamp = uint32_t(1 + i * 3000);
+		message_vector messages = {make_message(frames[i].begin(), frames[i].end())};
+		packetizer.outgoing(messages, nullptr);
+		packets.insert(packets.end(), messages.begin(), messages.end());
+	}
+
+	// OBUs without size field are also accepted, aggregated and fragmented
+	const binary obus[2] = {{byte(0x30), byte(0x01), byte(0x02)},  // frame
+	                        {byte(0x20), byte(0x03), byte(0x04)}}; // tile group
+	const binary payloads[2] = {{byte(0x60), byte(3), obus[0][0], obus[0][1], obus[0][2],
+	                             obus[1][0], obus[1][1]},   // W = 2, Y
+	                            {byte(0x90), obus[1][2]}}; // W = 1, Z
+	for (size_t i = 0; i < 2; ++i) {
+		auto packet = make_message(sizeof(RtpHeader) + payloads[i].size());
+		auto rtp = reinterpret_cast<RtpHeader *>(packet->data());
+		rtp->preparePacket();
+		rtp->setSsrc(rtpConfig->ssrc);
+		rtp->setSeqNumber(uint16_t(rtpConfig->sequenceNumber + i));
+		rtp->setTimestamp(uint32_t(1 + frames.size() * 3000));
+		rtp->setMarker(i == 1);
+		std::copy(payloads[i].begin(), payloads[i].end(), packet->begin() + sizeof(RtpHeader));
+		packets.push_back(packet);
+	}
+	const binary expected = {byte(0x12), byte(0x00),                         // delimiter
+	                         byte(0x32), byte(2),    obus[0][1], obus[0][2], // with size
+	                         byte(0x22), byte(2),    obus[1][1], obus[1][2]};
+
+	AV1RtpDepacketizer depacketizer;
+	depacketizer.incoming(packets, nullptr);
+	if (packets.size() != frames.size() + 1)
+		throw runtime_error("AV1 depacketization gives " + to_string(packets.size()) +
+		                    " temporal units instead of " + to_string(frames.size() + 1));
+
+	for (size_t i = 0; i < frames.size(); ++i)
+		if (binary(packets[i]->begin(), packets[i]->end()) != frames[i])
+			throw runtime_error("AV1 temporal unit " + to_string(i) + " differs after round trip");
+
+	if (binary(packets.back()->begin(), packets.back()->end()) != expected)
+		throw runtime_error("AV1 OBUs without size field not depacketized correctly");
+
+	cout << "AV1 round trip: " << frames.size() << " temporal units" << endl;
+}
+
+// A temporal unit starting a coded video sequence is output without waiting for missing packets
+// of the previous one, and flagged as a sequence start
+void test_av1_sequence_start() {
+	const binary obu = {byte(0x32), byte(0x00)}; // frame with size
+	auto make_packet = [&obu](uint16_t seqNumber, uint32_t timestamp, bool marker, bool start) {
+		auto packet = make_message(sizeof(RtpHeader) + 1 + obu.size());
+		auto rtp = reinterpret_cast<RtpHeader *>(packet->data());
+		rtp->preparePacket();
+		rtp->setSsrc(1);
+		rtp->setSeqNumber(seqNumber);
+		rtp->setTimestamp(timestamp);
+		rtp->setMarker(marker);
+		packet->at(sizeof(RtpHeader)) = byte(start ? 0x18 : 0x10); // W = 1, and N
+		std::copy(obu.begin(), obu.end(), packet->begin() + sizeof(RtpHeader) + 1);
+		return packet;
+	};
+
+	// The second packet of the second temporal unit is lost
+	message_vector packets = {make_packet(10, 1000, true, false),
+	                          make_packet(11, 4000, false, false),
+	                          make_packet(13, 7000, true, true)};
+
+	AV1RtpDepacketizer depacketizer;
+	depacketizer.incoming(packets, nullptr);
+	if (packets.size() != 2 || packets[0]->frameInfo->timestamp != 1000 ||
+	    packets[1]->frameInfo->timestamp != 7000)
+		throw runtime_error("AV1 sequence start not output without waiting");
+
+	if (packets[0]->frameInfo->sequenceStart || !packets[1]->frameInfo->sequenceStart)
+		throw runtime_error("AV1 sequence start not flagged");
+
+	// The missing packet is late now
+	packets = {make_packet(12, 4000, true, false)};
+	depacketizer.incoming(packets, nullptr);
+	if (!packets.empty())
+		throw runtime_error("AV1 temporal unit of the previous sequence output");
+}
+
+// Return the value of a header extension element in a packet, or nullopt if it is absent
+optional<binary> find_extension(const message_ptr &packet, uint8_t id) {
+	size_t length = 0;
+	auto rtp = reinterpret_cast<const RtpHeader *>(packet->data());
+	if (auto data = RtpExtensionMap::Find(rtp, packet->size(), id, length))
+		return binary(data, data + length);
+
+	return nullopt;
+}
+
+uint64_t read_big_endian(const binary &value) {
+	uint64_t result = 0;
+	for (auto b : value)
+		result = result << 8 | to_integer<uint8_t>(b);
+
+	return result;
+}
+
+void test_header_extensions() {
+	using Extension = RtpExtensionMap::Extension;
+	auto rtpConfig =
+	    make_shared<RtpPacketizationConfig>(1, "video", 96, RtpPacketizer::VideoClockRate);
+	rtpConfig->videoOrientationId = 1;
+	rtpConfig->videoOrientation = 1;
+	rtpConfig->midId = 2;
+	rtpConfig->mid = "video";
+	rtpConfig->playoutDelayId = 3;
+	rtpConfig->playoutDelayMin = 10;
+	rtpConfig->playoutDelayMax = 20;
+	H264RtpPacketizer packetizer(NalUnit::Separator::StartSequence, rtpConfig, 100);
+
+	// Negotiated extensions are registered only if requested, unless their ID is already taken
+	Description::Video media;
+	media.addExtMap(Description::Entry::ExtMap(2, RtpExtensionMap::Uri(Extension::AbsSendTime)));
+	media.addExtMap(
+	    Description::Entry::ExtMap(5, RtpExtensionMap::Uri(Extension::TransportSequenceNumber)));
+	media.addExtMap(Description::Entry::ExtMap(6, "urn:example:unknown"));
+	packetizer.media(media);
+	if (rtpConfig->transportSequenceNumberId != 0)
+		throw runtime_error("Negotiated header extensions registered without being requested");
+
+	rtpConfig->registerNegotiatedExtensions = true;
+	packetizer.media(media);
+	if (rtpConfig->absSendTimeId != 0 || rtpConfig->transportSequenceNumberId != 5)
+		throw runtime_error("Negotiated header extensions not registered correctly");
+
+	rtpConfig->absSendTimeId = 7;
+	rtpConfig->absCaptureTimeId = 8;
+
+	// A NAL unit fragmented over multiple packets
+	binary frame = {byte(0), byte(0), byte(0), byte(1), byte(0x65)};
+	frame.resize(frame.size() + 300, byte(0x42));
+	const auto captureTime = chrono::system_clock::time_point(chrono::seconds(1));
+	auto packetize = [&](bool withCaptureTime = true) {
+		auto message = make_message(frame.begin(), frame.end());
+		if (withCaptureTime) {
+			message->frameInfo = make_shared<FrameInfo>(uint32_t(1000));
+			message->frameInfo->captureTime = captureTime;
+		}
+		message_vector messages = {std::move(message)};
+		packetizer.outgoing(messages, nullptr);
+		if (messages.size() < 2)
+			throw runtime_error("NAL unit not fragmented with header extensions");
+
+		return messages;
+	};
+
+	auto packets = packetize();
+	const binary playoutDelay = {byte(0x00), byte(0xA0), byte(0x14)};
+	for (size_t i = 0; i < packets.size(); ++i) {
+		const bool last = i + 1 == packets.size();
+		auto rtp = reinterpret_cast<const RtpHeader *>(packets[i]->data());
+		if (rtp->getExtensionHeader()->profileSpecificId() != 0xBEDE)
+			throw runtime_error("One-byte header extensions are not used");
+
+		if (find_extension(packets[i], 1) != (last ? optional(binary{byte(1)}) : nullopt) ||
+		    find_extension(packets[i], 2) != binary{byte('v'), byte('i'), byte('d'), byte('e'),
+		                                            byte('o')} ||
+		    find_extension(packets[i], 3) != playoutDelay)
+			throw runtime_error("Unexpected static header extensions");
+
+		// The transport-wide sequence number is only reserved, the transport writes it
+		auto sequenceNumber = find_extension(packets[i], 5);
+		auto sendTime = find_extension(packets[i], 7);
+		auto captureValue = find_extension(packets[i], 8);
+		if (!sequenceNumber || sequenceNumber->size() != 2 || !sendTime ||
+		    sendTime->size() != 3 || !captureValue ||
+		    read_big_endian(*captureValue) != (uint64_t(2208988801) << 32))
+			throw runtime_error("Unexpected dynamic header extensions");
+	}
+
+	// abs-capture-time is only written for frames with a capture time
+	packets = packetize(false);
+	if (find_extension(packets[0], 8) || !find_extension(packets[0], 7))
+		throw runtime_error("abs-capture-time written without a capture time");
+
+	// The header template is rebuilt when the configuration changes, and a two-byte header is
+	// used for an element larger than 16 bytes
+	rtpConfig->ridId = 4;
+	rtpConfig->rid = "a-rid-longer-than-16-bytes";
+	packets = packetize();
+	auto rtp = reinterpret_cast<const RtpHeader *>(packets[0]->data());
+	const string rid(rtpConfig->rid->begin(), rtpConfig->rid->end());
+	auto ridValue = find_extension(packets[0], 4);
+	if (rtp->getExtensionHeader()->profileSpecificId() != 0x1000 || !ridValue ||
+	    string(reinterpret_cast<const char *>(ridValue->data()), ridValue->size()) != rid ||
+	    find_extension(packets[0], 3) != playoutDelay)
+		throw runtime_error("Two-byte header extensions not written correctly");
+
+	H264RtpDepacketizer depacketizer;
+	depacketizer.incoming(packets, nullptr);
+	if (packets.size() != 1 || binary(packets[0]->begin(), packets[0]->end()) != frame)
+		throw runtime_error("Payload differs with two-byte header extensions");
+
+	cout << "Header extensions: OK" << endl;
+}
+
+} // namespace
+
+void test_packetizer() {
+	test_header_extensions();
+	test_av1_sequence_start();
+
+	auto frames = load_samples();
+	if (frames.empty()) {
+		cout << "Samples not found in " << RTC_SAMPLES_DIR << ", skipping sample checks" << endl;
+		cout << "Success" << endl;
+		return;
+	}
+
+	auto makeConfig = []() {
+		return make_shared<RtpPacketizationConfig>(1, "video", 96, RtpPacketizer::VideoClockRate);
+	};
+
+	{
+		CopyingNalPacketizer copying(false, makeConfig());
+		H264RtpPacketizer packetizer(NalUnit::Separator::Length, makeConfig(), MaxFragmentSize);
+		check_equivalence("H.264", copying, packetizer, frames);
+	}
+	{
+		// The H.264 samples are reused, only the NAL unit headers are interpreted
+		CopyingNalPacketizer copying(true, makeConfig());
+		H265RtpPacketizer packetizer(NalUnit::Separator::Length, makeConfig(), MaxFragmentSize);
+		check_equivalence("H.265", copying, packetizer, frames);
+	}
+	{
+		auto av1Frames = make_av1_frames(frames);
+		CopyingAV1Packetizer copying(makeConfig());
+		AV1RtpPacketizer packetizer(AV1RtpPacketizer::Packetization::TemporalUnit, makeConfig(),
+		                            MaxFragmentSize);
+		check_equivalence("AV1", copying, packetizer, av1Frames);
+		test_av1_round_trip(av1Frames);
+	}
+
+	test_aggregation<H264RtpPacketizer, H264RtpDepacketizer>("H.264", to_annexb(frames, false));
+	test_aggregation<H265RtpPacketizer, H265RtpDepacketizer>("H.265", to_annexb(frames, true));
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+// UDP relay between two peers, shared by the handshake test and the fast-open benchmark
+
+#ifndef RTC_TEST_RELAY_H
+#define RTC_TEST_RELAY_H
+
+#include "rtc/rtc.hpp"
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace relay {
+
+using namespace rtc;
+using namespace std::chrono_literals;
+using std::atomic;
+using std::deque;
+using std::lock_guard;
+using std::mutex;
+using std::optional;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::chrono::steady_clock;
+
+// UDP relay on loopback between the two peers
+// In lock-step mode, datagrams are held until both peers are quiet, then all of them are
+// delivered at once, so each delivery is one flight in each direction at most, whatever the
+// processing times are. Deliveries containing DTLS records are counted until frozen.
+// Otherwise, datagrams are forwarded after the given one-way delay.
+class Relay {
+public:
+	Relay(bool lockStep, std::chrono::milliseconds delay = 0ms)
+	    : mLockStep(lockStep), mDelay(delay), mSockets{open_socket(), open_socket()} {}
+
+	~Relay() {
+		mStopped = true;
+		if (mThread.joinable())
+			mThread.join();
+
+		for (int sock : mSockets)
+			::close(sock);
+	}
+
+	// Port to give to peer i in place of the other peer
+	uint16_t relayPort(int i) const { return local_port(mSockets[i]); }
+
+	void start(uint16_t port0, uint16_t port1) {
+		mPorts[0] = port0;
+		mPorts[1] = port1;
+		mThread = std::thread(&Relay::run, this);
+	}
+
+	// Stop counting, the relay keeps running so peers can close
+	void freeze() { mFrozen = true; }
+
+	int rounds() const { return mRounds; }
+
+private:
+	static constexpr auto QuietPeriod = 100ms;
+
+	static int open_socket() {
+		int sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+		if (sock < 0)
+			throw runtime_error("Failed to create UDP socket");
+
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		if (::bind(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+			::close(sock);
+			throw runtime_error("Failed to bind UDP socket");
+		}
+		return sock;
+	}
+
+	static uint16_t local_port(int sock) {
+		sockaddr_in addr = {};
+		socklen_t len = sizeof(addr);
+		::getsockname(sock, reinterpret_cast<sockaddr *>(&addr), &len);
+		return ntohs(addr.sin_port);
+	}
+
+	// Demultiplex as in RFC 7983: DTLS records start with a byte in [20, 63]
+	static bool is_dtls(const string &datagram) {
+		uint8_t first = uint8_t(datagram[0]);
+		return first >= 20 && first <= 63;
+	}
+
+	void forward(int to, const string &datagram) {
+		// Send to the other peer from the socket it knows
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(mPorts[to]);
+		::sendto(mSockets[to], datagram.data(), datagram.size(), 0,
+		         reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+	}
+
+	void run() {
+		pollfd pfds[2] = {{mSockets[0], POLLIN, 0}, {mSockets[1], POLLIN, 0}};
+		char buffer[2048];
+		deque<std::tuple<steady_clock::time_point, int, string>> pending;
+		auto last = steady_clock::now();
+		while (!mStopped) {
+			if (::poll(pfds, 2, mLockStep ? 10 : 1) > 0) {
+				for (int i = 0; i < 2; ++i) {
+					if (!(pfds[i].revents & POLLIN))
+						continue;
+
+					auto len = ::recv(mSockets[i], buffer, sizeof(buffer), 0);
+					if (len <= 0)
+						continue;
+
+					last = steady_clock::now();
+					pending.emplace_back(last + mDelay, 1 - i, string(buffer, size_t(len)));
+				}
+			}
+
+			const auto now = steady_clock::now();
+			if (pending.empty() || (mLockStep && now - last < QuietPeriod))
+				continue;
+
+			bool dtls = false;
+			while (!pending.empty() && (mLockStep || std::get<0>(pending.front()) <= now)) {
+				const auto &[time, to, datagram] = pending.front();
+				dtls |= is_dtls(datagram);
+				forward(to, datagram);
+				pending.pop_front();
+			}
+
+			if (mLockStep && dtls && !mFrozen)
+				++mRounds;
+		}
+	}
+
+	const bool mLockStep;
+	const std::chrono::milliseconds mDelay;
+	int mSockets[2];
+	uint16_t mPorts[2] = {0, 0};
+	std::thread mThread;
+	atomic<bool> mStopped = false;
+	atomic<bool> mFrozen = false;
+	atomic<int> mRounds = 0;
+};
+
+struct Result {
+	int rounds;     // lock-step deliveries with DTLS records until the first message
+	double seconds; // time from the remote description to the first message
+};
+
+// Connect two peers through the relay with the given configuration, and send a first message
+// on a DataChannel, either opened in-band or negotiated
+inline Result connect(const Configuration &config, bool negotiated, Relay &relay) {
+	PeerConnection pc1(config);
+	PeerConnection pc2(config);
+
+	// Only one host candidate per peer is signaled, pointing to the relay
+	atomic<int> port1 = 0, port2 = 0;
+	auto rewrite = [&relay](atomic<int> &port, int i, Candidate &candidate) {
+		if (candidate.type() != Candidate::Type::Host ||
+		    candidate.transportType() != Candidate::TransportType::Udp ||
+		    candidate.family() != Candidate::Family::Ipv4 || !candidate.port() || port != 0)
+			return false;
+
+		port = *candidate.port();
+		candidate.changeAddress("127.0.0.1", relay.relayPort(1 - i));
+		return true;
+	};
+
+	// The answer and its candidate are held so that the relay starts first
+	mutex answerMutex;
+	optional<Description> answer;
+	optional<Candidate> answerCandidate;
+	pc1.onLocalDescription([&pc2](Description sdp) { pc2.setRemoteDescription(string(sdp)); });
+	pc1.onLocalCandidate([&](Candidate candidate) {
+		if (rewrite(port1, 0, candidate))
+			pc2.addRemoteCandidate(std::move(candidate));
+	});
+	pc2.onLocalDescription([&](Description sdp) {
+		lock_guard lock(answerMutex);
+		answer.emplace(std::move(sdp));
+	});
+	pc2.onLocalCandidate([&](Candidate candidate) {
+		if (rewrite(port2, 1, candidate)) {
+			lock_guard lock(answerMutex);
+			answerCandidate.emplace(std::move(candidate));
+		}
+	});
+
+	atomic<bool> received = false;
+	auto onMessage = [&received, &relay](std::variant<binary, string> message) {
+		if (std::holds_alternative<string>(message)) {
+			relay.freeze();
+			received = true;
+		}
+	};
+
+	DataChannelInit init;
+	shared_ptr<DataChannel> dc2;
+	if (negotiated) {
+		// The remote channel is created upfront so it is open when the first message arrives
+		init.negotiated = true;
+		init.id = 1;
+		dc2 = pc2.createDataChannel("relay", init);
+		dc2->onMessage(onMessage);
+	} else {
+		pc2.onDataChannel([&dc2, onMessage](shared_ptr<DataChannel> dc) {
+			dc->onMessage(onMessage);
+			std::atomic_store(&dc2, dc);
+		});
+	}
+
+	auto dc1 = pc1.createDataChannel("relay", init);
+	dc1->onOpen([wdc1 = std::weak_ptr<DataChannel>(dc1)]() {
+		if (auto dc1 = wdc1.lock())
+			dc1->send("first");
+	});
+
+	auto ready = [&]() {
+		lock_guard lock(answerMutex);
+		return port1 != 0 && answer && answerCandidate;
+	};
+
+	int attempts = 50;
+	while (!ready() && attempts--)
+		std::this_thread::sleep_for(100ms);
+
+	if (!ready())
+		throw runtime_error("No host candidate gathered");
+
+	relay.start(uint16_t(port1.load()), uint16_t(port2.load()));
+
+	const auto start = steady_clock::now();
+	{
+		lock_guard lock(answerMutex);
+		pc1.setRemoteDescription(std::move(*answer));
+		pc1.addRemoteCandidate(std::move(*answerCandidate));
+	}
+
+	attempts = 10000;
+	while (!received && attempts--)
+		std::this_thread::sleep_for(1ms);
+
+	const double seconds =
+	    std::chrono::duration<double>(steady_clock::now() - start).count();
+
+	pc1.close();
+	pc2.close();
+
+	if (!received)
+		throw runtime_error("First DataChannel message not received");
+
+	return {relay.rounds(), seconds};
+}
+
+} // namespace relay
+
+#endif /* _WIN32 */
+
+#endif /* RTC_TEST_RELAY_H */
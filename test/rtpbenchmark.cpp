@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "copyingpacketizer.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+using namespace copying;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+namespace {
+
+// Measures the packetization throughput in MB/s of frame data
+double measure_throughput(MediaHandler &packetizer, const vector<binary> &frames) {
+	size_t total = 0;
+	for (const auto &frame : frames)
+		total += frame.size();
+
+	const size_t iterations = std::max(size_t(256 * 1024 * 1024) / total, size_t(2));
+	size_t count = 0;
+	const auto start = steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		for (const auto &frame : frames) {
+			message_vector messages = {make_message(frame.begin(), frame.end())};
+			packetizer.outgoing(messages, nullptr);
+			count += messages.size();
+		}
+	}
+	const double seconds = duration<double>(steady_clock::now() - start).count();
+
+	if (count == 0)
+		throw runtime_error("No packets generated");
+
+	return double(total * iterations) / seconds / 1e6;
+}
+
+void compare(const string &name, MediaHandler &copying, MediaHandler &packetizer,
+             const vector<binary> &frames) {
+	const double copyingThroughput = measure_throughput(copying, frames);
+	const double throughput = measure_throughput(packetizer, frames);
+	cout << name << " packetization: copying " << size_t(copyingThroughput) << " MB/s, views "
+	     << size_t(throughput) << " MB/s" << endl;
+}
+
+} // namespace
+
+void benchmark_packetizer() {
+	auto frames = load_samples();
+	if (frames.empty()) {
+		cout << "Samples not found in " << RTC_SAMPLES_DIR << ", skipping" << endl;
+		return;
+	}
+
+	auto makeConfig = []() {
+		return make_shared<RtpPacketizationConfig>(1, "video", 96, RtpPacketizer::VideoClockRate);
+	};
+
+	{
+		CopyingNalPacketizer copying(false, makeConfig());
+		H264RtpPacketizer packetizer(NalUnit::Separator::Length, makeConfig(), MaxFragmentSize);
+		compare("H.264", copying, packetizer, frames);
+	}
+	{
+		// The H.264 samples are reused, only the NAL unit headers are interpreted
+		CopyingNalPacketizer copying(true, makeConfig());
+		H265RtpPacketizer packetizer(NalUnit::Separator::Length, makeConfig(), MaxFragmentSize);
+		compare("H.265", copying, packetizer, frames);
+	}
+	{
+		CopyingAV1Packetizer copying(makeConfig());
+		AV1RtpPacketizer packetizer(AV1RtpPacketizer::Packetization::TemporalUnit, makeConfig(),
+		                            MaxFragmentSize);
+		compare("AV1", copying, packetizer, make_av1_frames(frames));
+	}
+}
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+// RTP packets shared by the jitter buffer and NACK tests
+
+#ifndef RTC_TEST_RTP_PACKETS_H
+#define RTC_TEST_RTP_PACKETS_H
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+namespace rtppackets {
+
+using namespace rtc;
+
+const SSRC Ssrc = 42;
+const uint8_t PayloadType = 96;
+
+// RTP packet with a payload depending only on its size
+inline message_ptr make_packet(uint16_t seqNumber, uint32_t timestamp = 1000, bool marker = false,
+                               SSRC ssrc = Ssrc, size_t payloadSize = 100) {
+	auto packet = make_message(sizeof(RtpHeader) + payloadSize);
+	auto rtp = reinterpret_cast<RtpHeader *>(packet->data());
+	rtp->preparePacket();
+	rtp->setSsrc(ssrc);
+	rtp->setPayloadType(PayloadType);
+	rtp->setSeqNumber(seqNumber);
+	rtp->setTimestamp(timestamp);
+	rtp->setMarker(marker);
+	for (size_t i = sizeof(RtpHeader); i < packet->size(); ++i)
+		packet->at(i) = byte(i & 0xFF);
+
+	return packet;
+}
+
+inline uint16_t seq_number(const message_ptr &packet) {
+	return reinterpret_cast<const RtpHeader *>(packet->data())->seqNumber();
+}
+
+} // namespace rtppackets
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_TEST_RTP_PACKETS_H */
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+void send_rtp(Track &track, SSRC ssrc, uint16_t seqNumber) {
+	binary packet(sizeof(RtpHeader) + 100);
+	auto rtp = reinterpret_cast<RtpHeader *>(packet.data());
+	rtp->preparePacket();
+	rtp->setSsrc(ssrc);
+	rtp->setPayloadType(96);
+	rtp->setSeqNumber(seqNumber);
+	rtp->setTimestamp(1000);
+	track.send(std::move(packet));
+}
+
+} // namespace
+
+void test_srtpstreams() {
+	InitLogger(LogLevel::Warning);
+
+	Configuration config1;
+	config1.srtpReplayWindowSize = 4096;
+	PeerConnection pc1(config1);
+
+	Configuration config2;
+	config2.srtpMaxInboundStreams = 2;
+	config2.srtpStreamTimeout = 1s;
+	PeerConnection pc2(config2);
+
+	pc1.onLocalDescription([&pc2](Description sdp) { pc2.setRemoteDescription(string(sdp)); });
+	pc1.onLocalCandidate(
+	    [&pc2](Candidate candidate) { pc2.addRemoteCandidate(string(candidate)); });
+	pc2.onLocalDescription([&pc1](Description sdp) { pc1.setRemoteDescription(string(sdp)); });
+	pc2.onLocalCandidate(
+	    [&pc1](Candidate candidate) { pc1.addRemoteCandidate(string(candidate)); });
+
+	shared_ptr<Track> t2;
+	pc2.onTrack([&t2](shared_ptr<Track> t) { std::atomic_store(&t2, t); });
+
+	Description::Video media("video", Description::Direction::SendOnly);
+	media.addVP8Codec(96);
+	media.addSSRC(1, "video-send");
+	auto t1 = pc1.addTrack(media);
+	pc1.setLocalDescription();
+
+	int attempts = 10;
+	shared_ptr<Track> at2;
+	while ((!(at2 = std::atomic_load(&t2)) || !at2->isOpen() || !t1->isOpen()) && attempts--)
+		this_thread::sleep_for(1s);
+
+	if (!at2 || !at2->isOpen() || !t1->isOpen())
+		throw runtime_error("Track is not open");
+
+	// Inbound streams are bounded
+	send_rtp(*t1, 1, 0);
+	send_rtp(*t1, 2, 0);
+	this_thread::sleep_for(200ms);
+	if (pc2.srtpStreamsCount() != 2)
+		throw runtime_error("Unexpected inbound SRTP streams count");
+
+	// Memory usage is accounted per stream
+	const size_t inboundMemory = pc2.srtpMemoryUsage();
+	if (inboundMemory == 0 || inboundMemory % 2 != 0)
+		throw runtime_error("Unexpected inbound SRTP memory usage");
+
+	// Packets from a new SSRC are dropped instead of evicting an active stream
+	send_rtp(*t1, 3, 0);
+	send_rtp(*t1, 1, 1);
+	this_thread::sleep_for(200ms);
+	if (pc2.srtpStreamsCount() != 2)
+		throw runtime_error("Active SRTP stream evicted for a new SSRC");
+
+	// Outbound streams are counted but never evicted
+	if (pc1.srtpStreamsCount() != 3)
+		throw runtime_error("Unexpected outbound SRTP streams count");
+
+	// A larger replay window takes more memory per stream
+	if (pc1.srtpMemoryUsage() / 3 <= inboundMemory / 2)
+		throw runtime_error("SRTP memory usage does not account for the replay window");
+
+	// Once idle streams time out, the new SSRC is accepted
+	this_thread::sleep_for(1200ms);
+	send_rtp(*t1, 3, 1);
+	this_thread::sleep_for(200ms);
+	if (pc2.srtpStreamsCount() != 1)
+		throw runtime_error("Idle SRTP streams not evicted after the timeout");
+
+	// Memory of evicted streams is not accounted anymore
+	if (pc2.srtpMemoryUsage() != inboundMemory / 2)
+		throw runtime_error("SRTP memory usage not updated after eviction");
+
+	pc1.close();
+	pc2.close();
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "nalsamples.hpp"
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+using nalsamples::find_bytewise;
+using nalsamples::load_samples;
+using nalsamples::Separator;
+
+namespace {
+
+void test_equivalence() {
+	mt19937 generator(42);
+	uniform_int_distribution<int> value(0, 255);
+	uniform_int_distribution<int> kind(0, 9);
+	uniform_int_distribution<size_t> sizeDistribution(0, 300);
+
+	for (size_t iteration = 0; iteration < 20000; ++iteration) {
+		// Random data with many zero runs and start sequences
+		binary data(sizeDistribution(generator));
+		for (auto &b : data) {
+			int k = kind(generator);
+			b = byte(k < 5 ? 0 : k < 7 ? 1 : value(generator));
+		}
+
+		for (auto separator : {Separator::StartSequence, Separator::LongStartSequence,
+		                       Separator::ShortStartSequence}) {
+			uniform_int_distribution<size_t> offsetDistribution(0, data.size());
+			const size_t offset = offsetDistribution(generator);
+			size_t expectedLength = 0, length = 0;
+			size_t expected = find_bytewise(data, offset, separator, expectedLength);
+			size_t found = NalUnit::FindStartSequence(data.data() + offset, data.size() - offset,
+			                                          separator, length);
+			if (found != expected || (found < data.size() - offset && length != expectedLength))
+				throw runtime_error("Start sequence mismatch on iteration " +
+				                    to_string(iteration));
+		}
+	}
+}
+
+// Packetize a frame and return the RTP payloads
+vector<binary> packetize(const binary &frame, Separator separator) {
+	auto rtpConfig = make_shared<RtpPacketizationConfig>(1, "video", 96, 90000);
+	H264RtpPacketizer packetizer(separator, rtpConfig);
+	message_vector messages = {make_message(frame.begin(), frame.end())};
+	packetizer.outgoing(messages, nullptr);
+
+	const size_t headerSize = sizeof(RtpHeader);
+	vector<binary> payloads;
+	for (const auto &message : messages)
+		payloads.emplace_back(message->begin() + headerSize, message->end());
+
+	return payloads;
+}
+
+} // namespace
+
+void test_startsequence() {
+	test_equivalence();
+
+	binary prefixed, stream;
+	load_samples(stream, &prefixed);
+	if (stream.empty()) {
+		cout << "Samples not found in " << RTC_SAMPLES_DIR << ", skipping sample check" << endl;
+		cout << "Success" << endl;
+		return;
+	}
+
+	// Splitting on start sequences must give back the NAL units
+	auto payloads = packetize(stream, Separator::StartSequence);
+	if (payloads.empty() || payloads != packetize(prefixed, Separator::Length))
+		throw runtime_error("Packetization differs between start sequences and lengths");
+
+	// Scanning the samples must find the same start sequences as the byte-wise reference
+	size_t offset = 0;
+	while (offset < stream.size()) {
+		size_t expectedLength = 0, length = 0;
+		size_t expected = find_bytewise(stream, offset, Separator::StartSequence, expectedLength);
+		size_t found = NalUnit::FindStartSequence(stream.data() + offset, stream.size() - offset,
+		                                          Separator::StartSequence, length);
+		if (found != expected || length != expectedLength)
+			throw runtime_error("Start sequence mismatch on samples");
+
+		offset += found + length;
+	}
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+namespace {
+
+const size_t MaxFragmentSize = 1000;
+
+shared_ptr<RtpPacketizationConfig> make_config() {
+	return make_shared<RtpPacketizationConfig>(1, "video", 96, RtpPacketizer::VideoClockRate);
+}
+
+// Random frame data, where the first byte is a VP9 frame header for a key or inter frame
+binary random_frame(mt19937 &generator, size_t size, bool key) {
+	binary frame(size);
+	for (auto &b : frame)
+		b = byte(generator());
+
+	frame[0] = byte(0x80 | (key ? 0x00 : 0x04)); // frame_marker, profile 0, and frame_type
+	return frame;
+}
+
+// VP9 frame with an uncompressed header in profile 0, where inter frames reference the slots 0,
+// 1, and 2, followed by random data
+binary vp9_frame(mt19937 &generator, size_t size, bool key, bool shown = true,
+                 uint8_t refreshFlags = 0x01) {
+	uint32_t bits = 0;
+	size_t count = 0;
+	auto write = [&](uint32_t value, size_t n) {
+		bits = bits << n | value;
+		count += n;
+	};
+	write(0x2, 2);           // frame_marker
+	write(0, 2);             // profile
+	write(0, 1);             // show_existing_frame
+	write(key ? 0 : 1, 1);   // frame_type
+	write(shown ? 1 : 0, 1); // show_frame
+	write(0, 1);             // error_resilient_mode
+	if (!key) {
+		if (!shown)
+			write(0, 1); // intra_only
+
+		write(0, 2);            // reset_frame_context
+		write(refreshFlags, 8); // refresh_frame_flags
+		for (uint32_t slot = 0; slot < 3; ++slot)
+			write(slot << 1, 4); // ref_frame_idx and ref_frame_sign_bias
+	}
+	bits <<= 32 - count;
+
+	binary frame = random_frame(generator, 4 + size, key);
+	for (size_t i = 0; i < 4; ++i)
+		frame[i] = byte(bits >> (24 - 8 * i) & 0xFF);
+
+	return frame;
+}
+
+// Make a superframe out of frames
+binary make_superframe(const vector<binary> &frames) {
+	binary result;
+	for (const auto &frame : frames)
+		result.insert(result.end(), frame.begin(), frame.end());
+
+	const byte marker = byte(0xC0 | 1 << 3 | (frames.size() - 1)); // 2-byte sizes
+	result.push_back(marker);
+	for (const auto &frame : frames) {
+		result.push_back(byte(frame.size() & 0xFF));
+		result.push_back(byte(frame.size() >> 8));
+	}
+	result.push_back(marker);
+	return result;
+}
+
+// Packetize frames with increasing timestamps
+message_vector packetize(RtpPacketizer &packetizer, const vector<binary> &frames) {
+	message_vector packets;
+	for (size_t i = 0; i < frames.size(); ++i) {
+		packetizer.rtpConfig->timestamp = uint32_t(1 + i * 3000);
+		message_vector messages = {make_message(frames[i].begin(), frames[i].end())};
+		packetizer.outgoing(messages, nullptr);
+		for (const auto &message : messages) {
+			if (message->size() > sizeof(RtpHeader) + MaxFragmentSize)
+				throw runtime_error("RTP packet is larger than the max fragment size");
+
+			packets.push_back(message);
+		}
+	}
+	return packets;
+}
+
+vector<binary> depacketize(MediaHandler &depacketizer, message_vector packets) {
+	depacketizer.incoming(packets, nullptr);
+	vector<binary> frames;
+	for (const auto &message : packets)
+		frames.emplace_back(message->begin(), message->end());
+
+	return frames;
+}
+
+const byte *payload(const message_ptr &packet) {
+	return packet->data() + sizeof(RtpHeader);
+}
+
+void test_vp8() {
+	mt19937 generator(42);
+	vector<binary> frames;
+	for (size_t i = 0; i < 100; ++i)
+		frames.push_back(random_frame(generator, 1 + generator() % (i % 10 == 0 ? 20000 : 2000),
+		                              i % 10 == 0));
+
+	VP8RtpPacketizer packetizer(make_config(), MaxFragmentSize);
+	auto packets = packetize(packetizer, frames);
+
+	// The first packet of a frame has the S bit, and the picture ID increments with frames
+	uint16_t pictureId = 0;
+	for (size_t i = 0; i < packets.size(); ++i) {
+		auto p = payload(packets[i]);
+		const bool first = i == 0 || reinterpret_cast<const RtpHeader *>(packets[i - 1]->data())
+		                                 ->marker();
+		const uint16_t id = uint16_t(uint8_t(p[2]) & 0x7F) << 8 | uint8_t(p[3]);
+		if ((uint8_t(p[0]) & 0x10) != (first ? 0x10 : 0) || (uint8_t(p[1]) & 0x80) == 0)
+			throw runtime_error("Unexpected VP8 payload descriptor");
+
+		if (i > 0 && id != (first ? (pictureId + 1) & 0x7FFF : pictureId))
+			throw runtime_error("Unexpected VP8 picture ID");
+
+		pictureId = id;
+	}
+
+	VP8RtpDepacketizer depacketizer;
+	if (depacketize(depacketizer, packets) != frames)
+		throw runtime_error("VP8 frames differ after round trip");
+
+	// A frame with a lost packet is dropped without waiting, and the next ones are still received
+	VP8RtpDepacketizer lossyDepacketizer(chrono::milliseconds(0));
+	auto lossy = packets;
+	size_t index = 1;
+	while (reinterpret_cast<const RtpHeader *>(lossy[index - 1]->data())->marker())
+		++index;
+	lossy.erase(lossy.begin() + index);
+	auto received = depacketize(lossyDepacketizer, lossy);
+	if (received.size() != frames.size() - 1 || received.back() != frames.back())
+		throw runtime_error("VP8 frame loss is not handled");
+
+	cout << "VP8: " << frames.size() << " frames in " << packets.size() << " packets" << endl;
+}
+
+void test_vp9() {
+	mt19937 generator(42);
+	vector<binary> frames;
+	vector<vector<uint8_t>> references; // expected reference indices
+	size_t lastKey = 0, lastAltRef = 0;
+	for (size_t i = 0; i < 100; ++i) {
+		if (i % 10 == 0) {
+			frames.push_back(vp9_frame(generator, generator() % 8000, true));
+			references.push_back({});
+			lastKey = lastAltRef = i;
+			continue;
+		}
+
+		// Every picture refreshes the slot 0, superframes refresh the slot 2 with a hidden frame
+		vector<uint8_t> expected = {1, uint8_t(i - lastKey), uint8_t(i - lastAltRef)};
+		sort(expected.begin(), expected.end());
+		expected.erase(unique(expected.begin(), expected.end()), expected.end());
+		references.push_back(std::move(expected));
+		if (i % 3 == 0) {
+			auto hidden = vp9_frame(generator, generator() % 3000, false, false, 0x04);
+			auto shown = vp9_frame(generator, generator() % 3000, false);
+			frames.push_back(make_superframe({hidden, shown}));
+			lastAltRef = i;
+		} else {
+			frames.push_back(vp9_frame(generator, generator() % 2000, false));
+		}
+	}
+
+	VP9RtpPacketizer packetizer(make_config(), MaxFragmentSize);
+	auto packets = packetize(packetizer, frames);
+
+	// Check flexible mode descriptors
+	size_t frameIndex = 0;
+	for (const auto &packet : packets) {
+		auto p = payload(packet);
+		const uint8_t flags = uint8_t(p[0]);
+		if ((flags & 0xB0) != 0x90) // I and F without L
+			throw runtime_error("Unexpected VP9 payload descriptor");
+
+		vector<uint8_t> diffs;
+		if (flags & 0x40) // P
+			for (size_t i = 3; diffs.empty() || uint8_t(p[i - 1]) & 0x01; ++i)
+				diffs.push_back(uint8_t(p[i]) >> 1);
+
+		sort(diffs.begin(), diffs.end());
+		if (diffs != references[frameIndex])
+			throw runtime_error("Unexpected VP9 reference indices");
+
+		if (reinterpret_cast<const RtpHeader *>(packet->data())->marker())
+			++frameIndex;
+	}
+	if (frameIndex != frames.size())
+		throw runtime_error("Unexpected VP9 frame count");
+
+	// An inter frame without a key frame before can't signal its references
+	VP9RtpPacketizer otherPacketizer(make_config(), MaxFragmentSize);
+	if (!packetize(otherPacketizer, {vp9_frame(generator, 100, false)}).empty())
+		throw runtime_error("VP9 frame with unknown references not dropped");
+
+	VP9RtpDepacketizer depacketizer;
+	if (depacketize(depacketizer, packets) != frames)
+		throw runtime_error("VP9 frames differ after round trip");
+
+	// Non-flexible mode with TL0PICIDX and a scalability structure is also accepted
+	binary frame = vp9_frame(generator, 500, true);
+	binary descriptor = {byte(0xAE),              // I, L, B, E, V
+	                     byte(0x12),              // 7-bit picture ID
+	                     byte(0x00), byte(0x05),  // layer indices and TL0PICIDX
+	                     byte(0x18),              // N_S = 0, Y, G
+	                     byte(0x01), byte(0x40),  // width
+	                     byte(0x00), byte(0xF0),  // height
+	                     byte(0x01),              // N_G
+	                     byte(0x04), byte(0x01)}; // one reference
+	auto packet = make_message(sizeof(RtpHeader) + descriptor.size() + frame.size());
+	auto rtp = reinterpret_cast<RtpHeader *>(packet->data());
+	rtp->preparePacket();
+	rtp->setMarker(true);
+	rtp->setTimestamp(1);
+	std::copy(descriptor.begin(), descriptor.end(), packet->begin() + sizeof(RtpHeader));
+	std::copy(frame.begin(), frame.end(),
+	          packet->begin() + sizeof(RtpHeader) + descriptor.size());
+	VP9RtpDepacketizer otherDepacketizer;
+	auto received = depacketize(otherDepacketizer, {packet});
+	if (received.size() != 1 || received[0] != frame)
+		throw runtime_error("VP9 non-flexible mode packet not depacketized");
+
+	cout << "VP9: " << frames.size() << " frames in " << packets.size() << " packets" << endl;
+}
+
+} // namespace
+
+void test_vpx() {
+	test_vp8();
+	test_vp9();
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+namespace {
+
+// Opens a storm of client connections and measures accepted-and-upgraded connections per second
+// on the server side
+void measure_accept(uint16_t port, unsigned int acceptThreads, size_t count) {
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = port;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.acceptThreads = acceptThreads;
+	WebSocketServer server(std::move(serverConfig));
+
+	mutex clientsMutex;
+	vector<shared_ptr<WebSocket>> clients;
+	atomic<size_t> upgradedCount = 0;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		incoming->onOpen([&upgradedCount]() { ++upgradedCount; });
+		lock_guard lock(clientsMutex);
+		clients.push_back(std::move(incoming));
+	});
+
+	vector<unique_ptr<WebSocket>> sockets;
+	sockets.reserve(count);
+	const string url = "ws://127.0.0.1:" + to_string(port) + "/";
+	const auto start = steady_clock::now();
+	for (size_t i = 0; i < count; ++i) {
+		sockets.push_back(make_unique<WebSocket>());
+		sockets.back()->open(url);
+	}
+
+	int attempts = 300;
+	while (upgradedCount < count && attempts--)
+		this_thread::sleep_for(10ms);
+
+	const double seconds = duration<double>(steady_clock::now() - start).count();
+	if (upgradedCount < count)
+		throw runtime_error("Only " + to_string(upgradedCount) + " connections upgraded out of " +
+		                    to_string(count));
+
+	cout << count << " connections with " << acceptThreads
+	     << " accept threads: " << size_t(count / seconds) << " upgrades/s" << endl;
+
+	for (auto &ws : sockets)
+		ws->close();
+
+	this_thread::sleep_for(1s);
+	sockets.clear();
+	{
+		lock_guard lock(clientsMutex);
+		clients.clear();
+	}
+	server.stop();
+}
+
+} // namespace
+
+void benchmark_wsaccept() {
+	InitLogger(LogLevel::Warning);
+
+	measure_accept(48085, 1, 500);
+	measure_accept(48086, 4, 500);
+}
+
+#endif
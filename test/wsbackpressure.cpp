@@ -0,0 +1,322 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using chrono::steady_clock;
+
+#ifndef _WIN32
+
+namespace {
+
+using OverflowPolicy = WebSocket::Configuration::OverflowPolicy;
+
+const size_t HighWatermark = 256 * 1024;
+const size_t MessageSize = 16 * 1024;
+
+// Raw peer which completes the WebSocket handshake and then only reads when asked to, so the
+// server send buffers fill up
+class RawPeer {
+public:
+	explicit RawPeer(uint16_t port) {
+		mSock = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (mSock < 0)
+			throw runtime_error("Socket creation failed");
+
+		int bufferSize = 4096;
+		::setsockopt(mSock, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+		struct timeval tv = {0, 100000};
+		::setsockopt(mSock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+		struct sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(port);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (::connect(mSock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+			throw runtime_error("Connection failed");
+
+		const string request = "GET / HTTP/1.1\r\n"
+		                       "Host: 127.0.0.1\r\n"
+		                       "Connection: Upgrade\r\n"
+		                       "Upgrade: websocket\r\n"
+		                       "Sec-WebSocket-Version: 13\r\n"
+		                       "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+		                       "\r\n";
+		if (::send(mSock, request.data(), request.size(), 0) != ptrdiff_t(request.size()))
+			throw runtime_error("Handshake request not sent");
+
+		// Read the response byte by byte so no frame data is consumed
+		string response;
+		char c;
+		while (response.size() < 4 || response.compare(response.size() - 4, 4, "\r\n\r\n") != 0) {
+			if (::recv(mSock, &c, 1, 0) != 1)
+				throw runtime_error("Handshake response not received");
+			response += c;
+		}
+		if (response.compare(0, 12, "HTTP/1.1 101") != 0)
+			throw runtime_error("Handshake failed");
+	}
+
+	~RawPeer() { ::close(mSock); }
+
+	// Read for the given duration and count binary payload bytes and messages
+	void drain(chrono::milliseconds duration) {
+		auto end = steady_clock::now() + duration;
+		char buffer[65536];
+		while (steady_clock::now() < end) {
+			ptrdiff_t len = ::recv(mSock, buffer, sizeof(buffer), 0);
+			if (len <= 0)
+				continue;
+
+			mStream.append(buffer, size_t(len));
+			parseFrames();
+		}
+	}
+
+	size_t payloadBytes() const { return mPayloadBytes; }
+	size_t messages() const { return mMessages; }
+	bool closeReceived() const { return mCloseReceived; }
+
+private:
+	void parseFrames() {
+		size_t pos = 0;
+		while (mStream.size() - pos >= 2) {
+			const uint8_t opcode = uint8_t(mStream[pos]) & 0x0F;
+			size_t length = uint8_t(mStream[pos + 1]) & 0x7F;
+			size_t header = 2;
+			if (length == 126) {
+				if (mStream.size() - pos < 4)
+					break;
+				length = size_t(uint8_t(mStream[pos + 2])) << 8 | uint8_t(mStream[pos + 3]);
+				header = 4;
+			} else if (length == 127) {
+				throw runtime_error("Unexpected frame length");
+			}
+			if (mStream.size() - pos < header + length)
+				break;
+
+			if (opcode == 0x2) {
+				mPayloadBytes += length;
+				++mMessages;
+			} else if (opcode == 0x8) {
+				mCloseReceived = true;
+			}
+			pos += header + length;
+		}
+		mStream.erase(0, pos);
+	}
+
+	int mSock = -1;
+	string mStream;
+	size_t mPayloadBytes = 0;
+	size_t mMessages = 0;
+	bool mCloseReceived = false;
+};
+
+// Start a server with the policy and return the server side of a raw peer connection
+shared_ptr<WebSocket> accept_raw(WebSocketServer &server, unique_ptr<RawPeer> &peer,
+                                 uint16_t port) {
+	mutex clientMutex;
+	shared_ptr<WebSocket> client;
+	atomic<bool> open = false;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		incoming->onOpen([&open]() { open = true; });
+		lock_guard lock(clientMutex);
+		client = std::move(incoming);
+	});
+
+	peer = make_unique<RawPeer>(port);
+
+	int attempts = 100;
+	while (!open && attempts--)
+		this_thread::sleep_for(50ms);
+
+	if (!open)
+		throw runtime_error("Server-side WebSocket not open");
+
+	server.onClient(nullptr);
+	lock_guard lock(clientMutex);
+	client->onOpen(nullptr);
+	return client;
+}
+
+unique_ptr<WebSocketServer> make_server(uint16_t port, OverflowPolicy policy) {
+	WebSocketServer::Configuration config;
+	config.port = port;
+	config.bindAddress = "127.0.0.1";
+	config.sendHighWatermark = HighWatermark;
+	config.overflowPolicy = policy;
+	return make_unique<WebSocketServer>(std::move(config));
+}
+
+void test_drop(uint16_t port, OverflowPolicy policy) {
+	auto server = make_server(port, policy);
+	unique_ptr<RawPeer> peer;
+	auto ws = accept_raw(*server, peer, port);
+
+	const binary message(MessageSize, byte(0x42));
+	const size_t count = 2000;
+	size_t maxBuffered = 0;
+	for (size_t i = 0; i < count; ++i) {
+		ws->send(message);
+		maxBuffered = std::max(maxBuffered, ws->bufferedAmount());
+	}
+
+	const string name = policy == OverflowPolicy::DropNewest ? "drop-newest" : "drop-oldest";
+	if (ws->messagesDropped() == 0)
+		throw runtime_error("No messages dropped with " + name + " policy");
+
+	// A queued message might be over the high watermark once framed
+	if (maxBuffered > HighWatermark + MessageSize)
+		throw runtime_error("Buffered amount exceeded the high watermark with " + name);
+
+	// Everything which was not dropped must be delivered
+	peer->drain(1500ms);
+	const size_t expected = count - ws->messagesDropped();
+	if (peer->messages() != expected || peer->payloadBytes() != ws->bytesSent() ||
+	    ws->bytesSent() + ws->bytesDropped() != count * MessageSize)
+		throw runtime_error("Unexpected delivery with " + name + " policy: " +
+		                    to_string(peer->messages()) + " messages received, " +
+		                    to_string(expected) + " expected");
+
+	if (ws->bufferedAmount() != 0)
+		throw runtime_error("Queued messages not flushed with " + name + " policy");
+
+	cout << "Policy " << name << ": " << ws->messagesDropped() << " messages dropped out of "
+	     << count << endl;
+
+	ws->close();
+	server->stop();
+}
+
+void test_block(uint16_t port) {
+	auto server = make_server(port, OverflowPolicy::Block);
+	unique_ptr<RawPeer> peer;
+	auto ws = accept_raw(*server, peer, port);
+
+	atomic<size_t> lowCount = 0;
+	ws->onBufferedAmountLow([&lowCount]() { ++lowCount; });
+
+	const binary message(MessageSize, byte(0x42));
+	const size_t count = 512; // 8 MiB, more than the socket buffers can hold
+
+	// The peer starts reading after a delay, sending can't complete before so it must block with
+	// the buffered amount over the low watermark, half the high one
+	atomic<size_t> sentCount = 0;
+	atomic<bool> done = false;
+	bool blocked = false;
+	size_t blockedBuffered = 0;
+	thread reader([&]() {
+		this_thread::sleep_for(500ms);
+		blocked = sentCount < count;
+		blockedBuffered = ws->bufferedAmount();
+		while (!done)
+			peer->drain(100ms);
+
+		peer->drain(500ms);
+	});
+
+	size_t maxBuffered = 0;
+	for (size_t i = 0; i < count; ++i) {
+		ws->send(message);
+		++sentCount;
+		maxBuffered = std::max(maxBuffered, ws->bufferedAmount());
+	}
+
+	done = true;
+	reader.join();
+
+	if (!blocked)
+		throw runtime_error("Sending did not block");
+
+	if (blockedBuffered <= HighWatermark / 2)
+		throw runtime_error("Sending blocked under the low watermark");
+
+	if (maxBuffered > HighWatermark + MessageSize)
+		throw runtime_error("Buffered amount exceeded the high watermark with block policy");
+
+	if (ws->messagesDropped() != 0 || peer->messages() != count)
+		throw runtime_error("Messages lost with block policy");
+
+	if (lowCount == 0)
+		throw runtime_error("Buffered amount low callback not called");
+
+	cout << "Policy block: all " << count << " messages delivered, low callback called "
+	     << lowCount << " times" << endl;
+
+	ws->close();
+	server->stop();
+}
+
+void test_close(uint16_t port) {
+	auto server = make_server(port, OverflowPolicy::Close);
+	unique_ptr<RawPeer> peer;
+	auto ws = accept_raw(*server, peer, port);
+
+	// The peer never answers the close frame, so the WebSocket stays closing until the timeout
+	const binary message(MessageSize, byte(0x42));
+	try {
+		for (size_t i = 0; i < 2000 && ws->isOpen(); ++i)
+			ws->send(message);
+	} catch (const exception &) {
+		// Sending after the close fails
+	}
+
+	if (ws->isOpen())
+		throw runtime_error("Connection not closed with close policy");
+
+	peer->drain(1500ms);
+	if (!peer->closeReceived())
+		throw runtime_error("Close frame not received with close policy");
+
+	cout << "Policy close: connection closed on overflow" << endl;
+	server->stop();
+}
+
+} // namespace
+
+void test_wsbackpressure() {
+	InitLogger(LogLevel::Warning);
+
+	test_drop(48091, OverflowPolicy::DropNewest);
+	test_drop(48092, OverflowPolicy::DropOldest);
+	test_block(48093);
+	test_close(48094);
+
+	cout << "Success" << endl;
+}
+
+#else
+
+void test_wsbackpressure() { cout << "Skipped, raw sockets are not supported" << endl; }
+
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+namespace {
+
+// Measures the server-side receive throughput for a storm of small frames over loopback, so that
+// many frames are parsed from each TCP read
+void measure_storm(uint16_t port, size_t messageSize, size_t count) {
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = port;
+	serverConfig.bindAddress = "127.0.0.1";
+	WebSocketServer server(std::move(serverConfig));
+
+	atomic<size_t> receivedCount = 0;
+	atomic<size_t> receivedSize = 0;
+	shared_ptr<WebSocket> client;
+	server.onClient([&client, &receivedCount, &receivedSize](shared_ptr<WebSocket> incoming) {
+		client = incoming;
+		client->onMessage([&receivedCount, &receivedSize](variant<binary, string> message) {
+			receivedSize += holds_alternative<binary>(message) ? get<binary>(message).size()
+			                                                   : get<string>(message).size();
+			++receivedCount;
+		});
+	});
+
+	WebSocket ws;
+	atomic<bool> open = false;
+	ws.onOpen([&open]() { open = true; });
+	ws.open("ws://127.0.0.1:" + to_string(port) + "/");
+
+	int attempts = 50;
+	while (!open && attempts--)
+		this_thread::sleep_for(100ms);
+
+	if (!open)
+		throw runtime_error("WebSocket is not open");
+
+	const binary payload(messageSize, byte(0xAB));
+	const auto start = steady_clock::now();
+	for (size_t i = 0; i < count; ++i)
+		ws.send(payload);
+
+	attempts = 300;
+	while (receivedCount < count && attempts--)
+		this_thread::sleep_for(100ms);
+
+	const double seconds = duration<double>(steady_clock::now() - start).count();
+	if (receivedCount < count || receivedSize != count * messageSize)
+		throw runtime_error("Not all messages received");
+
+	cout << count << " frames of " << messageSize << " bytes: " << size_t(count / seconds)
+	     << " frames/s, " << size_t(count * messageSize / seconds / 1000) << " KB/s" << endl;
+
+	ws.close();
+	server.stop();
+	this_thread::sleep_for(500ms);
+}
+
+} // namespace
+
+void benchmark_websocket() {
+	InitLogger(LogLevel::Warning);
+
+	measure_storm(48081, 8, 200000);
+	measure_storm(48082, 64, 200000);
+	measure_storm(48083, 512, 100000);
+	measure_storm(48088, 64 * 1024, 5000); // header and payload sent as separate segments
+	measure_storm(48089, 200 * 1024, 2000); // bulk transfer with large adaptive reads
+}
+
+#endif
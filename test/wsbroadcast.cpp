@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+void test_wsbroadcast() {
+	InitLogger(LogLevel::Warning);
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48087;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.sendHighWatermark = 4 * 1024 * 1024;
+	serverConfig.overflowPolicy = WebSocketConfiguration::OverflowPolicy::DropNewest;
+	WebSocketServer server(std::move(serverConfig));
+
+	mutex clientsMutex;
+	vector<shared_ptr<WebSocket>> clients;
+	atomic<size_t> openCount = 0;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		incoming->onOpen([&openCount]() { ++openCount; });
+		lock_guard lock(clientsMutex);
+		clients.push_back(std::move(incoming));
+	});
+
+	const size_t clientCount = 50;
+	const size_t messageCount = 200;
+	const string message(512, 'x');
+
+	atomic<size_t> receivedCount = 0;
+	atomic<bool> mismatch = false;
+	vector<unique_ptr<WebSocket>> sockets;
+	for (size_t i = 0; i < clientCount; ++i) {
+		auto ws = make_unique<WebSocket>();
+		ws->onMessage([&](variant<binary, string> received) {
+			if (!holds_alternative<string>(received) || get<string>(received) != message)
+				mismatch = true;
+
+			++receivedCount;
+		});
+		ws->open("ws://127.0.0.1:48087/");
+		sockets.push_back(std::move(ws));
+	}
+
+	int attempts = 100;
+	while (openCount < clientCount && attempts--)
+		this_thread::sleep_for(100ms);
+
+	if (openCount < clientCount)
+		throw runtime_error("Not all clients are open");
+
+	// Messages sent individually and broadcast are received alike
+	vector<shared_ptr<WebSocket>> targets;
+	{
+		lock_guard lock(clientsMutex);
+		targets = clients;
+	}
+
+	for (size_t i = 0; i < messageCount; ++i)
+		for (auto &client : targets)
+			client->send(message);
+
+	for (size_t i = 0; i < messageCount; ++i)
+		if (server.broadcast(targets, message) != clientCount)
+			throw runtime_error("Broadcast did not reach all clients");
+
+	attempts = 100;
+	while (receivedCount < 2 * messageCount * clientCount && attempts--)
+		this_thread::sleep_for(100ms);
+
+	if (receivedCount < 2 * messageCount * clientCount)
+		throw runtime_error("Not all broadcast messages received");
+
+	if (mismatch)
+		throw runtime_error("Broadcast message mismatch");
+
+	// Broadcast messages are counted like individual ones
+	for (auto &client : targets)
+		if (client->bytesSent() != 2 * messageCount * message.size())
+			throw runtime_error("Broadcast messages not counted in bytes sent");
+
+	// The overflow policy of each client applies, no client is skipped under its high watermark
+	if (server.broadcast(targets, message) != clientCount)
+		throw runtime_error("Broadcast dropped for clients under the high watermark");
+
+	for (auto &client : targets)
+		if (client->messagesDropped() != 0)
+			throw runtime_error("Broadcast messages dropped under the high watermark");
+
+	for (auto &ws : sockets)
+		ws->close();
+
+	this_thread::sleep_for(1s);
+	sockets.clear();
+	targets.clear();
+	{
+		lock_guard lock(clientsMutex);
+		clients.clear();
+	}
+	server.stop();
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include "impl/wscodec.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+namespace {
+
+bool is_valid_utf8(const string &str) {
+	return impl::WsValidateUtf8(reinterpret_cast<const byte *>(str.data()), str.size());
+}
+
+} // namespace
+
+void test_wscodec() {
+	mt19937 generator(42);
+	uniform_int_distribution<int> distribution(0, 255);
+	const byte maskingKey[4] = {byte(0x12), byte(0x34), byte(0x56), byte(0x78)};
+
+	// Masking must match the byte-wise definition for all lengths and alignments
+	for (size_t size = 0; size < 256; ++size) {
+		binary data(size + 1);
+		for (auto &b : data)
+			b = byte(distribution(generator));
+
+		binary expected(data);
+		for (size_t i = 0; i < size; ++i)
+			expected[i + 1] ^= maskingKey[i % 4];
+
+		impl::WsMask(data.data() + 1, size, maskingKey);
+		if (data != expected)
+			throw runtime_error("WebSocket masking mismatch for size " + to_string(size));
+	}
+
+	// UTF-8 validation
+	const string ascii(1000, 'a');
+	const string multibyte = ascii + "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80" + ascii;
+	if (!is_valid_utf8("") || !is_valid_utf8(ascii) || !is_valid_utf8(multibyte))
+		throw runtime_error("Valid UTF-8 rejected");
+
+	const string invalid[] = {
+	    "\x80",             // lone continuation byte
+	    "\xC0\xAF",         // overlong encoding
+	    "\xE0\x80\xAF",     // overlong encoding
+	    "\xED\xA0\x80",     // surrogate
+	    "\xF4\x90\x80\x80", // above U+10FFFF
+	    "\xE2\x82",         // truncated sequence
+	    "\xFF",             // invalid byte
+	};
+	for (const auto &str : invalid)
+		if (is_valid_utf8(ascii + str) || is_valid_utf8(ascii + str + ascii))
+			throw runtime_error("Invalid UTF-8 accepted");
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include "impl/wscodec.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+using namespace rtc;
+using namespace std;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+namespace {
+
+// Measures the throughput of a kernel in MB/s over the given frame size
+template <typename F> double measure_throughput(size_t size, F func) {
+	const size_t total = 256 * 1024 * 1024;
+	const size_t iterations = std::max(total / size, size_t(16));
+	const auto start = steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i)
+		func();
+
+	const double seconds = duration<double>(steady_clock::now() - start).count();
+	return double(size * iterations) / seconds / 1e6;
+}
+
+} // namespace
+
+void benchmark_wscodec() {
+	mt19937 generator(42);
+	uniform_int_distribution<int> distribution(0, 255);
+	const byte maskingKey[4] = {byte(0x12), byte(0x34), byte(0x56), byte(0x78)};
+
+	// Masking and UTF-8 validation over 64 B to 1 MiB frames
+	for (size_t size = 64; size <= 1024 * 1024; size *= 4) {
+		binary payload(size);
+		for (auto &b : payload)
+			b = byte(distribution(generator) & 0x7F);
+
+		double maskThroughput = measure_throughput(
+		    size, [&]() { impl::WsMask(payload.data(), payload.size(), maskingKey); });
+
+		// Masking twice restores ASCII data
+		impl::WsMask(payload.data(), payload.size(), maskingKey);
+		double utf8Throughput = measure_throughput(size, [&]() {
+			if (!impl::WsValidateUtf8(payload.data(), payload.size()))
+				throw runtime_error("Valid UTF-8 rejected");
+		});
+
+		cout << "Frame size " << size << " bytes: masking " << size_t(maskThroughput)
+		     << " MB/s, UTF-8 validation " << size_t(utf8Throughput) << " MB/s" << endl;
+	}
+}
+
+#endif
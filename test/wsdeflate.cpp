@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET && RTC_ENABLE_DEFLATE
+
+#include "impl/wsdeflate.hpp"
+#include "impl/wshandshake.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+namespace {
+
+string random_token(mt19937 &generator, size_t length, const string &alphabet) {
+	uniform_int_distribution<size_t> distribution(0, alphabet.size() - 1);
+	string result(length, ' ');
+	for (auto &c : result)
+		c = alphabet[distribution(generator)];
+
+	return result;
+}
+
+// Generates an SDP offer similar to what browsers send over signaling WebSockets
+string make_sdp(mt19937 &generator) {
+	const string alnum = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	const string hex = "0123456789ABCDEF";
+	uniform_int_distribution<int> octet(1, 254);
+	uniform_int_distribution<int> port(10000, 60000);
+	uniform_int_distribution<uint32_t> ssrc;
+
+	ostringstream sdp;
+	sdp << "v=0\r\n"
+	    << "o=- " << ssrc(generator) << ssrc(generator) << " 2 IN IP4 127.0.0.1\r\n"
+	    << "s=-\r\nt=0 0\r\na=group:BUNDLE 0 1 2\r\na=extmap-allow-mixed\r\n"
+	    << "a=msid-semantic: WMS\r\n";
+
+	const string ufrag = random_token(generator, 4, alnum);
+	const string pwd = random_token(generator, 24, alnum);
+	string fingerprint;
+	for (int i = 0; i < 32; ++i)
+		fingerprint += (i ? ":" : "") + random_token(generator, 2, hex);
+
+	const char *media[] = {"audio 9 UDP/TLS/RTP/SAVPF 111 63 9 0 8 13 110 126",
+	                       "video 9 UDP/TLS/RTP/SAVPF 96 97 102 103 104 105 106 107 108 109",
+	                       "application 9 UDP/DTLS/SCTP webrtc-datachannel"};
+	for (int mid = 0; mid < 3; ++mid) {
+		sdp << "m=" << media[mid] << "\r\nc=IN IP4 0.0.0.0\r\n";
+		for (int i = 0; i < 4; ++i)
+			sdp << "a=candidate:" << ssrc(generator) << " 1 udp " << ssrc(generator) << " 192.168."
+			    << octet(generator) << "." << octet(generator) << " " << port(generator)
+			    << " typ host generation 0 network-id " << i + 1 << "\r\n";
+
+		sdp << "a=ice-ufrag:" << ufrag << "\r\na=ice-pwd:" << pwd
+		    << "\r\na=ice-options:trickle\r\na=fingerprint:sha-256 " << fingerprint
+		    << "\r\na=setup:actpass\r\na=mid:" << mid << "\r\n";
+
+		if (mid == 2) {
+			sdp << "a=sctp-port:5000\r\na=max-message-size:262144\r\n";
+			continue;
+		}
+
+		sdp << "a=extmap:1 urn:ietf:params:rtp-hdrext:sdes:mid\r\n"
+		    << "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+		    << "a=extmap:3 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-"
+		       "extensions-01\r\n"
+		    << "a=sendrecv\r\na=msid:- " << random_token(generator, 36, alnum) << "\r\n"
+		    << "a=rtcp-mux\r\na=rtcp-rsize\r\n";
+
+		for (int pt = 96; pt < 110; ++pt)
+			sdp << "a=rtpmap:" << pt << (mid == 0 ? " opus/48000/2" : " H264/90000") << "\r\n"
+			    << "a=rtcp-fb:" << pt << " goog-remb\r\na=rtcp-fb:" << pt << " transport-cc\r\n"
+			    << "a=rtcp-fb:" << pt << " nack\r\na=rtcp-fb:" << pt << " nack pli\r\n"
+			    << "a=fmtp:" << pt
+			    << " level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f\r\n";
+
+		sdp << "a=ssrc-group:FID " << ssrc(generator) << " " << ssrc(generator) << "\r\n";
+	}
+	return sdp.str();
+}
+
+// Measures bytes on the wire and CPU time for a sequence of SDP messages
+void measure_compression(const string &name, const vector<string> &messages, bool contextTakeover,
+                         int windowBits) {
+	impl::WsDeflate::Params params;
+	params.compressWindowBits = params.decompressWindowBits = windowBits;
+	params.compressNoContextTakeover = params.decompressNoContextTakeover = !contextTakeover;
+	impl::WsDeflate sender(params, 1024 * 1024);
+	impl::WsDeflate receiver(params, 1024 * 1024);
+
+	size_t rawSize = 0, compressedSize = 0;
+	duration<double> compressTime{0}, decompressTime{0};
+	for (const auto &message : messages) {
+		auto data = reinterpret_cast<const byte *>(message.data());
+		auto start = steady_clock::now();
+		binary compressed = sender.compress(data, message.size());
+		auto middle = steady_clock::now();
+		auto decompressed = receiver.decompress(compressed.data(), compressed.size());
+		auto end = steady_clock::now();
+
+		if (!decompressed || *decompressed != binary(data, data + message.size()))
+			throw runtime_error("Deflate round trip mismatch");
+
+		rawSize += message.size();
+		compressedSize += compressed.size();
+		compressTime += middle - start;
+		decompressTime += end - middle;
+	}
+
+	const size_t count = messages.size();
+	cout << name << ": " << rawSize / count << " -> " << compressedSize / count
+	     << " bytes per message (" << 100 * compressedSize / rawSize << "%), compress "
+	     << size_t(compressTime.count() * 1e6 / count) << " us, decompress "
+	     << size_t(decompressTime.count() * 1e6 / count) << " us" << endl;
+
+	if (compressedSize >= rawSize)
+		throw runtime_error("Compression is not effective");
+}
+
+// A small message inflating past the max message size must be rejected
+void test_max_size() {
+	impl::WsDeflate::Params params;
+	impl::WsDeflate sender(params, 1024 * 1024);
+	impl::WsDeflate receiver(params, 64 * 1024);
+
+	const binary small(64 * 1024, byte('a'));
+	binary compressed = sender.compress(small.data(), small.size());
+	auto decompressed = receiver.decompress(compressed.data(), compressed.size());
+	if (!decompressed || *decompressed != small)
+		throw runtime_error("Message of the max size rejected");
+
+	const binary large(1024 * 1024, byte('a'));
+	compressed = sender.compress(large.data(), large.size());
+	if (compressed.size() > 16 * 1024)
+		throw runtime_error("Unexpected compressed size");
+
+	if (receiver.decompress(compressed.data(), compressed.size()))
+		throw runtime_error("Decompressed message over the max size accepted");
+}
+
+void test_negotiation() {
+	auto client = make_shared<impl::WsHandshake>("localhost", "/");
+	client->setDeflateOptions({false, 15});
+
+	auto server = make_shared<impl::WsHandshake>();
+	server->setDeflateOptions({true, 10});
+
+	string request = client->generateHttpRequest();
+	if (!server->parseHttpRequest(reinterpret_cast<const byte *>(request.data()), request.size()))
+		throw runtime_error("Failed to parse request");
+
+	string response = server->generateHttpResponse();
+	if (!client->parseHttpResponse(reinterpret_cast<const byte *>(response.data()),
+	                               response.size()))
+		throw runtime_error("Failed to parse response");
+
+	auto clientParams = client->deflateParams();
+	auto serverParams = server->deflateParams();
+	if (!clientParams || !serverParams)
+		throw runtime_error("Deflate was not negotiated");
+
+	// The server limits its own window and disables context takeover on both sides
+	if (clientParams->serverMaxWindowBits != 10 || clientParams->clientMaxWindowBits != 10 ||
+	    !clientParams->serverNoContextTakeover || !clientParams->clientNoContextTakeover)
+		throw runtime_error("Unexpected negotiated deflate parameters");
+
+	// Without an offer, the server must not accept the extension
+	auto plainClient = make_shared<impl::WsHandshake>("localhost", "/");
+	request = plainClient->generateHttpRequest();
+	server->parseHttpRequest(reinterpret_cast<const byte *>(request.data()), request.size());
+	if (server->deflateParams())
+		throw runtime_error("Deflate negotiated without offer");
+}
+
+void test_echo(uint16_t port, const string &payload) {
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = port;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.enableDeflate = true;
+	WebSocketServer server(std::move(serverConfig));
+
+	shared_ptr<WebSocket> client;
+	server.onClient([&client](shared_ptr<WebSocket> incoming) {
+		client = incoming;
+		weak_ptr<WebSocket> wclient = client;
+		client->onMessage([wclient](variant<binary, string> message) {
+			if (auto client = wclient.lock())
+				client->send(std::move(message));
+		});
+	});
+
+	WebSocket::Configuration config;
+	config.enableDeflate = true;
+	config.disableDeflateContextTakeover = true;
+	WebSocket ws(std::move(config));
+
+	atomic<bool> open = false, received = false, mismatch = false;
+	ws.onOpen([&]() {
+		open = true;
+		ws.send(payload);
+		ws.send(payload);
+	});
+	ws.onMessage([&](variant<binary, string> message) {
+		if (!holds_alternative<string>(message) || get<string>(message) != payload)
+			mismatch = true;
+
+		received = true;
+	});
+	ws.open("ws://127.0.0.1:" + to_string(port) + "/");
+
+	int attempts = 50;
+	while ((!open || !received) && attempts--)
+		this_thread::sleep_for(100ms);
+
+	if (!open || !received)
+		throw runtime_error("Compressed echo not received");
+
+	if (mismatch)
+		throw runtime_error("Compressed echo mismatch");
+
+	ws.close();
+	server.stop();
+	this_thread::sleep_for(500ms);
+}
+
+} // namespace
+
+void test_wsdeflate() {
+	InitLogger(LogLevel::Warning);
+
+	test_negotiation();
+	test_max_size();
+
+	mt19937 generator(42);
+	vector<string> messages;
+	for (int i = 0; i < 200; ++i)
+		messages.push_back(make_sdp(generator));
+
+	measure_compression("Context takeover, 15 bits", messages, true, 15);
+	measure_compression("No context takeover, 15 bits", messages, false, 15);
+	measure_compression("Context takeover, 10 bits", messages, true, 10);
+	measure_compression("No context takeover, 10 bits", messages, false, 10);
+
+	cout << "Memory limit 64KiB: " << impl::WsDeflate::WindowBitsForMemoryLimit(64 * 1024)
+	     << " window bits, 256KiB: " << impl::WsDeflate::WindowBitsForMemoryLimit(256 * 1024)
+	     << " window bits" << endl;
+
+	test_echo(48084, messages.front());
+
+	cout << "Success" << endl;
+}
+
+#endif
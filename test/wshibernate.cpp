@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+void test_wshibernate() {
+	InitLogger(LogLevel::Warning);
+
+	const auto hibernationTimeout = 200ms;
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48090;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.hibernationTimeout = hibernationTimeout;
+	WebSocketServer server(std::move(serverConfig));
+
+	// The server echoes messages
+	mutex clientMutex;
+	shared_ptr<WebSocket> client;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		weak_ptr<WebSocket> wincoming = incoming;
+		incoming->onMessage([wincoming](variant<binary, string> message) {
+			if (auto incoming = wincoming.lock())
+				incoming->send(std::move(message));
+		});
+		lock_guard lock(clientMutex);
+		client = std::move(incoming);
+	});
+
+	WebSocket::Configuration config;
+	config.pingInterval = 0ms; // the read timeout is the hibernation timeout
+	config.hibernationTimeout = hibernationTimeout;
+	WebSocket ws(std::move(config));
+
+	mutex receivedMutex;
+	string received;
+	ws.onMessage([&](variant<binary, string> message) {
+		if (holds_alternative<string>(message)) {
+			lock_guard lock(receivedMutex);
+			received = std::move(get<string>(message));
+		}
+	});
+
+	// Send a message and wait for it to be echoed
+	auto exchange = [&](const string &message) {
+		{
+			lock_guard lock(receivedMutex);
+			received.clear();
+		}
+		ws.send(message);
+		int attempts = 100;
+		while (attempts--) {
+			{
+				lock_guard lock(receivedMutex);
+				if (received == message)
+					return true;
+			}
+			this_thread::sleep_for(20ms);
+		}
+		return false;
+	};
+
+	ws.open("ws://127.0.0.1:48090/");
+
+	int attempts = 100;
+	while (!ws.isOpen() && attempts--)
+		this_thread::sleep_for(20ms);
+
+	if (!ws.isOpen())
+		throw runtime_error("WebSocket is not open");
+
+	// Buffers are allocated before hibernation
+	if (!exchange(string(4096, 'a')))
+		throw runtime_error("Message not echoed");
+
+	// Each round lets the client hibernate, then wakes it up with a message in both directions
+	for (int i = 0; i < 2; ++i) {
+		this_thread::sleep_for(3 * hibernationTimeout);
+
+		if (!ws.isOpen())
+			throw runtime_error("WebSocket closed while hibernating");
+
+		if (!exchange(string(4096 + i, char('b' + i))))
+			throw runtime_error("Message not echoed after hibernation");
+	}
+
+	ws.close();
+
+	attempts = 100;
+	while (!ws.isClosed() && attempts--)
+		this_thread::sleep_for(20ms);
+
+	{
+		lock_guard lock(clientMutex);
+		client.reset();
+	}
+	server.stop();
+
+	cout << "Success" << endl;
+}
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include "impl/http.hpp"
+#include "impl/wshandshake.hpp"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+using impl::HttpParser;
+
+namespace {
+
+const string Request = "GET /signaling?room=42 HTTP/1.1\r\n"
+                       "Host: example.com:8080\r\n"
+                       "Connection: Upgrade\r\n"
+                       "Pragma: no-cache\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36\r\n"
+                       "Upgrade: websocket\r\n"
+                       "Origin: https://example.com\r\n"
+                       "Sec-WebSocket-Version: 13\r\n"
+                       "Accept-Encoding: gzip, deflate, br\r\n"
+                       "Accept-Language: en-US,en;q=0.9\r\n"
+                       "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                       "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+                       "\r\n";
+
+const size_t MaxSize = 16 * 1024;
+
+HttpParser::Status parse(HttpParser &parser, const string &str) {
+	return parser.parse(reinterpret_cast<const byte *>(str.data()), str.size());
+}
+
+// Feeds growing prefixes of the message to a single parser, as a connection would
+HttpParser::Status parse_chunked(HttpParser &parser, const string &str, mt19937 &generator) {
+	uniform_int_distribution<size_t> chunk(1, 64);
+	size_t size = 0;
+	while (true) {
+		size = std::min(size + chunk(generator), str.size());
+		auto status = parser.parse(reinterpret_cast<const byte *>(str.data()), size);
+		if (status != HttpParser::Status::Incomplete || size == str.size())
+			return status;
+	}
+}
+
+void test_valid() {
+	HttpParser parser(HttpParser::Type::Request, MaxSize);
+	const string withFrame = Request + "\x81\x85";
+	if (parse(parser, withFrame) != HttpParser::Status::Complete ||
+	    parser.length() != Request.size())
+		throw runtime_error("Valid request not parsed");
+
+	if (parser.method() != "GET" || parser.target() != "/signaling?room=42" ||
+	    parser.header("HOST") != "example.com:8080" || parser.header("upgrade") != "websocket" ||
+	    parser.header("user-agent") != "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36" ||
+	    parser.header("missing") || parser.headerCount() != 12)
+		throw runtime_error("Unexpected parsed request fields");
+
+	// Every prefix must be incomplete, not rejected
+	HttpParser incremental(HttpParser::Type::Request, MaxSize);
+	for (size_t size = 1; size < Request.size(); ++size)
+		if (incremental.parse(reinterpret_cast<const byte *>(Request.data()), size) !=
+		    HttpParser::Status::Incomplete)
+			throw runtime_error("Request prefix of size " + to_string(size) + " not incomplete");
+
+	if (parse(incremental, Request) != HttpParser::Status::Complete ||
+	    incremental.header("sec-websocket-key") != "dGhlIHNhbXBsZSBub25jZQ==")
+		throw runtime_error("Incremental request parsing failed");
+
+	// A client handshake must be accepted by a server handshake and conversely
+	impl::WsHandshake client("example.com", "/chat", {"chat"});
+	impl::WsHandshake server;
+	string request = client.generateHttpRequest();
+	if (server.parseHttpRequest(reinterpret_cast<const byte *>(request.data()), request.size()) !=
+	        request.size() ||
+	    server.host() != "example.com" || server.path() != "/chat" ||
+	    server.protocols() != vector<string>{"chat"})
+		throw runtime_error("WebSocket request not accepted");
+
+	string response = server.generateHttpResponse();
+	if (client.parseHttpResponse(reinterpret_cast<const byte *>(response.data()),
+	                             response.size()) != response.size())
+		throw runtime_error("WebSocket response not accepted");
+}
+
+void test_reject() {
+	auto expect = [](HttpParser::Type type, const string &str, HttpParser::Status expected,
+	                 const string &name) {
+		HttpParser parser(type, 1024);
+		if (parse(parser, str) != expected)
+			throw runtime_error("Unexpected parsing status for " + name);
+	};
+
+	using Status = HttpParser::Status;
+	const auto request = HttpParser::Type::Request;
+	const auto response = HttpParser::Type::Response;
+
+	// Rejected before the end of the head is received
+	expect(request, "\x16\x03\x01\x02\x00\x01", Status::Invalid, "TLS record");
+	expect(request, "GET / HTTP/1.1\r\nBad Header\r\n", Status::Invalid, "header without colon");
+	expect(request, "GET / HTTP/1.1\r\nHost: a\r\n folded\r\n", Status::Invalid, "folded header");
+	expect(request, "GET / HTTP/1.1\r\nHo st: a\r\n", Status::Invalid, "space in header name");
+	expect(request, "GET / HTTP/1.1\r\nHost: a\x01\r\n", Status::Invalid, "control in value");
+	expect(request, "GET / HTTP/2.0\r\n", Status::Invalid, "HTTP/2 version");
+	expect(request, "GET  HTTP/1.1\r\n", Status::Invalid, "empty target");
+	expect(request, "GET /\r\n", Status::Invalid, "missing version");
+	expect(request, "\r\n\r\n", Status::Invalid, "empty request line");
+	expect(response, "SSH-2.0-OpenSSH", Status::Invalid, "non-HTTP response");
+	expect(response, "HTTP/1.1 1O1 Switching\r\n", Status::Invalid, "invalid status code");
+
+	// Oversized heads are rejected as soon as the limit is reached
+	expect(request, "GET / HTTP/1.1\r\nX: " + string(2048, 'a'), Status::TooLarge, "long header");
+	string many = "GET / HTTP/1.1\r\n";
+	for (size_t i = 0; i <= HttpParser::MaxHeaders; ++i)
+		many += "X:\r\n";
+	expect(request, many, Status::TooLarge, "too many headers");
+
+	// Tolerated forms
+	expect(request, "GET / HTTP/1.1\nHost: a\n\n", Status::Complete, "bare LF");
+	expect(request, "GET / HTTP/1.1\r\nHost:a \t\r\nX:\r\n\r\n", Status::Complete, "whitespace");
+	expect(response, "HTTP/1.1 101\r\n\r\n", Status::Complete, "no reason phrase");
+
+	HttpParser parser(request, 1024);
+	parse(parser, "GET / HTTP/1.1\r\nHost:a \t\r\n\r\n");
+	if (parser.header("host") != "a")
+		throw runtime_error("Header value whitespace not trimmed");
+
+	impl::WsHandshake server;
+	const string oversized = "GET / HTTP/1.1\r\nX: " + string(32 * 1024, 'a');
+	try {
+		server.parseHttpRequest(reinterpret_cast<const byte *>(oversized.data()), oversized.size());
+		throw runtime_error("Oversized WebSocket request not rejected");
+	} catch (const impl::WsHandshake::RequestError &e) {
+		if (e.responseCode() != 431)
+			throw runtime_error("Unexpected response code for oversized WebSocket request");
+	}
+}
+
+// Mutates a valid request randomly, then checks the parser is consistent and memory-safe, and
+// incremental parsing agrees with parsing at once
+void test_fuzz(size_t iterations) {
+	mt19937 generator(42);
+	uniform_int_distribution<int> byteDistribution(0, 255);
+	uniform_int_distribution<int> operation(0, 5);
+	const string alphabet = ":\r\n \t/aZ";
+
+	size_t completeCount = 0;
+	for (size_t i = 0; i < iterations; ++i) {
+		string str = Request;
+		uniform_int_distribution<int> mutations(1, 4);
+		for (int m = mutations(generator); m > 0; --m) {
+			uniform_int_distribution<size_t> position(0, str.size() - 1);
+			size_t pos = position(generator);
+			switch (operation(generator)) {
+			case 0:
+				str[pos] = char(byteDistribution(generator));
+				break;
+			case 1:
+				str[pos] = alphabet[size_t(byteDistribution(generator)) % alphabet.size()];
+				break;
+			case 2:
+				str.insert(pos, 1, alphabet[size_t(byteDistribution(generator)) % alphabet.size()]);
+				break;
+			case 3:
+				str.erase(pos, 1);
+				break;
+			case 4:
+				str.resize(pos + 1);
+				break;
+			default:
+				str.insert(pos, str.substr(position(generator) % str.size(), 64));
+				break;
+			}
+			if (str.empty())
+				str = "G";
+		}
+
+		HttpParser once(HttpParser::Type::Request, MaxSize);
+		HttpParser chunked(HttpParser::Type::Request, MaxSize);
+		auto status = parse(once, str);
+		if (parse_chunked(chunked, str, generator) != status || once.length() != chunked.length())
+			throw runtime_error("Chunked parsing disagrees on input " + to_string(i));
+
+		if (status != HttpParser::Status::Complete)
+			continue;
+
+		++completeCount;
+		if (once.length() > str.size())
+			throw runtime_error("Parsed length beyond input on input " + to_string(i));
+
+		const char *begin = str.data(), *end = str.data() + once.length();
+		for (size_t h = 0; h < once.headerCount(); ++h) {
+			auto name = once.headerName(h), value = once.headerValue(h);
+			if (name.empty() || name.data() < begin || name.data() + name.size() > end ||
+			    value.data() < begin || value.data() + value.size() > end)
+				throw runtime_error("Header outside of input on input " + to_string(i));
+		}
+
+		// The handshake must only fail with handshake errors
+		impl::WsHandshake server;
+		try {
+			server.parseHttpRequest(reinterpret_cast<const byte *>(str.data()), str.size());
+		} catch (const impl::WsHandshake::Error &) {
+		}
+	}
+
+	cout << "Fuzzed " << iterations << " requests, " << completeCount << " complete" << endl;
+}
+
+} // namespace
+
+void test_wshttp() {
+	InitLogger(LogLevel::Warning);
+
+	test_valid();
+	test_reject();
+	test_fuzz(200000);
+
+	cout << "Success" << endl;
+}
+
+#endif
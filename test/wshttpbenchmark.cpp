@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include "impl/http.hpp"
+#include "impl/wshandshake.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+
+using namespace rtc;
+using namespace std;
+
+using chrono::duration;
+using chrono::steady_clock;
+
+using impl::HttpParser;
+
+namespace {
+
+const string Request = "GET /signaling?room=42 HTTP/1.1\r\n"
+                       "Host: example.com:8080\r\n"
+                       "Connection: Upgrade\r\n"
+                       "Pragma: no-cache\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36\r\n"
+                       "Upgrade: websocket\r\n"
+                       "Origin: https://example.com\r\n"
+                       "Sec-WebSocket-Version: 13\r\n"
+                       "Accept-Encoding: gzip, deflate, br\r\n"
+                       "Accept-Language: en-US,en;q=0.9\r\n"
+                       "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                       "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+                       "\r\n";
+
+const size_t MaxSize = 16 * 1024;
+
+} // namespace
+
+// Measures the parsing cost per request against the line-based parser
+void benchmark_wshttp() {
+	InitLogger(LogLevel::Warning);
+
+	const size_t count = 200000;
+	const auto data = reinterpret_cast<const byte *>(Request.data());
+
+	auto start = steady_clock::now();
+	size_t total = 0;
+	for (size_t i = 0; i < count; ++i) {
+		list<string> lines;
+		total += impl::parseHttpLines(data, Request.size(), lines);
+		total += impl::parseHttpHeaders(lines).size();
+	}
+	const double linesSeconds = duration<double>(steady_clock::now() - start).count();
+
+	start = steady_clock::now();
+	HttpParser parser(HttpParser::Type::Request, MaxSize);
+	for (size_t i = 0; i < count; ++i) {
+		parser.parse(data, Request.size());
+		total += parser.length() + parser.headerCount();
+	}
+	const double parserSeconds = duration<double>(steady_clock::now() - start).count();
+
+	start = steady_clock::now();
+	impl::WsHandshake server;
+	for (size_t i = 0; i < count; ++i)
+		total += server.parseHttpRequest(data, Request.size());
+
+	const double handshakeSeconds = duration<double>(steady_clock::now() - start).count();
+
+	if (total == 0)
+		throw runtime_error("Nothing parsed");
+
+	cout << "Line-based parsing: " << size_t(linesSeconds * 1e9 / count)
+	     << " ns per request, incremental parsing: " << size_t(parserSeconds * 1e9 / count)
+	     << " ns per request, WebSocket request handling: "
+	     << size_t(handshakeSeconds * 1e9 / count) << " ns per request" << endl;
+}
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+// Return the resident set size in bytes, or 0 if unknown
+size_t resident_size() {
+#ifdef __GLIBC__
+	malloc_trim(0); // return freed memory to the system so it is visible
+#endif
+#ifdef __linux__
+	ifstream statm("/proc/self/statm");
+	size_t size = 0, resident = 0;
+	if (statm >> size >> resident)
+		return resident * size_t(sysconf(_SC_PAGESIZE));
+#endif
+	return 0;
+}
+
+// Each connection uses two descriptors in the process, one on each side
+size_t max_connections(size_t wanted) {
+#ifndef _WIN32
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+		getrlimit(RLIMIT_NOFILE, &limit);
+		const size_t available = limit.rlim_cur > 256 ? (size_t(limit.rlim_cur) - 256) / 2 : 0;
+		return std::min(wanted, available);
+	}
+#endif
+	return wanted;
+}
+
+} // namespace
+
+void benchmark_wsidle() {
+	InitLogger(LogLevel::Warning);
+
+	const size_t count = max_connections(20000);
+	if (count == 0)
+		throw runtime_error("Not enough file descriptors available");
+
+	const size_t batchSize = 500;
+	const auto hibernationTimeout = 1s;
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48090;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.hibernationTimeout = hibernationTimeout;
+	WebSocketServer server(std::move(serverConfig));
+
+	mutex clientsMutex;
+	vector<shared_ptr<WebSocket>> clients;
+	atomic<size_t> receivedCount = 0;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		incoming->onMessage([&receivedCount](variant<binary, string>) { ++receivedCount; });
+		lock_guard lock(clientsMutex);
+		clients.push_back(std::move(incoming));
+	});
+
+	const size_t baseline = resident_size();
+
+	WebSocket::Configuration config;
+	config.pingInterval = 0ms; // idleness is only checked for hibernation
+	config.hibernationTimeout = hibernationTimeout;
+
+	// Open connections in batches and send a message on each so that buffers are allocated
+	atomic<size_t> openCount = 0;
+	vector<unique_ptr<WebSocket>> sockets;
+	sockets.reserve(count);
+	const string message(4096, 'x');
+	while (sockets.size() < count) {
+		const size_t target = std::min(sockets.size() + batchSize, count);
+		while (sockets.size() < target) {
+			auto ws = make_unique<WebSocket>(config);
+			auto raw = ws.get();
+			ws->onOpen([raw, &openCount, &message]() {
+				++openCount;
+				raw->send(message);
+			});
+			ws->open("ws://127.0.0.1:48090/");
+			sockets.push_back(std::move(ws));
+		}
+
+		int attempts = 200;
+		while ((openCount < target || receivedCount < target) && attempts--)
+			this_thread::sleep_for(50ms);
+
+		if (openCount < target || receivedCount < target)
+			throw runtime_error("Only " + to_string(openCount) + " connections opened out of " +
+			                    to_string(target));
+	}
+
+	this_thread::sleep_for(200ms);
+	const size_t active = resident_size();
+
+	// Idleness is checked after the timeout on clients, and at the ping interval on the server
+	this_thread::sleep_for(12s);
+	const size_t idle = resident_size();
+
+	if (baseline && active && idle) {
+		auto perConnection = [&](size_t rss) {
+			return rss > baseline ? (rss - baseline) / count : 0;
+		};
+		cout << count << " idle connections, each with client and server in this process: "
+		     << perConnection(active) << " bytes per connection before hibernation, "
+		     << perConnection(idle) << " bytes per connection after hibernation" << endl;
+	} else {
+		cout << "Resident set size is not available on this platform" << endl;
+	}
+
+	// Hibernated connections must wake up on the next message
+	const size_t expected = receivedCount + std::min(count, size_t(100));
+	for (size_t i = 0; i < std::min(count, size_t(100)); ++i)
+		sockets[i]->send(message);
+
+	int attempts = 100;
+	while (receivedCount < expected && attempts--)
+		this_thread::sleep_for(50ms);
+
+	if (receivedCount < expected)
+		throw runtime_error("Messages not received after hibernation");
+
+	for (auto &ws : sockets)
+		ws->close();
+
+	this_thread::sleep_for(2s);
+	sockets.clear();
+	{
+		lock_guard lock(clientsMutex);
+		clients.clear();
+	}
+	server.stop();
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+template <class T> weak_ptr<T> make_weak_ptr(shared_ptr<T> ptr) { return ptr; }
+
+template <class F> bool wait_until(F &&condition, chrono::milliseconds timeout = 10s) {
+	auto end = chrono::steady_clock::now() + timeout;
+	while (!condition() && chrono::steady_clock::now() < end)
+		this_thread::sleep_for(10ms);
+
+	return condition();
+}
+
+// Exchange messages over WSS with kernel TLS requested on both sides, then close from the client
+// or the server. Without kernel support, both sides fall back to user space TLS.
+void test_exchange(uint16_t port, bool serverCloses) {
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = port;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.enableTls = true;
+	serverConfig.enableKernelTls = true;
+	WebSocketServer server(std::move(serverConfig));
+
+	mutex clientMutex;
+	shared_ptr<WebSocket> client;
+	atomic<bool> clientClosed = false;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		incoming->onMessage([wclient = make_weak_ptr(incoming)](variant<binary, string> message) {
+			if (auto client = wclient.lock())
+				client->send(std::move(message));
+		});
+		incoming->onClosed([&clientClosed]() { clientClosed = true; });
+		lock_guard lock(clientMutex);
+		client = std::move(incoming);
+	});
+
+	WebSocket::Configuration config;
+	config.disableTlsVerification = true;
+	config.enableKernelTls = true;
+	WebSocket ws(std::move(config));
+
+	// Sizes span several TLS records
+	const size_t messageCount = 20;
+	auto make_payload = [](size_t i) { return string(1 + i * 4096, char('a' + i % 26)); };
+
+	atomic<size_t> receivedCount = 0;
+	atomic<bool> mismatch = false;
+	ws.onMessage([&](variant<binary, string> message) {
+		size_t i = receivedCount++;
+		if (i % 2 == 0) {
+			if (!holds_alternative<string>(message) || get<string>(message) != make_payload(i))
+				mismatch = true;
+		} else {
+			auto expected = make_payload(i);
+			auto bin = holds_alternative<binary>(message) ? get<binary>(message) : binary();
+			if (bin.size() != expected.size() || bin.back() != byte(expected.back()))
+				mismatch = true;
+		}
+	});
+
+	atomic<bool> closed = false;
+	ws.onClosed([&closed]() { closed = true; });
+
+	ws.open("wss://127.0.0.1:" + to_string(port) + "/");
+	if (!wait_until([&ws]() { return ws.isOpen(); }))
+		throw runtime_error("WebSocket is not open");
+
+	for (size_t i = 0; i < messageCount; ++i) {
+		auto payload = make_payload(i);
+		if (i % 2 == 0)
+			ws.send(std::move(payload));
+		else
+			ws.send(reinterpret_cast<const byte *>(payload.data()), payload.size());
+	}
+
+	if (!wait_until([&]() { return receivedCount == messageCount; }))
+		throw runtime_error("Echoed messages not received");
+
+	if (mismatch)
+		throw runtime_error("Echoed messages do not match");
+
+	if (serverCloses) {
+		lock_guard lock(clientMutex);
+		client->close();
+	} else {
+		ws.close();
+	}
+
+	// The closing handshake must complete on both sides
+	if (!wait_until([&]() { return closed && clientClosed; }))
+		throw runtime_error("WebSocket not closed cleanly");
+
+	{
+		lock_guard lock(clientMutex);
+		client.reset();
+	}
+	server.stop();
+}
+
+} // namespace
+
+void test_wsktls() {
+	InitLogger(LogLevel::Warning);
+
+	test_exchange(48095, false);
+	test_exchange(48096, true);
+
+	cout << "Success" << endl;
+}
+
+#endif
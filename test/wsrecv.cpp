@@ -0,0 +1,221 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#ifndef _WIN32
+
+#include "impl/init.hpp"
+#include "impl/tcptransport.hpp"
+#include "impl/wshandshake.hpp"
+#include "impl/wstransport.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace rtc;
+using namespace std;
+
+namespace {
+
+// Returns a connected pair of loopback TCP sockets
+pair<int, int> make_socket_pair() {
+	int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addrlen = sizeof(addr);
+	if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr *>(&addr), addrlen) < 0 ||
+	    ::listen(listener, 1) < 0 ||
+	    ::getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &addrlen) < 0)
+		throw runtime_error("Failed to create TCP listener");
+
+	int client = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (client < 0 || ::connect(client, reinterpret_cast<sockaddr *>(&addr), addrlen) < 0)
+		throw runtime_error("Failed to connect TCP socket");
+
+	int server = ::accept(listener, nullptr, nullptr);
+	::close(listener);
+	if (server < 0)
+		throw runtime_error("Failed to accept TCP socket");
+
+	return {client, server};
+}
+
+// Appends a masked client frame with a payload shorter than 126 bytes
+void append_frame(binary &out, uint8_t opcode, const string &payload, bool fin = true,
+                  bool compressed = false) {
+	const byte maskingKey[4] = {byte(0x12), byte(0x34), byte(0x56), byte(0x78)};
+	out.push_back(byte(opcode | (fin ? 0x80 : 0) | (compressed ? 0x40 : 0)));
+	out.push_back(byte(0x80 | payload.size()));
+	out.insert(out.end(), maskingKey, maskingKey + 4);
+	for (size_t i = 0; i < payload.size(); ++i)
+		out.push_back(byte(payload[i]) ^ maskingKey[i % 4]);
+}
+
+bool has_content(const message_ptr &message, const string &expected) {
+	return message && message->type == Message::Binary &&
+	       string(reinterpret_cast<const char *>(message->data()), message->size()) == expected;
+}
+
+// Server-side WebSocket transport on a TCP connection, fed directly with incoming data
+class Server {
+public:
+	Server(WebSocketConfiguration config, const string &request) {
+		auto [client, server] = make_socket_pair();
+		mClient = client;
+
+		auto noop = [](impl::Transport::State) {};
+		mTcp = make_shared<impl::TcpTransport>(server, noop);
+		mTcp->start();
+
+		mWs = make_shared<impl::WsTransport>(
+		    mTcp, make_shared<impl::WsHandshake>(), config,
+		    [this](message_ptr message) { received.push_back(std::move(message)); }, noop);
+		mWs->start();
+
+		incoming(binary(reinterpret_cast<const byte *>(request.data()),
+		                reinterpret_cast<const byte *>(request.data()) + request.size()));
+
+		if (mWs->state() != impl::Transport::State::Connected)
+			throw runtime_error("WebSocket handshake failed");
+	}
+
+	~Server() {
+		mWs->stop();
+		mWs.reset();
+		mTcp.reset();
+		::close(mClient);
+	}
+
+	// Pass data to the transport as if it had been read from TCP
+	message_ptr incoming(binary data) {
+		auto message = make_message(std::move(data));
+		mWs->incoming(message);
+		return message;
+	}
+
+	// Read what the transport has sent on the connection
+	binary sent() {
+		binary result;
+		char buffer[1024];
+		pollfd pfd = {mClient, POLLIN, 0};
+		while (::poll(&pfd, 1, 500) > 0) {
+			auto len = ::recv(mClient, buffer, sizeof(buffer), 0);
+			if (len <= 0)
+				break;
+
+			auto data = reinterpret_cast<const byte *>(buffer);
+			result.insert(result.end(), data, data + len);
+		}
+		return result;
+	}
+
+	vector<message_ptr> received;
+
+private:
+	int mClient;
+	shared_ptr<impl::TcpTransport> mTcp;
+	shared_ptr<impl::WsTransport> mWs;
+};
+
+#if RTC_ENABLE_DEFLATE
+// Compressed fragments over the max message size must fail the connection with 1009 before
+// anything is inflated
+void test_compressed_limit() {
+	WebSocketConfiguration config;
+	config.enableDeflate = true;
+	config.maxMessageSize = 64;
+	impl::WsHandshake clientHandshake("127.0.0.1");
+	clientHandshake.setDeflateOptions({false, 15});
+	Server server(config, clientHandshake.generateHttpRequest());
+
+	binary fragment1, fragment2;
+	append_frame(fragment1, 0x2, string(40, 'a'), false, true);
+	append_frame(fragment2, 0x0, string(40, 'b'));
+	server.incoming(std::move(fragment1));
+	server.incoming(std::move(fragment2));
+	if (!server.received.empty())
+		throw runtime_error("Compressed message over the max size received");
+
+	// The close frame carries the status code 1009
+	const binary closeFrame = {byte(0x88), byte(0x02), byte(0x03), byte(0xF1)};
+	const binary sent = server.sent();
+	if (std::search(sent.begin(), sent.end(), closeFrame.begin(), closeFrame.end()) == sent.end())
+		throw runtime_error("Connection not closed with 1009");
+}
+#endif
+
+} // namespace
+
+void test_wsrecv() {
+	InitLogger(LogLevel::Warning);
+	auto token = impl::Init::Instance().token();
+
+	Server server(WebSocketConfiguration(), impl::WsHandshake("127.0.0.1").generateHttpRequest());
+	auto &received = server.received;
+	auto incoming = [&server](binary data) { return server.incoming(std::move(data)); };
+
+	// A frame spanning the whole incoming message is passed up without copy
+	binary single;
+	append_frame(single, 0x2, "single");
+	auto singleMessage = incoming(std::move(single));
+	if (received.size() != 1 || !has_content(received[0], "single"))
+		throw runtime_error("Single frame not received");
+
+	if (received[0] != singleMessage)
+		throw runtime_error("Single frame payload was copied");
+
+	// With several frames in the message, only the last one takes it over
+	binary several;
+	append_frame(several, 0x2, "first");
+	append_frame(several, 0x2, "second");
+	auto severalMessage = incoming(std::move(several));
+	if (received.size() != 3 || !has_content(received[1], "first") ||
+	    !has_content(received[2], "second"))
+		throw runtime_error("Multiple frames not received");
+
+	if (received[1] == severalMessage || received[2] != severalMessage)
+		throw runtime_error("Unexpected message reuse with multiple frames");
+
+	// Fragments are assembled and the assembled buffer is passed up
+	binary fragment1, fragment2;
+	append_frame(fragment1, 0x2, "frag", false);
+	append_frame(fragment2, 0x0, "mented");
+	incoming(std::move(fragment1));
+	incoming(std::move(fragment2));
+	if (received.size() != 4 || !has_content(received[3], "fragmented"))
+		throw runtime_error("Fragmented message not received");
+
+#if RTC_ENABLE_DEFLATE
+	test_compressed_limit();
+#endif
+
+	cout << "Success" << endl;
+}
+
+#else
+
+#include <iostream>
+
+void test_wsrecv() { std::cout << "Skipped, the test requires POSIX sockets" << std::endl; }
+
+#endif
+
+#endif